@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2024 Chiradip Mandal
+ * Author: Chiradip Mandal
+ * Organization: Space-RF.org
+ *
+ * This file is part of DB25 SQL Tokenizer.
+ *
+ * Licensed under the MIT License. See LICENSE file for details.
+ */
+
+#pragma once
+
+// ============================================================================
+// Allocation accounting for benchmarks
+// ============================================================================
+// Replaces the global operator new/delete with versions that count, per
+// thread, allocations, bytes allocated and live bytes (with their peak).
+// Each block carries a small header recording its size, so frees are
+// accounted exactly without relying on sized delete or malloc_usable_size.
+// AllocationScope reports what happened on the calling thread between its
+// construction and result(), e.g. around one tokenize() call.
+//
+// The replacement functions are defined here, so include this header in
+// exactly one translation unit of a program.
+// ============================================================================
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+namespace db25::bench {
+
+struct AllocationStats {
+    uint64_t allocations = 0;
+    uint64_t frees = 0;
+    uint64_t bytes = 0;       // Requested bytes allocated
+    uint64_t peak_bytes = 0;  // Highest live bytes above the starting level
+};
+
+namespace detail {
+
+struct AllocationCounters {
+    uint64_t allocations = 0;
+    uint64_t frees = 0;
+    uint64_t bytes = 0;
+    int64_t live = 0;       // May go negative if memory moves between threads
+    int64_t peak = 0;
+};
+
+inline thread_local AllocationCounters allocation_counters;
+
+// Header in front of every block; keeps the payload max-aligned
+struct alignas(std::max_align_t) BlockHeader {
+    size_t size;
+    size_t offset;  // From the start of the underlying allocation
+};
+
+inline void* counted_allocate(size_t size, size_t alignment) noexcept {
+    alignment = std::max(alignment, alignof(BlockHeader));
+    size_t offset = (sizeof(BlockHeader) + alignment - 1) / alignment * alignment;
+    size_t total = (offset + size + alignment - 1) / alignment * alignment;
+    void* raw = alignment <= alignof(std::max_align_t) ? std::malloc(total)
+                                                       : std::aligned_alloc(alignment, total);
+    if (raw == nullptr) {
+        return nullptr;
+    }
+    auto* payload = static_cast<std::byte*>(raw) + offset;
+    auto* header = reinterpret_cast<BlockHeader*>(payload) - 1;
+    header->size = size;
+    header->offset = offset;
+
+    AllocationCounters& c = allocation_counters;
+    ++c.allocations;
+    c.bytes += size;
+    c.live += static_cast<int64_t>(size);
+    c.peak = std::max(c.peak, c.live);
+    return payload;
+}
+
+inline void counted_free(void* pointer) noexcept {
+    if (pointer == nullptr) {
+        return;
+    }
+    auto* header = static_cast<BlockHeader*>(pointer) - 1;
+    AllocationCounters& c = allocation_counters;
+    ++c.frees;
+    c.live -= static_cast<int64_t>(header->size);
+    std::free(static_cast<std::byte*>(pointer) - header->offset);
+}
+
+inline void* counted_new(size_t size, size_t alignment) {
+    if (void* pointer = counted_allocate(size, alignment)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+}  // namespace detail
+
+// Allocation activity of the calling thread since construction
+class AllocationScope {
+private:
+    detail::AllocationCounters start_;
+
+public:
+    AllocationScope() noexcept {
+        detail::AllocationCounters& c = detail::allocation_counters;
+        c.peak = c.live;  // Peak is measured from here
+        start_ = c;
+    }
+
+    [[nodiscard]] AllocationStats result() const noexcept {
+        const detail::AllocationCounters& c = detail::allocation_counters;
+        return {c.allocations - start_.allocations,
+                c.frees - start_.frees,
+                c.bytes - start_.bytes,
+                static_cast<uint64_t>(std::max<int64_t>(0, c.peak - start_.live))};
+    }
+};
+
+}  // namespace db25::bench
+
+// Replaceable global allocation functions (one translation unit only)
+void* operator new(size_t size) { return db25::bench::detail::counted_new(size, 0); }
+void* operator new[](size_t size) { return db25::bench::detail::counted_new(size, 0); }
+void* operator new(size_t size, std::align_val_t al) {
+    return db25::bench::detail::counted_new(size, static_cast<size_t>(al));
+}
+void* operator new[](size_t size, std::align_val_t al) {
+    return db25::bench::detail::counted_new(size, static_cast<size_t>(al));
+}
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    return db25::bench::detail::counted_allocate(size, 0);
+}
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    return db25::bench::detail::counted_allocate(size, 0);
+}
+
+void operator delete(void* p) noexcept { db25::bench::detail::counted_free(p); }
+void operator delete[](void* p) noexcept { db25::bench::detail::counted_free(p); }
+void operator delete(void* p, size_t) noexcept { db25::bench::detail::counted_free(p); }
+void operator delete[](void* p, size_t) noexcept { db25::bench::detail::counted_free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { db25::bench::detail::counted_free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { db25::bench::detail::counted_free(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { db25::bench::detail::counted_free(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { db25::bench::detail::counted_free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { db25::bench::detail::counted_free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { db25::bench::detail::counted_free(p); }
@@ -0,0 +1,307 @@
+/*
+ * Copyright (c) 2024 Chiradip Mandal
+ * Author: Chiradip Mandal
+ * Organization: Space-RF.org
+ *
+ * This file is part of DB25 SQL Tokenizer.
+ *
+ * Licensed under the MIT License. See LICENSE file for details.
+ */
+
+#pragma once
+
+// ============================================================================
+// Shared benchmark utilities
+// ============================================================================
+// Corpus loading (sql_test.sqls format), input synthesis at a target size,
+// sample statistics and a minimal JSON writer. Header-only so every bench
+// executable stays a single translation unit plus the tokenizer library.
+// ============================================================================
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace db25::bench {
+
+// Complexity levels used by sql_test.sqls, plus ALL for the whole corpus
+inline constexpr std::string_view kLevels[] = {"SIMPLE", "MODERATE", "COMPLEX", "EXTREME", "ALL"};
+
+// Queries grouped by complexity level; every query also appears under ALL
+using Corpus = std::map<std::string, std::vector<std::string>, std::less<>>;
+
+inline std::string trim(std::string_view text) {
+    size_t begin = text.find_first_not_of(" \t");
+    if (begin == std::string_view::npos) {
+        return {};
+    }
+    size_t end = text.find_last_not_of(" \t");
+    return std::string(text.substr(begin, end - begin + 1));
+}
+
+// Parses the --ID/--DESC/--LEVEL/--END format of test/sql_test.sqls
+inline std::optional<Corpus> load_corpus(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        return std::nullopt;
+    }
+
+    Corpus corpus;
+    std::string line;
+    std::string level;
+    std::string sql;
+    bool in_sql = false;
+
+    while (std::getline(file, line)) {
+        if (line.rfind("--LEVEL:", 0) == 0) {
+            level = trim(std::string_view(line).substr(8));
+            sql.clear();
+            in_sql = true;
+        } else if (line == "--END") {
+            if (in_sql && !sql.empty()) {
+                corpus[level].push_back(sql);
+                corpus["ALL"].push_back(sql);
+            }
+            in_sql = false;
+        } else if (in_sql && !line.empty() && line.rfind("--", 0) != 0) {
+            if (!sql.empty()) {
+                sql += '\n';
+            }
+            sql += line;
+        }
+    }
+
+    if (corpus.empty()) {
+        return std::nullopt;
+    }
+    return corpus;
+}
+
+// Repeats `queries` until `size` bytes, cutting the last one at whitespace
+// so the input does not end inside a token where possible
+inline std::string synthesize_input(const std::vector<std::string>& queries, size_t size) {
+    std::string input;
+    input.reserve(size + 64);
+    for (size_t i = 0; input.size() < size; i = (i + 1) % queries.size()) {
+        input += queries[i];
+        input += '\n';
+    }
+
+    size_t cut = input.find_last_of(" \n", size);
+    if (cut == std::string::npos || cut < size / 2) {
+        cut = size;
+    }
+    input.resize(cut);
+    input.resize(size, ' ');
+    return input;
+}
+
+// Parses sizes such as "64", "4K", "16M" or "1G" (binary multiples)
+inline std::optional<size_t> parse_size(std::string_view text) {
+    if (text.empty()) {
+        return std::nullopt;
+    }
+    size_t multiplier = 1;
+    switch (text.back()) {
+        case 'K': case 'k': multiplier = size_t{1} << 10; break;
+        case 'M': case 'm': multiplier = size_t{1} << 20; break;
+        case 'G': case 'g': multiplier = size_t{1} << 30; break;
+        default: break;
+    }
+    if (multiplier != 1) {
+        text.remove_suffix(1);
+    }
+    size_t value = 0;
+    for (char ch : text) {
+        if (ch < '0' || ch > '9') {
+            return std::nullopt;
+        }
+        value = value * 10 + static_cast<size_t>(ch - '0');
+    }
+    return value * multiplier;
+}
+
+inline std::string format_size(size_t bytes) {
+    const char* suffixes[] = {"B", "KB", "MB", "GB"};
+    size_t index = 0;
+    while (bytes >= 1024 && bytes % 1024 == 0 && index < 3) {
+        bytes /= 1024;
+        ++index;
+    }
+    return std::to_string(bytes) + suffixes[index];
+}
+
+// Summary of repeated timing samples (nanoseconds)
+struct SampleStats {
+    double min = 0;
+    double median = 0;
+    double p99 = 0;
+    double mean = 0;
+    double stddev = 0;
+    double cv = 0;  // Coefficient of variation (stddev / mean)
+};
+
+// Nearest-rank percentile (q in [0, 1]) of ascending samples
+inline double percentile(const std::vector<double>& sorted, double q) {
+    if (sorted.empty()) {
+        return 0;
+    }
+    size_t n = sorted.size();
+    size_t rank = static_cast<size_t>(std::ceil(q * static_cast<double>(n)));
+    return sorted[std::clamp<size_t>(rank, 1, n) - 1];
+}
+
+inline SampleStats summarize(std::vector<double> samples) {
+    SampleStats stats;
+    if (samples.empty()) {
+        return stats;
+    }
+    std::sort(samples.begin(), samples.end());
+    size_t n = samples.size();
+
+    stats.min = samples.front();
+    stats.median = (n % 2 == 1) ? samples[n / 2] : (samples[n / 2 - 1] + samples[n / 2]) / 2;
+    stats.p99 = percentile(samples, 0.99);
+
+    double sum = 0;
+    for (double sample : samples) {
+        sum += sample;
+    }
+    stats.mean = sum / static_cast<double>(n);
+    double variance = 0;
+    for (double sample : samples) {
+        variance += (sample - stats.mean) * (sample - stats.mean);
+    }
+    stats.stddev = n > 1 ? std::sqrt(variance / static_cast<double>(n - 1)) : 0;
+    stats.cv = stats.mean > 0 ? stats.stddev / stats.mean : 0;
+    return stats;
+}
+
+inline double now_ns() {
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// Keeps a value alive so the optimizer cannot discard the benchmarked work
+template<typename T>
+inline void do_not_optimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile T sink;
+    sink = value;
+#endif
+}
+
+// Streaming JSON writer for flat records; enough for benchmark reports
+class JsonWriter {
+private:
+    std::ostringstream out_;
+    std::vector<bool> first_;  // Per nesting level: no member written yet
+
+    void separator() {
+        if (!first_.empty()) {
+            if (!first_.back()) {
+                out_ << ",";
+            }
+            first_.back() = false;
+        }
+    }
+
+    void key(std::string_view name) {
+        separator();
+        out_ << "\"" << name << "\":";
+    }
+
+public:
+    JsonWriter& begin_object(std::string_view name = {}) {
+        name.empty() ? separator() : key(name);
+        out_ << "{";
+        first_.push_back(true);
+        return *this;
+    }
+
+    JsonWriter& end_object() {
+        first_.pop_back();
+        out_ << "}";
+        return *this;
+    }
+
+    JsonWriter& begin_array(std::string_view name) {
+        key(name);
+        out_ << "[";
+        first_.push_back(true);
+        return *this;
+    }
+
+    JsonWriter& end_array() {
+        first_.pop_back();
+        out_ << "]";
+        return *this;
+    }
+
+    JsonWriter& field(std::string_view name, std::string_view value) {
+        key(name);
+        out_ << "\"";
+        for (char ch : value) {
+            if (ch == '"' || ch == '\\') {
+                out_ << '\\';
+            }
+            out_ << ch;
+        }
+        out_ << "\"";
+        return *this;
+    }
+
+    JsonWriter& field(std::string_view name, const char* value) {
+        return field(name, std::string_view(value));
+    }
+
+    JsonWriter& field(std::string_view name, double value) {
+        key(name);
+        out_ << (std::isfinite(value) ? value : 0.0);
+        return *this;
+    }
+
+    JsonWriter& field(std::string_view name, uint64_t value) {
+        key(name);
+        out_ << value;
+        return *this;
+    }
+
+    JsonWriter& field(std::string_view name, bool value) {
+        key(name);
+        out_ << (value ? "true" : "false");
+        return *this;
+    }
+
+    [[nodiscard]] std::string str() const { return out_.str(); }
+};
+
+// Compiler and build description recorded with every report
+inline std::string build_description() {
+    std::string text;
+#if defined(__clang__)
+    text = "clang " __clang_version__;
+#elif defined(__GNUC__)
+    text = "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+    text = "msvc " + std::to_string(_MSC_VER);
+#endif
+#ifdef NDEBUG
+    text += " (release)";
+#else
+    text += " (debug)";
+#endif
+    return text;
+}
+
+}  // namespace db25::bench
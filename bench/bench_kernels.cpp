@@ -0,0 +1,349 @@
+/*
+ * Copyright (c) 2024 Chiradip Mandal
+ * Author: Chiradip Mandal
+ * Organization: Space-RF.org
+ *
+ * This file is part of DB25 SQL Tokenizer.
+ *
+ * Licensed under the MIT License. See LICENSE file for details.
+ */
+
+// DB25 SQL Tokenizer - Kernel Microbenchmark
+// ===========================================
+// Measures the processor kernels of simd_architecture.hpp in isolation:
+// skip_whitespace, find_whitespace, identifier_length and matches_keyword,
+// for every SimdLevel the host supports. Three sweeps are run per kernel:
+//
+//   length   run lengths 0-256 at an aligned start
+//   align    one run length at every start offset within a cache line
+//   page     one run length starting just before a 4 KiB page boundary
+//
+// Each cell is the median nanoseconds per call. Cells where a SIMD level is
+// more than 5% slower than scalar are marked with '!', e.g. the one-space
+// whitespace runs between most SQL tokens.
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "bench_common.hpp"
+#include "cycle_clock.hpp"
+#include "simd_architecture.hpp"
+
+using namespace db25;
+using namespace db25::bench;
+
+struct Options {
+    std::vector<SimdLevel> simd_levels = CpuDetection::supported_levels();
+    std::vector<size_t> lengths = {0, 1, 2, 3, 4, 6, 8, 12, 15, 16, 17, 24, 31, 32, 33,
+                                   48, 63, 64, 65, 96, 128, 192, 256};
+    std::vector<size_t> offsets = {0, 1, 3, 7, 8, 15, 16, 31, 32, 33, 47, 63};
+    std::vector<size_t> page_gaps = {1, 4, 8, 15, 16, 31, 32, 48, 63, 64};
+    size_t sweep_length = 64;  // Run length of the align and page sweeps
+    std::string kernel;        // Empty = every kernel
+    std::string json_path;
+    size_t calls = 2000;       // Calls per sample
+    size_t repetitions = 11;
+};
+
+enum class Kernel { SkipWhitespace, FindWhitespace, IdentifierLength, MatchesKeyword };
+
+constexpr Kernel kKernels[] = {Kernel::SkipWhitespace, Kernel::FindWhitespace,
+                               Kernel::IdentifierLength, Kernel::MatchesKeyword};
+
+const char* kernel_name(Kernel kernel) {
+    switch (kernel) {
+        case Kernel::SkipWhitespace: return "skip_whitespace";
+        case Kernel::FindWhitespace: return "find_whitespace";
+        case Kernel::IdentifierLength: return "identifier_length";
+        case Kernel::MatchesKeyword: return "matches_keyword";
+    }
+    return "unknown";
+}
+
+struct Result {
+    Kernel kernel;
+    std::string sweep;
+    size_t length;
+    size_t offset;  // From a 64-byte boundary (align) or to the page end (page)
+    SimdLevel simd_level;
+    double ns;      // Median per call
+};
+
+// Bytes after the run so kernels see the rest of an input, as in the tokenizer
+constexpr size_t kTail = 64;
+constexpr size_t kPageSize = 4096;
+constexpr size_t kMaxKeyword = 64;
+
+void print_usage(const char* program) {
+    std::cout << "Usage: " << program << " [options]\n"
+              << "  --kernel NAME       skip_whitespace, find_whitespace, identifier_length or\n"
+              << "                      matches_keyword (default: all)\n"
+              << "  --simd-level NAME   scalar, sse42, avx2, avx512, avx512vbmi, neon or all (default: all)\n"
+              << "  --max-length N      Longest run of the length sweep (default: 256)\n"
+              << "  --sweep-length N    Run length of the alignment and page sweeps (default: 64)\n"
+              << "  --calls N           Calls per timed sample (default: 2000)\n"
+              << "  --repetitions N     Timed samples per cell (default: 11)\n"
+              << "  --json PATH         Write results as JSON\n";
+}
+
+bool parse_options(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-h" || arg == "--help") {
+            print_usage(argv[0]);
+            return false;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Error: Missing value for " << arg << "\n";
+            return false;
+        }
+        std::string value = argv[++i];
+
+        if (arg == "--kernel") {
+            auto known = std::find_if(std::begin(kKernels), std::end(kKernels),
+                                      [&](Kernel k) { return value == kernel_name(k); });
+            if (known == std::end(kKernels)) {
+                std::cerr << "Error: Unknown kernel: " << value << "\n";
+                return false;
+            }
+            options.kernel = value;
+        } else if (arg == "--simd-level") {
+            if (value != "all") {
+                auto parsed = CpuDetection::parse_level(value);
+                if (!parsed || !CpuDetection::is_supported(*parsed)) {
+                    std::cerr << "Error: SIMD level not supported on this host: " << value << "\n";
+                    return false;
+                }
+                options.simd_levels = {*parsed};
+            }
+        } else if (arg == "--json") {
+            options.json_path = value;
+        } else if (arg == "--max-length" || arg == "--sweep-length" ||
+                   arg == "--calls" || arg == "--repetitions") {
+            auto parsed = parse_size(value);
+            if (!parsed || (arg == "--max-length" ? *parsed > 4 * kPageSize : *parsed == 0)) {
+                std::cerr << "Error: Invalid value for " << arg << ": " << value << "\n";
+                return false;
+            }
+            if (arg == "--max-length") {
+                std::erase_if(options.lengths, [&](size_t n) { return n > *parsed; });
+            }
+            if (arg == "--sweep-length") options.sweep_length = *parsed;
+            if (arg == "--calls") options.calls = *parsed;
+            if (arg == "--repetitions") options.repetitions = *parsed;
+        } else {
+            std::cerr << "Error: Unknown option " << arg << "\n";
+            print_usage(argv[0]);
+            return false;
+        }
+    }
+    return true;
+}
+
+// Page-aligned scratch memory large enough for any run plus its tail
+class Buffer {
+private:
+    struct Free {
+        void operator()(std::byte* p) const noexcept { std::free(p); }
+    };
+    std::unique_ptr<std::byte, Free> data_;
+    size_t size_;
+
+public:
+    explicit Buffer(size_t size)
+        : data_(static_cast<std::byte*>(std::aligned_alloc(kPageSize, size))), size_(size) {}
+
+    [[nodiscard]] std::byte* data() const noexcept { return data_.get(); }
+    [[nodiscard]] size_t size() const noexcept { return size_; }
+};
+
+// Lays out the input for one call at `start` and returns the size argument
+size_t prepare(Kernel kernel, std::byte* start, size_t length, char* keyword) {
+    auto fill = [](std::byte* p, size_t n, char ch) { std::memset(p, ch, n); };
+    switch (kernel) {
+        case Kernel::SkipWhitespace:
+            // Spaces, then an identifier
+            fill(start, length, ' ');
+            fill(start + length, kTail, 'x');
+            return length + kTail;
+        case Kernel::FindWhitespace:
+        case Kernel::IdentifierLength:
+            // Identifier characters, then a space
+            fill(start, length, 'a');
+            fill(start + length, kTail, ' ');
+            return length + kTail;
+        case Kernel::MatchesKeyword:
+            // Lower-case word matching an upper-case keyword, then a space
+            fill(start, length, 'k');
+            fill(start + length, kTail, ' ');
+            std::memset(keyword, 'K', length);
+            return length + kTail;
+    }
+    return 0;
+}
+
+template<typename Processor>
+double time_kernel(Processor processor, Kernel kernel, const std::byte* data, size_t size,
+                   const char* keyword, size_t length, const Options& options) {
+    auto call = [&]() -> size_t {
+        switch (kernel) {
+            case Kernel::SkipWhitespace: return processor.skip_whitespace(data, size);
+            case Kernel::FindWhitespace: return processor.find_whitespace(data, size);
+            case Kernel::IdentifierLength: {
+                uint8_t seen = 0;
+                return processor.identifier_length(data, size, seen);
+            }
+            case Kernel::MatchesKeyword: return processor.matches_keyword(data, size, keyword, length);
+        }
+        return 0;
+    };
+
+    const double ns_per_tick = 1e9 / CycleClock::frequency();
+    for (size_t i = 0; i < options.calls / 4 + 1; ++i) {
+        do_not_optimize(call());
+    }
+    std::vector<double> samples;
+    samples.reserve(options.repetitions);
+    for (size_t r = 0; r < options.repetitions; ++r) {
+        uint64_t start = CycleClock::fenced_now();
+        for (size_t i = 0; i < options.calls; ++i) {
+            // Memory clobber: the kernel's reads cannot be hoisted out
+            do_not_optimize(data);
+            do_not_optimize(call());
+        }
+        uint64_t end = CycleClock::fenced_now();
+        samples.push_back(static_cast<double>(end - start) * ns_per_tick / static_cast<double>(options.calls));
+    }
+    return summarize(std::move(samples)).median;
+}
+
+double measure(SimdLevel level, Kernel kernel, std::byte* start, size_t length, const Options& options) {
+    char keyword[kMaxKeyword + 1] = {};
+    size_t size = prepare(kernel, start, length, keyword);
+    return SimdDispatcher(level).dispatch([&](auto processor) {
+        return time_kernel(processor, kernel, start, size, keyword, length, options);
+    });
+}
+
+void print_header(const std::string& title, const char* column, const Options& options) {
+    std::cout << "\n" << title << " (ns per call)\n\n";
+    std::cout << std::left << std::setw(10) << column << std::right;
+    for (SimdLevel level : options.simd_levels) {
+        std::cout << std::setw(14) << CpuDetection::level_name(level);
+    }
+    std::cout << "\n" << std::string(10 + 14 * options.simd_levels.size(), '-') << "\n";
+}
+
+// One row: a cell per SIMD level, '!' where slower than scalar
+void print_row(size_t key, const std::vector<Result>& row) {
+    double scalar = row.front().simd_level == SimdLevel::None ? row.front().ns : 0;
+    std::cout << std::left << std::setw(10) << key << std::right;
+    for (const auto& result : row) {
+        bool slower = scalar > 0 && result.simd_level != SimdLevel::None && result.ns > scalar * 1.05;
+        std::cout << std::fixed << std::setprecision(2) << std::setw(13) << result.ns
+                  << (slower ? "!" : " ");
+    }
+    std::cout << "\n";
+}
+
+std::string to_json(const std::vector<Result>& results, const Options& options) {
+    JsonWriter json;
+    json.begin_object()
+        .field("benchmark", "bench_kernels")
+        .field("detected_simd_level", CpuDetection::level_name())
+        .field("build", build_description())
+        .field("calls_per_sample", uint64_t{options.calls})
+        .field("repetitions", uint64_t{options.repetitions})
+        .begin_array("results");
+    for (const auto& result : results) {
+        json.begin_object()
+            .field("kernel", kernel_name(result.kernel))
+            .field("sweep", result.sweep)
+            .field("simd_level", CpuDetection::level_name(result.simd_level))
+            .field("length", uint64_t{result.length})
+            .field("offset", uint64_t{result.offset})
+            .field("ns_per_call", result.ns)
+            .end_object();
+    }
+    json.end_array().end_object();
+    return json.str();
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parse_options(argc, argv, options)) {
+        return argc > 1 && (std::string(argv[1]) == "-h" || std::string(argv[1]) == "--help") ? 0 : 1;
+    }
+
+    std::cout << "DB25 Tokenizer Kernel Benchmark\n";
+    std::cout << "===============================\n";
+    std::cout << "SIMD level:  " << CpuDetection::level_name() << " (detected)\n";
+    std::cout << "Build:       " << build_description() << "\n";
+    std::cout << "Samples:     " << options.repetitions << " x " << options.calls << " calls per cell\n";
+    std::cout << "'!' marks a SIMD level more than 5% slower than scalar\n";
+
+    // Two pages: runs start near the end of the first for the page sweep
+    size_t longest = std::max(options.lengths.empty() ? 0 : options.lengths.back(), options.sweep_length);
+    Buffer buffer((longest + kTail + 64) / kPageSize * kPageSize + 2 * kPageSize);
+    if (buffer.data() == nullptr) {
+        std::cerr << "Error: Cannot allocate the input buffer\n";
+        return 1;
+    }
+
+    std::vector<Result> results;
+    auto sweep = [&](Kernel kernel, const std::string& name, const char* column,
+                     const std::vector<size_t>& keys, auto layout) {
+        print_header(std::string(kernel_name(kernel)) + ": " + name, column, options);
+        for (size_t key : keys) {
+            auto [length, start, offset] = layout(key);
+            if (kernel == Kernel::MatchesKeyword && (length == 0 || length > kMaxKeyword)) {
+                continue;
+            }
+            std::vector<Result> row;
+            for (SimdLevel level : options.simd_levels) {
+                double ns = measure(level, kernel, buffer.data() + start, length, options);
+                row.push_back({kernel, name, length, offset, level, ns});
+            }
+            print_row(key, row);
+            results.insert(results.end(), row.begin(), row.end());
+        }
+    };
+
+    for (Kernel kernel : kKernels) {
+        if (!options.kernel.empty() && options.kernel != kernel_name(kernel)) {
+            continue;
+        }
+        sweep(kernel, "run length, aligned start", "Length", options.lengths,
+              [](size_t length) { return std::tuple{length, size_t{0}, size_t{0}}; });
+        sweep(kernel, "start offset, length " + std::to_string(options.sweep_length), "Offset", options.offsets,
+              [&](size_t offset) { return std::tuple{options.sweep_length, offset, offset}; });
+        sweep(kernel, "bytes before page end, length " + std::to_string(options.sweep_length), "Gap",
+              options.page_gaps,
+              [&](size_t gap) { return std::tuple{options.sweep_length, kPageSize - gap, gap}; });
+    }
+
+    if (results.empty()) {
+        std::cerr << "Error: No benchmark configurations selected\n";
+        return 1;
+    }
+
+    if (!options.json_path.empty()) {
+        std::ofstream out(options.json_path);
+        if (!out) {
+            std::cerr << "Error: Cannot write " << options.json_path << "\n";
+            return 1;
+        }
+        out << to_json(results, options) << "\n";
+        std::cout << "\nResults written to " << options.json_path << "\n";
+    }
+
+    std::cout << "\n✅ Kernel benchmark complete (" << results.size() << " measurements).\n";
+    return 0;
+}
@@ -0,0 +1,415 @@
+/*
+ * Copyright (c) 2024 Chiradip Mandal
+ * Author: Chiradip Mandal
+ * Organization: Space-RF.org
+ *
+ * This file is part of DB25 SQL Tokenizer.
+ *
+ * Licensed under the MIT License. See LICENSE file for details.
+ */
+
+// DB25 SQL Tokenizer - Small-Query Latency Benchmark
+// ===================================================
+// Measures the latency of tokenizing one short statement the way a proxy
+// does: construct a SimdTokenizer, call tokenize(), drop the tokens. Each
+// run is timed individually with the fenced CycleClock (rdtsc on x86) and
+// reported as a distribution in nanoseconds, both with warm caches (runs
+// back to back) and cold (data caches evicted and branch predictors
+// scrambled before every run). Constructor-only and empty-input rows
+// isolate the fixed cost of construction, dispatch and allocation.
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <vector>
+#include "bench_common.hpp"
+#include "cycle_clock.hpp"
+#include "simd_tokenizer.hpp"
+
+using namespace db25;
+using namespace db25::bench;
+
+struct Options {
+    std::string corpus = "test/sql_test.sqls";
+    std::vector<std::string> queries;     // --query; replaces the defaults
+    std::optional<SimdLevel> simd_level;  // Unset: detected, as in production
+    std::string json_path;
+    size_t max_query_bytes = 256;
+    size_t warmup = 1000;
+    size_t iterations = 20000;
+    size_t cold_iterations = 300;
+    size_t pollute_bytes = size_t{32} << 20;
+};
+
+// Statements typical of proxy traffic, in addition to the short corpus queries
+constexpr const char* kDefaultQueries[] = {
+    "SELECT 1",
+    "BEGIN",
+    "COMMIT",
+    "SELECT * FROM users WHERE id = $1",
+    "UPDATE accounts SET balance = balance - $1 WHERE id = $2",
+    "INSERT INTO sessions (id, user_id, expires_at) VALUES ($1, $2, $3)",
+    "SELECT id, name, email FROM customers WHERE email = $1 AND deleted_at IS NULL LIMIT 1",
+};
+
+// Latency distribution in nanoseconds
+struct Distribution {
+    double min = 0;
+    double p50 = 0;
+    double p90 = 0;
+    double p99 = 0;
+    double p999 = 0;
+    double max = 0;
+    double mean = 0;
+};
+
+struct Result {
+    std::string label;
+    size_t bytes;
+    size_t tokens;
+    Distribution warm;
+    Distribution cold;
+};
+
+enum class Work { Construct, Tokenize };
+
+void print_usage(const char* program) {
+    std::cout << "Usage: " << program << " [options]\n"
+              << "  --corpus PATH          Corpus whose short queries are measured (default: test/sql_test.sqls)\n"
+              << "  --query SQL            Measure SQL instead of the default queries (repeatable)\n"
+              << "  --max-query-bytes N    Longest corpus query measured (default: 256)\n"
+              << "  --simd-level NAME      scalar, sse42, avx2, avx512, avx512vbmi or neon (default: detected)\n"
+              << "  --warmup N             Untimed warm runs per query (default: 1000)\n"
+              << "  --iterations N         Timed warm runs per query (default: 20000)\n"
+              << "  --cold-iterations N    Timed cold runs per query (default: 300)\n"
+              << "  --pollute-bytes SIZE   Buffer walked before each cold run (default: 32M)\n"
+              << "  --json PATH            Write results as JSON\n";
+}
+
+bool parse_options(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-h" || arg == "--help") {
+            print_usage(argv[0]);
+            return false;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Error: Missing value for " << arg << "\n";
+            return false;
+        }
+        std::string value = argv[++i];
+
+        if (arg == "--corpus") {
+            options.corpus = value;
+        } else if (arg == "--query") {
+            options.queries.push_back(value);
+        } else if (arg == "--simd-level") {
+            auto parsed = CpuDetection::parse_level(value);
+            if (!parsed || !CpuDetection::is_supported(*parsed)) {
+                std::cerr << "Error: SIMD level not supported on this host: " << value << "\n";
+                return false;
+            }
+            options.simd_level = *parsed;
+        } else if (arg == "--json") {
+            options.json_path = value;
+        } else if (arg == "--max-query-bytes" || arg == "--warmup" || arg == "--iterations" ||
+                   arg == "--cold-iterations" || arg == "--pollute-bytes") {
+            auto parsed = parse_size(value);
+            if (!parsed || (*parsed == 0 && arg != "--warmup")) {
+                std::cerr << "Error: Invalid value for " << arg << ": " << value << "\n";
+                return false;
+            }
+            if (arg == "--max-query-bytes") options.max_query_bytes = *parsed;
+            if (arg == "--warmup") options.warmup = *parsed;
+            if (arg == "--iterations") options.iterations = *parsed;
+            if (arg == "--cold-iterations") options.cold_iterations = *parsed;
+            if (arg == "--pollute-bytes") options.pollute_bytes = *parsed;
+        } else {
+            std::cerr << "Error: Unknown option " << arg << "\n";
+            print_usage(argv[0]);
+            return false;
+        }
+    }
+    return true;
+}
+
+// Evicts the data caches and scrambles the branch predictors between runs
+class Polluter {
+private:
+    std::vector<uint64_t> buffer_;  // Should exceed the last-level cache
+    std::vector<uint8_t> noise_;    // Random bytes driving unpredictable branches
+    uint64_t state_ = 0x9E3779B97F4A7C15ull;
+
+    uint64_t next() noexcept {
+        // splitmix64
+        uint64_t z = (state_ += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    using Step = uint64_t (*)(uint64_t, uint8_t);
+    static constexpr Step kSteps[] = {
+        [](uint64_t h, uint8_t b) { return h + b; },
+        [](uint64_t h, uint8_t b) { return h ^ (uint64_t{b} << 7); },
+        [](uint64_t h, uint8_t b) { return h * 31 + b; },
+        [](uint64_t h, uint8_t b) { return (h >> 3) | b; },
+    };
+
+public:
+    explicit Polluter(size_t bytes)
+        : buffer_(std::max<size_t>(bytes / sizeof(uint64_t), 8)), noise_(size_t{1} << 16) {
+        for (auto& byte : noise_) {
+            byte = static_cast<uint8_t>(next());
+        }
+    }
+
+    void run() noexcept {
+        // Write every cache line so dirty lines of the tokenizer are evicted
+        for (size_t i = 0; i < buffer_.size(); i += 64 / sizeof(uint64_t)) {
+            buffer_[i] += i;
+        }
+
+        // Conditional and indirect branches on random data, from a random
+        // starting point so the sequence never repeats exactly
+        uint64_t hash = 0;
+        size_t start = next();
+        for (size_t i = 0; i < noise_.size(); ++i) {
+            uint8_t byte = noise_[(start + i) & (noise_.size() - 1)];
+            if (byte & 0x10) {
+                hash += byte;
+            } else {
+                hash ^= hash >> 5;
+            }
+            hash = kSteps[byte & 3](hash, byte);
+        }
+        do_not_optimize(hash);
+        do_not_optimize(buffer_.data());
+    }
+};
+
+// One construct (+ tokenize) as production performs it; returns tokens
+size_t run_once(const std::string& sql, const Options& options, Work work) {
+    auto data = reinterpret_cast<const std::byte*>(sql.data());
+    if (work == Work::Construct) {
+        if (options.simd_level) {
+            SimdTokenizer tokenizer(data, sql.size(), *options.simd_level);
+            do_not_optimize(&tokenizer);
+        } else {
+            SimdTokenizer tokenizer(data, sql.size());
+            do_not_optimize(&tokenizer);
+        }
+        return 0;
+    }
+    std::vector<Token> tokens;
+    if (options.simd_level) {
+        SimdTokenizer tokenizer(data, sql.size(), *options.simd_level);
+        tokens = tokenizer.tokenize();
+    } else {
+        SimdTokenizer tokenizer(data, sql.size());
+        tokens = tokenizer.tokenize();
+    }
+    do_not_optimize(tokens.data());
+    return tokens.size();
+}
+
+// Smallest cost of the timestamps themselves, subtracted from every sample
+uint64_t timer_overhead() {
+    uint64_t best = UINT64_MAX;
+    for (int i = 0; i < 10000; ++i) {
+        uint64_t start = CycleClock::fenced_now();
+        uint64_t end = CycleClock::fenced_now();
+        best = std::min(best, end - start);
+    }
+    return best;
+}
+
+Distribution distribution(std::vector<double> samples) {
+    Distribution d;
+    if (samples.empty()) {
+        return d;
+    }
+    std::sort(samples.begin(), samples.end());
+    d.min = samples.front();
+    d.p50 = percentile(samples, 0.50);
+    d.p90 = percentile(samples, 0.90);
+    d.p99 = percentile(samples, 0.99);
+    d.p999 = percentile(samples, 0.999);
+    d.max = samples.back();
+    double sum = 0;
+    for (double sample : samples) {
+        sum += sample;
+    }
+    d.mean = sum / static_cast<double>(samples.size());
+    return d;
+}
+
+std::vector<double> sample(const std::string& sql, const Options& options, Work work,
+                           size_t iterations, Polluter* polluter, uint64_t overhead) {
+    const double ns_per_tick = 1e9 / CycleClock::frequency();
+    std::vector<double> samples;
+    samples.reserve(iterations);
+    for (size_t i = 0; i < iterations; ++i) {
+        if (polluter != nullptr) {
+            polluter->run();
+        }
+        uint64_t start = CycleClock::fenced_now();
+        size_t count = run_once(sql, options, work);
+        uint64_t end = CycleClock::fenced_now();
+        do_not_optimize(count);
+        uint64_t ticks = end - start;
+        samples.push_back(static_cast<double>(ticks > overhead ? ticks - overhead : 0) * ns_per_tick);
+    }
+    return samples;
+}
+
+// Single-line label for a statement
+std::string label_of(const std::string& sql) {
+    std::string label;
+    for (char ch : sql) {
+        if (ch == '\n' || ch == '\t') {
+            ch = ' ';
+        }
+        if (ch != ' ' || (!label.empty() && label.back() != ' ')) {
+            label += ch;
+        }
+    }
+    if (label.size() > 40) {
+        label = label.substr(0, 37) + "...";
+    }
+    return label;
+}
+
+void print_result(const Result& result) {
+    std::cout << std::left << std::setw(42) << result.label
+              << std::right << std::setw(6) << result.bytes
+              << std::setw(8) << result.tokens
+              << std::fixed << std::setprecision(0)
+              << std::setw(11) << result.warm.p50
+              << std::setw(11) << result.warm.p99
+              << std::setw(11) << result.cold.p50
+              << std::setw(11) << result.cold.p99
+              << std::setw(11) << result.cold.max << "\n";
+}
+
+void add_distribution(JsonWriter& json, std::string_view name, const Distribution& d) {
+    json.begin_object(name)
+        .field("min_ns", d.min)
+        .field("p50_ns", d.p50)
+        .field("p90_ns", d.p90)
+        .field("p99_ns", d.p99)
+        .field("p999_ns", d.p999)
+        .field("max_ns", d.max)
+        .field("mean_ns", d.mean)
+        .end_object();
+}
+
+std::string to_json(const std::vector<Result>& results, const Options& options, double overhead_ns) {
+    JsonWriter json;
+    json.begin_object()
+        .field("benchmark", "bench_latency")
+        .field("simd_level", CpuDetection::level_name(options.simd_level.value_or(CpuDetection::configured_level())))
+        .field("build", build_description())
+        .field("tick_hz", CycleClock::frequency())
+        .field("timer_overhead_ns", overhead_ns)
+        .field("iterations", uint64_t{options.iterations})
+        .field("cold_iterations", uint64_t{options.cold_iterations})
+        .field("pollute_bytes", uint64_t{options.pollute_bytes})
+        .begin_array("results");
+    for (const auto& result : results) {
+        json.begin_object()
+            .field("query", result.label)
+            .field("bytes", uint64_t{result.bytes})
+            .field("tokens", uint64_t{result.tokens});
+        add_distribution(json, "warm", result.warm);
+        add_distribution(json, "cold", result.cold);
+        json.end_object();
+    }
+    json.end_array().end_object();
+    return json.str();
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parse_options(argc, argv, options)) {
+        return argc > 1 && (std::string(argv[1]) == "-h" || std::string(argv[1]) == "--help") ? 0 : 1;
+    }
+
+    std::vector<std::string> queries = options.queries;
+    if (queries.empty()) {
+        queries.assign(std::begin(kDefaultQueries), std::end(kDefaultQueries));
+        auto corpus = load_corpus(options.corpus);
+        if (!corpus) {
+            std::cerr << "Error: Cannot load corpus: " << options.corpus << "\n";
+            return 1;
+        }
+        for (const auto& sql : corpus->at("ALL")) {
+            if (sql.size() <= options.max_query_bytes) {
+                queries.push_back(sql);
+            }
+        }
+    }
+
+    uint64_t overhead = timer_overhead();
+    double overhead_ns = static_cast<double>(overhead) * 1e9 / CycleClock::frequency();
+    Polluter polluter(options.pollute_bytes);
+
+    std::cout << "DB25 Tokenizer Latency Benchmark\n";
+    std::cout << "================================\n";
+    std::cout << "SIMD level:  " << CpuDetection::level_name(options.simd_level.value_or(CpuDetection::configured_level()))
+              << (options.simd_level ? ""
+                  : CpuDetection::configured_level() == CpuDetection::detect() ? " (detected)"
+                                                                                : " (DB25_SIMD_LEVEL)")
+              << "\n";
+    std::cout << "Build:       " << build_description() << "\n";
+    std::cout << "Clock:       " << std::fixed << std::setprecision(3) << CycleClock::frequency() / 1e9
+              << " GHz, overhead " << std::setprecision(1) << overhead_ns << " ns (subtracted)\n";
+    std::cout << "Runs:        " << options.iterations << " warm, " << options.cold_iterations
+              << " cold (" << format_size(options.pollute_bytes) << " evicted per run)\n\n";
+
+    std::cout << std::left << std::setw(42) << "Query (latency in ns)"
+              << std::right << std::setw(6) << "Bytes"
+              << std::setw(8) << "Tokens"
+              << std::setw(11) << "Warm p50"
+              << std::setw(11) << "Warm p99"
+              << std::setw(11) << "Cold p50"
+              << std::setw(11) << "Cold p99"
+              << std::setw(11) << "Cold max" << "\n";
+    std::cout << std::string(111, '-') << "\n";
+
+    auto measure = [&](std::string label, const std::string& sql, Work work) {
+        Result result{std::move(label), sql.size(), run_once(sql, options, work), {}, {}};
+        for (size_t i = 0; i < options.warmup; ++i) {
+            do_not_optimize(run_once(sql, options, work));
+        }
+        result.warm = distribution(sample(sql, options, work, options.iterations, nullptr, overhead));
+        result.cold = distribution(sample(sql, options, work, options.cold_iterations, &polluter, overhead));
+        print_result(result);
+        return result;
+    };
+
+    // Fixed costs first, then the statements
+    std::vector<Result> results;
+    results.push_back(measure("<constructor only>", queries.front(), Work::Construct));
+    results.push_back(measure("<empty input>", std::string(), Work::Tokenize));
+    for (const auto& sql : queries) {
+        results.push_back(measure(label_of(sql), sql, Work::Tokenize));
+    }
+
+    if (!options.json_path.empty()) {
+        std::ofstream out(options.json_path);
+        if (!out) {
+            std::cerr << "Error: Cannot write " << options.json_path << "\n";
+            return 1;
+        }
+        out << to_json(results, options, overhead_ns) << "\n";
+        std::cout << "\nResults written to " << options.json_path << "\n";
+    }
+
+    std::cout << "\n✅ Latency benchmark complete (" << results.size() << " queries).\n";
+    return 0;
+}
@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2024 Chiradip Mandal
+ * Author: Chiradip Mandal
+ * Organization: Space-RF.org
+ *
+ * This file is part of DB25 SQL Tokenizer.
+ *
+ * Licensed under the MIT License. See LICENSE file for details.
+ */
+
+// DB25 SQL Tokenizer - Memory Benchmark
+// ======================================
+// Allocations, bytes allocated and peak live bytes of one tokenize() call per
+// complexity level of test/sql_test.sqls and per input size, also per input
+// byte. --exact measures tokenize_exact() (count, allocate once, fill).
+//
+// Allocations are counted by replacing the global operator new/delete
+// (alloc_counter.hpp), which slows every allocation of the program down.
+// Nothing is timed here for that reason; bench_tokenizer measures speed
+// with the default allocator.
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "alloc_counter.hpp"
+#include "bench_common.hpp"
+#include "simd_tokenizer.hpp"
+
+using namespace db25;
+using namespace db25::bench;
+
+struct Options {
+    std::string corpus = "test/sql_test.sqls";
+    std::string level;        // Empty = every level
+    std::string json_path;
+    size_t min_size = 64;
+    size_t max_size = size_t{64} << 20;
+    bool exact = false;       // tokenize_exact() instead of tokenize()
+};
+
+struct Result {
+    std::string level;
+    size_t size;
+    size_t tokens;
+    AllocationStats memory;  // One tokenizer run
+};
+
+void print_usage(const char* program) {
+    std::cout << "Usage: " << program << " [options]\n"
+              << "  --corpus PATH       SQL corpus (default: test/sql_test.sqls)\n"
+              << "  --level NAME        SIMPLE, MODERATE, COMPLEX, EXTREME, ALL or any\n"
+              << "                      other --LEVEL of the corpus (e.g. generate_corpus mixes)\n"
+              << "  --min-size SIZE     Smallest input, e.g. 64 (default: 64)\n"
+              << "  --max-size SIZE     Largest input, e.g. 256M or 1G (default: 64M)\n"
+              << "  --exact             Measure tokenize_exact() instead of tokenize()\n"
+              << "  --json PATH         Write results as JSON\n";
+}
+
+bool parse_options(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-h" || arg == "--help") {
+            print_usage(argv[0]);
+            return false;
+        }
+        if (arg == "--exact") {
+            options.exact = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Error: Missing value for " << arg << "\n";
+            return false;
+        }
+        std::string value = argv[++i];
+
+        if (arg == "--corpus") {
+            options.corpus = value;
+        } else if (arg == "--level") {
+            options.level = value;
+        } else if (arg == "--json") {
+            options.json_path = value;
+        } else if (arg == "--min-size" || arg == "--max-size") {
+            auto parsed = parse_size(value);
+            if (!parsed || *parsed == 0) {
+                std::cerr << "Error: Invalid value for " << arg << ": " << value << "\n";
+                return false;
+            }
+            if (arg == "--min-size") options.min_size = *parsed;
+            if (arg == "--max-size") options.max_size = *parsed;
+        } else {
+            std::cerr << "Error: Unknown option " << arg << "\n";
+            print_usage(argv[0]);
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t run_tokenizer(const std::string& input, bool exact) {
+    SimdTokenizer tokenizer(reinterpret_cast<const std::byte*>(input.data()), input.size());
+    auto tokens = exact ? tokenizer.tokenize_exact() : tokenizer.tokenize();
+    return tokens.size();
+}
+
+Result measure(const std::string& level, const std::string& input, bool exact) {
+    Result result{level, input.size(), 0, {}};
+    run_tokenizer(input, exact);  // One-time initialization is not counted
+    AllocationScope scope;
+    result.tokens = run_tokenizer(input, exact);
+    result.memory = scope.result();
+    return result;
+}
+
+void print_result(const Result& result) {
+    double bytes = static_cast<double>(result.size);
+    std::cout << std::left << std::setw(12) << result.level
+              << std::right << std::setw(8) << format_size(result.size)
+              << std::setw(12) << result.tokens
+              << std::setw(10) << result.memory.allocations
+              << std::setw(14) << result.memory.bytes
+              << std::setw(14) << result.memory.peak_bytes
+              << std::fixed << std::setprecision(2)
+              << std::setw(12) << static_cast<double>(result.memory.bytes) / bytes
+              << std::setw(12) << static_cast<double>(result.memory.peak_bytes) / bytes << "\n";
+}
+
+std::string to_json(const std::vector<Result>& results, const Options& options) {
+    JsonWriter json;
+    json.begin_object()
+        .field("benchmark", "bench_memory")
+        .field("detected_simd_level", CpuDetection::level_name())
+        .field("build", build_description())
+        .field("mode", options.exact ? "exact" : "reserve")
+        .begin_array("results");
+    for (const auto& result : results) {
+        double bytes = static_cast<double>(result.size);
+        json.begin_object()
+            .field("level", result.level)
+            .field("size_bytes", uint64_t{result.size})
+            .field("tokens", uint64_t{result.tokens})
+            .field("allocations", result.memory.allocations)
+            .field("allocated_bytes", result.memory.bytes)
+            .field("peak_bytes", result.memory.peak_bytes)
+            .field("allocated_bytes_per_byte", static_cast<double>(result.memory.bytes) / bytes)
+            .field("peak_bytes_per_byte", static_cast<double>(result.memory.peak_bytes) / bytes)
+            .end_object();
+    }
+    json.end_array().end_object();
+    return json.str();
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parse_options(argc, argv, options)) {
+        return argc > 1 && (std::string(argv[1]) == "-h" || std::string(argv[1]) == "--help") ? 0 : 1;
+    }
+
+    auto corpus = load_corpus(options.corpus);
+    if (!corpus) {
+        std::cerr << "Error: Cannot load corpus: " << options.corpus << "\n";
+        return 1;
+    }
+
+    std::cout << "DB25 Tokenizer Memory Benchmark\n";
+    std::cout << "===============================\n";
+    std::cout << "Build:       " << build_description() << "\n";
+    std::cout << "Mode:        " << (options.exact ? "tokenize_exact()" : "tokenize()") << "\n\n";
+
+    std::cout << "Memory per call (bytes; /B = per input byte)\n\n";
+    std::cout << std::left << std::setw(12) << "Level"
+              << std::right << std::setw(8) << "Size"
+              << std::setw(12) << "Tokens"
+              << std::setw(10) << "Allocs"
+              << std::setw(14) << "Allocated"
+              << std::setw(14) << "Peak live"
+              << std::setw(12) << "Alloc/B"
+              << std::setw(12) << "Peak/B" << "\n";
+    std::cout << std::string(94, '-') << "\n";
+
+    // Known levels first, then any others the corpus defines
+    std::vector<std::string_view> levels(std::begin(kLevels), std::end(kLevels));
+    for (const auto& [name, queries] : *corpus) {
+        if (std::find(levels.begin(), levels.end(), name) == levels.end()) {
+            levels.insert(levels.end() - 1, name);
+        }
+    }
+
+    std::vector<Result> results;
+    for (std::string_view level : levels) {
+        if (!options.level.empty() && options.level != level) {
+            continue;
+        }
+        auto queries = corpus->find(level);
+        if (queries == corpus->end()) {
+            continue;
+        }
+        for (size_t size = options.min_size; size <= options.max_size; size *= 4) {
+            std::string input = synthesize_input(queries->second, size);
+            results.push_back(measure(std::string(level), input, options.exact));
+            print_result(results.back());
+        }
+    }
+
+    if (results.empty()) {
+        std::cerr << "Error: No benchmark configurations selected\n";
+        return 1;
+    }
+
+    if (!options.json_path.empty()) {
+        std::ofstream out(options.json_path);
+        if (!out) {
+            std::cerr << "Error: Cannot write " << options.json_path << "\n";
+            return 1;
+        }
+        out << to_json(results, options) << "\n";
+        std::cout << "\nResults written to " << options.json_path << "\n";
+    }
+
+    std::cout << "\n✅ Memory benchmark complete (" << results.size() << " configurations).\n";
+    return 0;
+}
@@ -0,0 +1,423 @@
+/*
+ * Copyright (c) 2024 Chiradip Mandal
+ * Author: Chiradip Mandal
+ * Organization: Space-RF.org
+ *
+ * This file is part of DB25 SQL Tokenizer.
+ *
+ * Licensed under the MIT License. See LICENSE file for details.
+ */
+
+// DB25 SQL Tokenizer - Pipeline Benchmark
+// ========================================
+// Writes a set of SQL files synthesized from the corpus, then tokenizes all
+// of them, timing the best of several runs:
+//
+//   sequential   read a file, tokenize it, read the next (one thread)
+//   threads      FilePipeline with blocking reads on reader threads
+//   io_uring     FilePipeline with reads queued in io_uring (falls back to
+//                threads where the kernel does not allow it)
+//
+// With warm page cache the pipelines mostly show worker parallelism; --cold
+// drops the files from the page cache before every run (Linux), which is
+// where overlapping reads with tokenization pays off.
+//
+// A second table feeds one large in-memory script to a stand-in parser that
+// walks every token (nesting depth, statement count, a hash of the text):
+//
+//   script-sequential   tokenize() the whole script, then parse
+//   script-pipelined    TokenPipeline: parse block N while N+1 is lexed
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+#include "bench_common.hpp"
+#include "file_pipeline.hpp"
+#include "token_pipeline.hpp"
+
+#if defined(__linux__)
+    #include <fcntl.h>
+    #include <unistd.h>
+    #define DB25_HAS_FADVISE 1
+#endif
+
+using namespace db25;
+using namespace db25::bench;
+
+struct Options {
+    std::string corpus = "test/sql_test.sqls";
+    std::string directory;  // Empty = a fresh directory under the system temp path
+    std::string json_path;
+    size_t files = 64;
+    size_t file_size = size_t{1} << 20;
+    size_t reads_in_flight = 8;
+    size_t workers = 0;     // 0 = hardware threads
+    size_t repetitions = 3;
+    size_t script_size = size_t{16} << 20;
+    bool cold = false;
+};
+
+struct Result {
+    std::string mode;
+    std::string backend;    // As resolved by the pipeline
+    double seconds;
+    uint64_t bytes;
+    uint64_t tokens;
+    double speedup;
+};
+
+void print_usage(const char* program) {
+    std::cout << "Usage: " << program << " [options]\n"
+              << "  --corpus PATH       SQL corpus (default: test/sql_test.sqls)\n"
+              << "  --dir PATH          Directory for the generated files (default: temp)\n"
+              << "  --files N           Number of files (default: 64)\n"
+              << "  --file-size SIZE    Bytes per file (default: 1M)\n"
+              << "  --reads N           Reads in flight (default: 8)\n"
+              << "  --workers N         Tokenizing threads (default: hardware threads)\n"
+              << "  --repetitions N     Runs per mode, best reported (default: 3)\n"
+              << "  --script-size SIZE  In-memory script for the parser pipeline (default: 16M)\n"
+              << "  --cold              Drop the files from the page cache before each run\n"
+              << "  --json PATH         Write results as JSON\n";
+}
+
+bool parse_options(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-h" || arg == "--help") {
+            print_usage(argv[0]);
+            return false;
+        }
+        if (arg == "--cold") {
+            options.cold = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Error: Missing value for " << arg << "\n";
+            return false;
+        }
+        std::string value = argv[++i];
+
+        if (arg == "--corpus") {
+            options.corpus = value;
+        } else if (arg == "--dir") {
+            options.directory = value;
+        } else if (arg == "--json") {
+            options.json_path = value;
+        } else if (arg == "--files" || arg == "--file-size" || arg == "--reads" || arg == "--workers" ||
+                   arg == "--repetitions" || arg == "--script-size") {
+            auto parsed = parse_size(value);
+            if (!parsed || (*parsed == 0 && arg != "--workers")) {
+                std::cerr << "Error: Invalid value for " << arg << ": " << value << "\n";
+                return false;
+            }
+            if (arg == "--files") options.files = *parsed;
+            if (arg == "--file-size") options.file_size = *parsed;
+            if (arg == "--reads") options.reads_in_flight = *parsed;
+            if (arg == "--workers") options.workers = *parsed;
+            if (arg == "--repetitions") options.repetitions = *parsed;
+            if (arg == "--script-size") options.script_size = *parsed;
+        } else {
+            std::cerr << "Error: Unknown option " << arg << "\n";
+            print_usage(argv[0]);
+            return false;
+        }
+    }
+    return true;
+}
+
+// False where dropping cached pages is not supported
+bool drop_from_page_cache(const std::vector<std::filesystem::path>& files) {
+#ifdef DB25_HAS_FADVISE
+    bool ok = true;
+    for (const auto& path : files) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        ok = ok && fd >= 0 && ::fdatasync(fd) == 0 && ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED) == 0;
+        if (fd >= 0) ::close(fd);
+    }
+    return ok;
+#else
+    (void)files;
+    return false;
+#endif
+}
+
+// One run; bytes and tokens summed over the files
+struct Run {
+    double seconds = 0;
+    uint64_t bytes = 0;
+    uint64_t tokens = 0;
+    std::string backend;
+};
+
+Run run_sequential(const std::vector<std::filesystem::path>& files) {
+    Run run{0, 0, 0, "-"};
+    double start = now_ns();
+    std::string text;
+    for (const auto& path : files) {
+        std::ifstream in(path, std::ios::binary);
+        text.resize(std::filesystem::file_size(path));
+        in.read(text.data(), static_cast<std::streamsize>(text.size()));
+        TokenBuffer tokens = TokenBuffer::tokenize(text);
+        do_not_optimize(tokens.size());
+        run.bytes += text.size();
+        run.tokens += tokens.size();
+    }
+    run.seconds = (now_ns() - start) / 1e9;
+    return run;
+}
+
+std::optional<Run> run_pipeline(const std::vector<std::filesystem::path>& files, IoBackend backend,
+                                const Options& options) {
+    FilePipelineOptions pipeline_options;
+    pipeline_options.backend = backend;
+    pipeline_options.reads_in_flight = options.reads_in_flight;
+    pipeline_options.workers = options.workers;
+
+    Run run;
+    double start = now_ns();
+    FilePipeline pipeline(files, pipeline_options);
+    while (auto file = pipeline.next()) {
+        if (file->error) {
+            std::cerr << "Error: Cannot read " << file->path << ": " << file->error.message() << "\n";
+            return std::nullopt;
+        }
+        run.bytes += file->tokens.input().size();
+        run.tokens += file->tokens.size();
+    }
+    run.seconds = (now_ns() - start) / 1e9;
+    run.backend = io_backend_name(pipeline.backend());
+    return run;
+}
+
+// Parser stand-in: touches every token and its text, as a parser building
+// an AST would
+struct ParseState {
+    uint64_t hash = 14695981039346656037ULL;
+    uint64_t statements = 0;
+    int64_t depth = 0;
+    uint64_t tokens = 0;
+
+    void feed(std::span<const Token> block) {
+        for (const Token& token : block) {
+            if (token.type == TokenType::Delimiter) {
+                depth += token.value == "(" ? 1 : token.value == ")" ? -1 : 0;
+                statements += token.value == ";";
+            }
+            for (char c : token.value) {
+                hash = (hash ^ static_cast<uint8_t>(c)) * 1099511628211ULL;
+            }
+            hash ^= static_cast<uint64_t>(token.keyword_id);
+        }
+        tokens += block.size();
+    }
+};
+
+Run run_script(const std::string& script, bool pipelined) {
+    Run run{0, script.size(), 0, "-"};
+    ParseState state;
+    double start = now_ns();
+    if (pipelined) {
+        TokenPipeline pipeline(script);
+        for (auto block = pipeline.next(); !block.empty(); block = pipeline.next()) {
+            state.feed(block);
+        }
+    } else {
+        SimdTokenizer tokenizer(reinterpret_cast<const std::byte*>(script.data()), script.size());
+        std::vector<Token> tokens = tokenizer.tokenize();
+        state.feed(tokens);
+    }
+    run.seconds = (now_ns() - start) / 1e9;
+    do_not_optimize(state.hash);
+    run.tokens = state.tokens;
+    return run;
+}
+
+void print_result(const Result& result) {
+    std::cout << std::left << std::setw(18) << result.mode
+              << std::setw(10) << result.backend
+              << std::right << std::fixed << std::setprecision(2)
+              << std::setw(12) << result.seconds * 1e3
+              << std::setprecision(1)
+              << std::setw(12) << static_cast<double>(result.bytes) / result.seconds / 1e6
+              << std::setw(14) << static_cast<double>(result.tokens) / result.seconds / 1e6
+              << std::setprecision(2)
+              << std::setw(10) << result.speedup << "\n";
+}
+
+std::string to_json(const std::vector<Result>& results, const Options& options) {
+    JsonWriter json;
+    json.begin_object()
+        .field("benchmark", "bench_pipeline")
+        .field("simd_level", CpuDetection::level_name(CpuDetection::configured_level()))
+        .field("build", build_description())
+        .field("hardware_threads", uint64_t{std::thread::hardware_concurrency()})
+        .field("files", uint64_t{options.files})
+        .field("file_size", uint64_t{options.file_size})
+        .field("reads_in_flight", uint64_t{options.reads_in_flight})
+        .field("cold", options.cold)
+        .field("script_size", uint64_t{options.script_size})
+        .begin_array("results");
+    for (const auto& result : results) {
+        json.begin_object()
+            .field("mode", result.mode)
+            .field("backend", result.backend)
+            .field("seconds", result.seconds)
+            .field("bytes", result.bytes)
+            .field("tokens", result.tokens)
+            .field("mb_per_s", static_cast<double>(result.bytes) / result.seconds / 1e6)
+            .field("speedup", result.speedup)
+            .end_object();
+    }
+    json.end_array().end_object();
+    return json.str();
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parse_options(argc, argv, options)) {
+        return argc > 1 && (std::string(argv[1]) == "-h" || std::string(argv[1]) == "--help") ? 0 : 1;
+    }
+
+    auto corpus = load_corpus(options.corpus);
+    if (!corpus) {
+        std::cerr << "Error: Cannot load corpus: " << options.corpus << "\n";
+        return 1;
+    }
+
+    bool temporary = options.directory.empty();
+    std::filesystem::path directory = options.directory;
+    if (temporary) {
+        auto stamp = std::chrono::steady_clock::now().time_since_epoch().count();
+        directory = std::filesystem::temp_directory_path() / ("db25_bench_pipeline_" + std::to_string(stamp));
+    }
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    if (error) {
+        std::cerr << "Error: Cannot create " << directory << ": " << error.message() << "\n";
+        return 1;
+    }
+
+    // Different text per file, so no two files share a page cache entry
+    const auto& queries = corpus->at("ALL");
+    std::vector<std::filesystem::path> files;
+    for (size_t i = 0; i < options.files; ++i) {
+        std::vector<std::string> rotated(queries.begin() + static_cast<std::ptrdiff_t>(i % queries.size()),
+                                         queries.end());
+        rotated.insert(rotated.end(), queries.begin(),
+                       queries.begin() + static_cast<std::ptrdiff_t>(i % queries.size()));
+        files.push_back(directory / ("bench" + std::to_string(i) + ".sql"));
+        std::ofstream out(files.back(), std::ios::binary | std::ios::trunc);
+        out << synthesize_input(rotated, options.file_size);
+        if (!out) {
+            std::cerr << "Error: Cannot write " << files.back() << "\n";
+            return 1;
+        }
+    }
+
+    std::cout << "DB25 Tokenizer File Pipeline Benchmark\n";
+    std::cout << "======================================\n";
+    std::cout << "SIMD level:  " << CpuDetection::level_name(CpuDetection::configured_level())
+              << (CpuDetection::configured_level() == CpuDetection::detect() ? " (detected)" : " (DB25_SIMD_LEVEL)")
+              << "\n";
+    std::cout << "Build:       " << build_description() << "\n";
+    std::cout << "Hardware:    " << std::thread::hardware_concurrency() << " threads\n";
+    std::cout << "Files:       " << options.files << " x " << format_size(options.file_size) << " in "
+              << directory.string() << "\n";
+    std::cout << "Page cache:  " << (options.cold ? "dropped before each run" : "warm") << "\n\n";
+
+    std::cout << std::left << std::setw(18) << "Mode"
+              << std::setw(10) << "Backend"
+              << std::right << std::setw(12) << "ms"
+              << std::setw(12) << "MB/s"
+              << std::setw(14) << "Mtokens/s"
+              << std::setw(10) << "Speedup" << "\n";
+    std::cout << std::string(76, '-') << "\n";
+
+    struct Mode {
+        const char* name;
+        std::optional<IoBackend> backend;   // nullopt = sequential
+    };
+    const Mode modes[] = {{"sequential", std::nullopt},
+                          {"threads", IoBackend::Threads},
+                          {"io_uring", IoBackend::IoUring}};
+
+    std::vector<Result> results;
+    bool cache_dropped = true;
+    bool failed = false;
+    double sequential = 0;
+    for (const Mode& mode : modes) {
+        std::optional<Run> best;
+        for (size_t r = 0; r < options.repetitions && !failed; ++r) {
+            if (options.cold) {
+                cache_dropped = drop_from_page_cache(files) && cache_dropped;
+            }
+            std::optional<Run> run = mode.backend ? run_pipeline(files, *mode.backend, options)
+                                                  : std::optional<Run>(run_sequential(files));
+            if (!run) {
+                failed = true;
+            } else if (!best || run->seconds < best->seconds) {
+                best = run;
+            }
+        }
+        if (failed) {
+            break;
+        }
+        if (!mode.backend) {
+            sequential = best->seconds;
+        }
+        Result result{mode.name, best->backend, best->seconds, best->bytes, best->tokens,
+                      sequential > 0 ? sequential / best->seconds : 0};
+        print_result(result);
+        results.push_back(result);
+    }
+
+    if (temporary) {
+        std::filesystem::remove_all(directory, error);
+    }
+    if (failed) {
+        return 1;
+    }
+
+    std::string script = synthesize_input(queries, options.script_size);
+    std::cout << "\nScript:      " << format_size(script.size()) << " in memory, tokenizer -> parser\n";
+    std::cout << std::string(76, '-') << "\n";
+    double script_sequential = 0;
+    for (bool pipelined : {false, true}) {
+        Run best = run_script(script, pipelined);
+        for (size_t r = 1; r < options.repetitions; ++r) {
+            Run run = run_script(script, pipelined);
+            best = run.seconds < best.seconds ? run : best;
+        }
+        if (!pipelined) {
+            script_sequential = best.seconds;
+        }
+        Result result{pipelined ? "script-pipelined" : "script-sequential", best.backend, best.seconds,
+                      best.bytes, best.tokens, script_sequential / best.seconds};
+        print_result(result);
+        results.push_back(result);
+    }
+    if (options.cold && !cache_dropped) {
+        std::cout << "\nNote: the page cache could not be dropped; timings are warm\n";
+    }
+
+    if (!options.json_path.empty()) {
+        std::ofstream out(options.json_path);
+        if (!out) {
+            std::cerr << "Error: Cannot write " << options.json_path << "\n";
+            return 1;
+        }
+        out << to_json(results, options) << "\n";
+        std::cout << "\nResults written to " << options.json_path << "\n";
+    }
+
+    std::cout << "\n✅ File pipeline benchmark complete (" << results.size() << " modes).\n";
+    return 0;
+}
@@ -0,0 +1,382 @@
+/*
+ * Copyright (c) 2024 Chiradip Mandal
+ * Author: Chiradip Mandal
+ * Organization: Space-RF.org
+ *
+ * This file is part of DB25 SQL Tokenizer.
+ *
+ * Licensed under the MIT License. See LICENSE file for details.
+ */
+
+// DB25 SQL Tokenizer - Thread Scaling Benchmark
+// ==============================================
+// Runs 1..N threads, each tokenizing its own copy of the input with its own
+// tokenizers, and reports aggregate throughput, speedup and scaling
+// efficiency (throughput / (threads x single-thread throughput)). Workloads:
+//
+//   short        one tokenizer per corpus query, default constructor:
+//                allocator contention and per-call fixed costs
+//   short-level  the same with an explicit SimdLevel, which goes through
+//                CpuDetection::detect() on every construction
+//   bulk         one large input per thread: memory bandwidth saturation
+//
+// --pin binds thread i to CPU i modulo the hardware threads (Linux). Each pass is wrapped in a
+// DB25_TRACE_SCOPE, so --trace shows the per-thread timeline in
+// ENABLE_TRACING builds.
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "bench_common.hpp"
+#include "simd_tokenizer.hpp"
+
+#if defined(__linux__)
+    #include <pthread.h>
+    #include <sched.h>
+    #define DB25_HAS_AFFINITY 1
+#endif
+
+using namespace db25;
+using namespace db25::bench;
+
+enum class Workload { Short, ShortLevel, Bulk };
+
+constexpr Workload kWorkloads[] = {Workload::Short, Workload::ShortLevel, Workload::Bulk};
+
+const char* workload_name(Workload workload) {
+    switch (workload) {
+        case Workload::Short: return "short";
+        case Workload::ShortLevel: return "short-level";
+        case Workload::Bulk: return "bulk";
+    }
+    return "unknown";
+}
+
+struct Options {
+    std::string corpus = "test/sql_test.sqls";
+    std::string workload;  // Empty = every workload
+    std::string json_path;
+    std::string trace_path;
+    size_t cpus = std::max(1u, std::thread::hardware_concurrency());
+    size_t max_threads = cpus;
+    size_t bulk_size = size_t{8} << 20;
+    double seconds = 1.0;  // Per thread count
+    bool pin = false;
+};
+
+struct Result {
+    Workload workload;
+    size_t threads;
+    double seconds;
+    uint64_t bytes;
+    uint64_t tokens;
+    double speedup;
+    double efficiency;
+};
+
+// Per-thread totals, one cache line each so workers never share one
+struct alignas(64) WorkerTotals {
+    uint64_t bytes = 0;
+    uint64_t tokens = 0;
+};
+
+void print_usage(const char* program) {
+    std::cout << "Usage: " << program << " [options]\n"
+              << "  --corpus PATH       SQL corpus (default: test/sql_test.sqls)\n"
+              << "  --workload NAME     short, short-level or bulk (default: all)\n"
+              << "  --max-threads N     Largest thread count (default: hardware threads)\n"
+              << "  --seconds X         Run time per thread count (default: 1)\n"
+              << "  --bulk-size SIZE    Input per thread for bulk (default: 8M)\n"
+              << "  --pin               Bind thread i to CPU i (mod hardware threads)\n"
+              << "  --json PATH         Write results as JSON\n"
+              << "  --trace PATH        Write a Chrome trace (ENABLE_TRACING builds)\n";
+}
+
+bool parse_options(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-h" || arg == "--help") {
+            print_usage(argv[0]);
+            return false;
+        }
+        if (arg == "--pin") {
+            options.pin = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Error: Missing value for " << arg << "\n";
+            return false;
+        }
+        std::string value = argv[++i];
+
+        if (arg == "--corpus") {
+            options.corpus = value;
+        } else if (arg == "--workload") {
+            auto known = std::find_if(std::begin(kWorkloads), std::end(kWorkloads),
+                                      [&](Workload w) { return value == workload_name(w); });
+            if (known == std::end(kWorkloads)) {
+                std::cerr << "Error: Unknown workload: " << value << "\n";
+                return false;
+            }
+            options.workload = value;
+        } else if (arg == "--json") {
+            options.json_path = value;
+        } else if (arg == "--trace") {
+            if (!kTracingCompiled) {
+                std::cerr << "Error: --trace needs a build configured with -DENABLE_TRACING=ON\n";
+                return false;
+            }
+            options.trace_path = value;
+        } else if (arg == "--seconds") {
+            options.seconds = std::atof(value.c_str());
+            if (options.seconds <= 0) {
+                std::cerr << "Error: Invalid value for --seconds: " << value << "\n";
+                return false;
+            }
+        } else if (arg == "--max-threads" || arg == "--bulk-size") {
+            auto parsed = parse_size(value);
+            if (!parsed || *parsed == 0) {
+                std::cerr << "Error: Invalid value for " << arg << ": " << value << "\n";
+                return false;
+            }
+            if (arg == "--max-threads") options.max_threads = *parsed;
+            if (arg == "--bulk-size") options.bulk_size = *parsed;
+        } else {
+            std::cerr << "Error: Unknown option " << arg << "\n";
+            print_usage(argv[0]);
+            return false;
+        }
+    }
+    return true;
+}
+
+// 1, 2, 4, ... up to and including max
+std::vector<size_t> thread_counts(size_t max) {
+    std::vector<size_t> counts;
+    for (size_t n = 1; n < max; n *= 2) {
+        counts.push_back(n);
+    }
+    counts.push_back(max);
+    return counts;
+}
+
+bool pin_to_cpu(size_t cpu) {
+#ifdef DB25_HAS_AFFINITY
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu % CPU_SETSIZE, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+// One pass over the thread's own inputs
+void tokenize_pass(Workload workload, const std::vector<std::string>& inputs, SimdLevel level,
+                   WorkerTotals& totals) {
+    for (const auto& input : inputs) {
+        auto data = reinterpret_cast<const std::byte*>(input.data());
+        size_t count;
+        if (workload == Workload::ShortLevel) {
+            SimdTokenizer tokenizer(data, input.size(), level);
+            count = tokenizer.tokenize().size();
+        } else {
+            SimdTokenizer tokenizer(data, input.size());
+            count = tokenizer.tokenize().size();
+        }
+        do_not_optimize(count);
+        totals.bytes += input.size();
+        totals.tokens += count;
+    }
+}
+
+Result run(Workload workload, size_t threads, const std::vector<std::string>& queries,
+           const Options& options, std::atomic<size_t>& pin_failures) {
+    std::vector<WorkerTotals> totals(threads);
+    std::atomic<size_t> ready{0};
+    std::atomic<bool> go{false};
+    std::atomic<bool> stop{false};
+    const SimdLevel level = CpuDetection::configured_level();
+
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            if (options.pin && !pin_to_cpu(t % options.cpus)) {
+                pin_failures.fetch_add(1, std::memory_order_relaxed);
+            }
+            // Naming allocates the thread's trace ring, which is never freed;
+            // untraced runs must not pay for it
+            if (kTracingCompiled && !options.trace_path.empty()) {
+                Tracer::set_thread_name("worker " + std::to_string(t));
+            }
+
+            // Private copies, allocated by the thread that reads them
+            std::vector<std::string> inputs;
+            if (workload == Workload::Bulk) {
+                inputs.push_back(synthesize_input(queries, options.bulk_size));
+            } else {
+                inputs = queries;
+            }
+
+            ready.fetch_add(1);
+            while (!go.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            WorkerTotals local;
+            while (!stop.load(std::memory_order_relaxed)) {
+                DB25_TRACE_SCOPE("Pass");
+                tokenize_pass(workload, inputs, level, local);
+            }
+            totals[t] = local;
+        });
+    }
+
+    while (ready.load() < threads) {
+        std::this_thread::yield();
+    }
+    double start = now_ns();
+    go.store(true, std::memory_order_release);
+    std::this_thread::sleep_for(std::chrono::duration<double>(options.seconds));
+    stop.store(true, std::memory_order_relaxed);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    // Workers finish their current pass, so time until the last one is done
+    double elapsed = (now_ns() - start) / 1e9;
+
+    Result result{workload, threads, elapsed, 0, 0, 0, 0};
+    for (const auto& t : totals) {
+        result.bytes += t.bytes;
+        result.tokens += t.tokens;
+    }
+    return result;
+}
+
+double megabytes_per_second(const Result& result) {
+    return static_cast<double>(result.bytes) / result.seconds / 1e6;
+}
+
+void print_result(const Result& result) {
+    std::cout << std::left << std::setw(14) << workload_name(result.workload)
+              << std::right << std::setw(8) << result.threads
+              << std::fixed << std::setprecision(1)
+              << std::setw(12) << megabytes_per_second(result)
+              << std::setw(14) << static_cast<double>(result.tokens) / result.seconds / 1e6
+              << std::setprecision(2)
+              << std::setw(10) << result.speedup
+              << std::setprecision(1)
+              << std::setw(12) << result.efficiency * 100 << "\n";
+}
+
+std::string to_json(const std::vector<Result>& results, const Options& options) {
+    JsonWriter json;
+    json.begin_object()
+        .field("benchmark", "bench_threads")
+        .field("simd_level", CpuDetection::level_name(CpuDetection::configured_level()))
+        .field("build", build_description())
+        .field("hardware_threads", uint64_t{std::thread::hardware_concurrency()})
+        .field("pinned", options.pin)
+        .field("seconds_per_point", options.seconds)
+        .begin_array("results");
+    for (const auto& result : results) {
+        json.begin_object()
+            .field("workload", workload_name(result.workload))
+            .field("threads", uint64_t{result.threads})
+            .field("seconds", result.seconds)
+            .field("bytes", result.bytes)
+            .field("tokens", result.tokens)
+            .field("mb_per_s", megabytes_per_second(result))
+            .field("tokens_per_s", static_cast<double>(result.tokens) / result.seconds)
+            .field("speedup", result.speedup)
+            .field("efficiency", result.efficiency)
+            .end_object();
+    }
+    json.end_array().end_object();
+    return json.str();
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parse_options(argc, argv, options)) {
+        return argc > 1 && (std::string(argv[1]) == "-h" || std::string(argv[1]) == "--help") ? 0 : 1;
+    }
+
+    auto corpus = load_corpus(options.corpus);
+    if (!corpus) {
+        std::cerr << "Error: Cannot load corpus: " << options.corpus << "\n";
+        return 1;
+    }
+    const auto& queries = corpus->at("ALL");
+
+    std::cout << "DB25 Tokenizer Thread Scaling Benchmark\n";
+    std::cout << "=======================================\n";
+    std::cout << "SIMD level:  " << CpuDetection::level_name(CpuDetection::configured_level())
+              << (CpuDetection::configured_level() == CpuDetection::detect() ? " (detected)" : " (DB25_SIMD_LEVEL)")
+              << "\n";
+    std::cout << "Build:       " << build_description() << "\n";
+    std::cout << "Hardware:    " << std::thread::hardware_concurrency() << " threads\n";
+    std::cout << "Pinning:     " << (options.pin ? "thread i on CPU i mod " + std::to_string(options.cpus) : std::string("off")) << "\n";
+    std::cout << "Run time:    " << options.seconds << " s per point\n\n";
+
+    std::cout << std::left << std::setw(14) << "Workload"
+              << std::right << std::setw(8) << "Threads"
+              << std::setw(12) << "MB/s"
+              << std::setw(14) << "Mtokens/s"
+              << std::setw(10) << "Speedup"
+              << std::setw(12) << "Efficiency" << "\n";
+    std::cout << std::string(70, '-') << "\n";
+
+    Tracer::set_enabled(!options.trace_path.empty());
+    std::vector<Result> results;
+    std::atomic<size_t> pin_failures{0};
+    for (Workload workload : kWorkloads) {
+        if (!options.workload.empty() && options.workload != workload_name(workload)) {
+            continue;
+        }
+        double single = 0;
+        for (size_t threads : thread_counts(options.max_threads)) {
+            Result result = run(workload, threads, queries, options, pin_failures);
+            double throughput = megabytes_per_second(result);
+            if (threads == 1) {
+                single = throughput;
+            }
+            result.speedup = single > 0 ? throughput / single : 0;
+            result.efficiency = result.speedup / static_cast<double>(threads);
+            print_result(result);
+            results.push_back(result);
+        }
+    }
+    Tracer::set_enabled(false);
+
+    if (pin_failures.load() > 0) {
+        std::cout << "\nNote: " << pin_failures.load() << " thread(s) could not be pinned\n";
+    }
+
+    if (!options.json_path.empty()) {
+        std::ofstream out(options.json_path);
+        if (!out) {
+            std::cerr << "Error: Cannot write " << options.json_path << "\n";
+            return 1;
+        }
+        out << to_json(results, options) << "\n";
+        std::cout << "\nResults written to " << options.json_path << "\n";
+    }
+
+    if (!options.trace_path.empty()) {
+        if (!Tracer::write_chrome_json(options.trace_path)) {
+            std::cerr << "Error: Cannot write " << options.trace_path << "\n";
+            return 1;
+        }
+        std::cout << "\nTrace written to " << options.trace_path << " (open in ui.perfetto.dev)\n";
+    }
+
+    std::cout << "\n✅ Thread scaling benchmark complete (" << results.size() << " points).\n";
+    return 0;
+}
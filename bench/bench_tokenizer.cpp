@@ -0,0 +1,399 @@
+/*
+ * Copyright (c) 2024 Chiradip Mandal
+ * Author: Chiradip Mandal
+ * Organization: Space-RF.org
+ *
+ * This file is part of DB25 SQL Tokenizer.
+ *
+ * Licensed under the MIT License. See LICENSE file for details.
+ */
+
+// DB25 SQL Tokenizer - Throughput Benchmark
+// ==========================================
+// Measures MB/s and tokens/s per complexity level of sql_test.sqls and per
+// input size (64 B up to --max-size, in steps of 4x). Each configuration is
+// warmed up, then sampled --repetitions times; median, p99 and coefficient
+// of variation are reported, optionally as JSON for tracking over time.
+// Every SIMD level the host supports is measured unless --simd-level pins one.
+// Where Linux perf counters are accessible, cycles/byte, instructions/byte,
+// IPC and branch misses per token are reported for each configuration.
+// --exact measures tokenize_exact() (count, allocate once, fill) instead of
+// tokenize(). Allocations per call are reported by bench_memory, which does
+// not time anything.
+// With --trace (requires -DENABLE_TRACING=ON) the timed runs are traced and
+// dumped as Chrome trace-event JSON for Perfetto.
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "bench_common.hpp"
+#include "perf_counters.hpp"
+#include "simd_tokenizer.hpp"
+
+using namespace db25;
+using namespace db25::bench;
+
+struct Options {
+    std::string corpus = "test/sql_test.sqls";
+    std::string level;        // Empty = every level
+    std::vector<SimdLevel> simd_levels = CpuDetection::supported_levels();
+    std::string json_path;
+    std::string trace_path;
+    size_t min_size = 64;
+    size_t max_size = size_t{64} << 20;
+    size_t warmup = 3;
+    size_t repetitions = 20;
+    bool counters = true;
+    bool exact = false;       // tokenize_exact() instead of tokenize()
+};
+
+struct Result {
+    SimdLevel simd_level;
+    std::string level;
+    size_t size;
+    size_t tokens;
+    size_t iterations;   // Tokenizer runs per sample
+    SampleStats stats;   // Nanoseconds per run
+    CounterSample counters;  // Per tokenizer run, when available
+};
+
+// Small inputs are run several times per sample so a sample is long enough
+// to time reliably
+constexpr size_t kMinSampleBytes = size_t{1} << 20;
+
+void print_usage(const char* program) {
+    std::cout << "Usage: " << program << " [options]\n"
+              << "  --corpus PATH       SQL corpus (default: test/sql_test.sqls)\n"
+              << "  --level NAME        SIMPLE, MODERATE, COMPLEX, EXTREME, ALL or any\n"
+              << "                      other --LEVEL of the corpus (e.g. generate_corpus mixes)\n"
+              << "  --simd-level NAME   scalar, sse42, avx2, avx512, avx512vbmi, neon or all (default: all)\n"
+              << "  --min-size SIZE     Smallest input, e.g. 64 (default: 64)\n"
+              << "  --max-size SIZE     Largest input, e.g. 256M or 1G (default: 64M)\n"
+              << "  --warmup N          Untimed runs per configuration (default: 3)\n"
+              << "  --repetitions N     Timed samples per configuration (default: 20)\n"
+              << "  --no-counters       Skip hardware performance counters\n"
+              << "  --exact             Measure tokenize_exact() instead of tokenize()\n"
+              << "  --json PATH         Write results as JSON\n"
+              << "  --trace PATH        Write a Chrome trace of the timed runs (ENABLE_TRACING builds)\n";
+}
+
+bool parse_options(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-h" || arg == "--help") {
+            print_usage(argv[0]);
+            return false;
+        }
+        if (arg == "--no-counters") {
+            options.counters = false;
+            continue;
+        }
+        if (arg == "--exact") {
+            options.exact = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Error: Missing value for " << arg << "\n";
+            return false;
+        }
+        std::string value = argv[++i];
+
+        if (arg == "--corpus") {
+            options.corpus = value;
+        } else if (arg == "--level") {
+            options.level = value;
+        } else if (arg == "--simd-level") {
+            if (value != "all") {
+                auto parsed = CpuDetection::parse_level(value);
+                if (!parsed || !CpuDetection::is_supported(*parsed)) {
+                    std::cerr << "Error: SIMD level not supported on this host: " << value << "\n";
+                    return false;
+                }
+                options.simd_levels = {*parsed};
+            }
+        } else if (arg == "--json") {
+            options.json_path = value;
+        } else if (arg == "--trace") {
+            if (!kTracingCompiled) {
+                std::cerr << "Error: --trace needs a build configured with -DENABLE_TRACING=ON\n";
+                return false;
+            }
+            options.trace_path = value;
+        } else if (arg == "--min-size" || arg == "--max-size" ||
+                   arg == "--warmup" || arg == "--repetitions") {
+            auto parsed = parse_size(value);
+            if (!parsed || (*parsed == 0 && arg != "--warmup")) {
+                std::cerr << "Error: Invalid value for " << arg << ": " << value << "\n";
+                return false;
+            }
+            if (arg == "--min-size") options.min_size = *parsed;
+            if (arg == "--max-size") options.max_size = *parsed;
+            if (arg == "--warmup") options.warmup = *parsed;
+            if (arg == "--repetitions") options.repetitions = *parsed;
+        } else {
+            std::cerr << "Error: Unknown option " << arg << "\n";
+            print_usage(argv[0]);
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t run_tokenizer(const std::string& input, SimdLevel simd_level, bool exact) {
+    SimdTokenizer tokenizer(reinterpret_cast<const std::byte*>(input.data()), input.size(), simd_level);
+    auto tokens = exact ? tokenizer.tokenize_exact() : tokenizer.tokenize();
+    return tokens.size();
+}
+
+Result measure(SimdLevel simd_level, const std::string& level, const std::string& input,
+               const Options& options, PerfCounters* perf) {
+    Result result{simd_level, level, input.size(), run_tokenizer(input, simd_level, options.exact),
+                  std::max<size_t>(1, kMinSampleBytes / input.size()), {}, {}};
+
+    for (size_t i = 0; i < options.warmup; ++i) {
+        do_not_optimize(run_tokenizer(input, simd_level, options.exact));
+    }
+
+    std::vector<double> samples;
+    samples.reserve(options.repetitions);
+    if (perf != nullptr) {
+        perf->start();
+    }
+    Tracer::set_enabled(!options.trace_path.empty());
+    for (size_t r = 0; r < options.repetitions; ++r) {
+        DB25_TRACE_SCOPE("Sample", input.size() * result.iterations);
+        double start = now_ns();
+        for (size_t i = 0; i < result.iterations; ++i) {
+            size_t count = run_tokenizer(input, simd_level, options.exact);
+            do_not_optimize(count);
+        }
+        samples.push_back((now_ns() - start) / static_cast<double>(result.iterations));
+    }
+    Tracer::set_enabled(false);
+    if (perf != nullptr) {
+        result.counters = perf->stop();
+        double runs = static_cast<double>(options.repetitions * result.iterations);
+        for (double& value : result.counters.value) {
+            value /= runs;
+        }
+    }
+
+    result.stats = summarize(std::move(samples));
+    return result;
+}
+
+double megabytes_per_second(const Result& result) {
+    return static_cast<double>(result.size) / result.stats.median * 1e3;
+}
+
+double tokens_per_second(const Result& result) {
+    return static_cast<double>(result.tokens) / result.stats.median * 1e9;
+}
+
+void print_result(const Result& result) {
+    std::cout << std::left << std::setw(14) << CpuDetection::level_name(result.simd_level)
+              << std::setw(12) << result.level
+              << std::right << std::setw(8) << format_size(result.size)
+              << std::setw(12) << result.tokens
+              << std::fixed << std::setprecision(1)
+              << std::setw(12) << megabytes_per_second(result)
+              << std::setw(14) << tokens_per_second(result) / 1e6
+              << std::setprecision(2)
+              << std::setw(14) << result.stats.median / 1e3
+              << std::setw(14) << result.stats.p99 / 1e3
+              << std::setprecision(1)
+              << std::setw(8) << result.stats.cv * 100 << "\n";
+}
+
+// Prints one counter-derived metric, or "-" when its events are missing
+void print_metric(bool available, double value, int precision) {
+    if (available) {
+        std::cout << std::fixed << std::setprecision(precision) << std::setw(12) << value;
+    } else {
+        std::cout << std::setw(12) << "-";
+    }
+}
+
+void print_counters(const Result& result) {
+    const CounterSample& c = result.counters;
+    double bytes = static_cast<double>(result.size);
+    double tokens = static_cast<double>(std::max<size_t>(1, result.tokens));
+
+    std::cout << std::left << std::setw(14) << CpuDetection::level_name(result.simd_level)
+              << std::setw(12) << result.level
+              << std::right << std::setw(8) << format_size(result.size);
+    print_metric(c.has(Counter::Cycles), c.get(Counter::Cycles) / bytes, 2);
+    print_metric(c.has(Counter::Instructions), c.get(Counter::Instructions) / bytes, 2);
+    print_metric(c.has(Counter::Cycles) && c.has(Counter::Instructions),
+                 c.get(Counter::Instructions) / std::max(1.0, c.get(Counter::Cycles)), 2);
+    print_metric(c.has(Counter::BranchMisses), c.get(Counter::BranchMisses) / tokens, 3);
+    print_metric(c.has(Counter::L1DMisses), c.get(Counter::L1DMisses) / bytes * 1024, 2);
+    print_metric(c.has(Counter::Uops), c.get(Counter::Uops) / bytes, 2);
+    std::cout << "\n";
+}
+
+std::string to_json(const std::vector<Result>& results, const Options& options) {
+    JsonWriter json;
+    json.begin_object()
+        .field("benchmark", "bench_tokenizer")
+        .field("detected_simd_level", CpuDetection::level_name())
+        .field("build", build_description())
+        .field("warmup", uint64_t{options.warmup})
+        .field("repetitions", uint64_t{options.repetitions})
+        .field("mode", options.exact ? "exact" : "reserve")
+        .begin_array("results");
+    for (const auto& result : results) {
+        double bytes = static_cast<double>(result.size);
+        json.begin_object()
+            .field("simd_level", CpuDetection::level_name(result.simd_level))
+            .field("level", result.level)
+            .field("size_bytes", uint64_t{result.size})
+            .field("tokens", uint64_t{result.tokens})
+            .field("iterations_per_sample", uint64_t{result.iterations})
+            .field("median_ns", result.stats.median)
+            .field("p99_ns", result.stats.p99)
+            .field("min_ns", result.stats.min)
+            .field("cv", result.stats.cv)
+            .field("mb_per_s", megabytes_per_second(result))
+            .field("tokens_per_s", tokens_per_second(result));
+        const CounterSample& c = result.counters;
+        if (c.has(Counter::Cycles)) {
+            json.field("cycles_per_byte", c.get(Counter::Cycles) / bytes);
+        }
+        if (c.has(Counter::Instructions)) {
+            json.field("instructions_per_byte", c.get(Counter::Instructions) / bytes);
+        }
+        if (c.has(Counter::Cycles) && c.has(Counter::Instructions)) {
+            json.field("ipc", c.get(Counter::Instructions) / std::max(1.0, c.get(Counter::Cycles)));
+        }
+        if (c.has(Counter::BranchMisses)) {
+            json.field("branch_misses_per_token",
+                       c.get(Counter::BranchMisses) / static_cast<double>(std::max<size_t>(1, result.tokens)));
+        }
+        if (c.has(Counter::L1DMisses)) {
+            json.field("l1d_misses_per_byte", c.get(Counter::L1DMisses) / bytes);
+        }
+        if (c.has(Counter::Uops)) {
+            json.field("uops_per_byte", c.get(Counter::Uops) / bytes);
+        }
+        json.end_object();
+    }
+    json.end_array().end_object();
+    return json.str();
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parse_options(argc, argv, options)) {
+        return argc > 1 && (std::string(argv[1]) == "-h" || std::string(argv[1]) == "--help") ? 0 : 1;
+    }
+
+    auto corpus = load_corpus(options.corpus);
+    if (!corpus) {
+        std::cerr << "Error: Cannot load corpus: " << options.corpus << "\n";
+        return 1;
+    }
+
+    std::cout << "DB25 Tokenizer Benchmark\n";
+    std::cout << "========================\n";
+    std::cout << "SIMD level:  " << CpuDetection::level_name() << " (detected)\n";
+    std::cout << "Build:       " << build_description() << "\n";
+    std::cout << "Samples:     " << options.warmup << " warmup + " << options.repetitions << " timed\n";
+    std::cout << "Mode:        " << (options.exact ? "tokenize_exact()" : "tokenize()") << "\n";
+
+    std::unique_ptr<PerfCounters> perf;
+    if (options.counters) {
+        perf = std::make_unique<PerfCounters>();
+        if (!perf->available()) {
+            std::cout << "Counters:    unavailable (" << perf->error() << ")\n";
+            perf.reset();
+        } else {
+            std::cout << "Counters:    enabled\n";
+        }
+    }
+    std::cout << "\n";
+
+    std::cout << std::left << std::setw(14) << "SIMD"
+              << std::setw(12) << "Level"
+              << std::right << std::setw(8) << "Size"
+              << std::setw(12) << "Tokens"
+              << std::setw(12) << "MB/s"
+              << std::setw(14) << "Mtokens/s"
+              << std::setw(14) << "Median (us)"
+              << std::setw(14) << "p99 (us)"
+              << std::setw(8) << "CV %" << "\n";
+    std::cout << std::string(108, '-') << "\n";
+
+    // Known levels first, then any others the corpus defines
+    std::vector<std::string_view> levels(std::begin(kLevels), std::end(kLevels));
+    for (const auto& [name, queries] : *corpus) {
+        if (std::find(levels.begin(), levels.end(), name) == levels.end()) {
+            levels.insert(levels.end() - 1, name);
+        }
+    }
+
+    std::vector<Result> results;
+    for (std::string_view level : levels) {
+        if (!options.level.empty() && options.level != level) {
+            continue;
+        }
+        auto queries = corpus->find(level);
+        if (queries == corpus->end()) {
+            continue;
+        }
+        for (size_t size = options.min_size; size <= options.max_size; size *= 4) {
+            std::string input = synthesize_input(queries->second, size);
+            for (SimdLevel simd_level : options.simd_levels) {
+                results.push_back(measure(simd_level, std::string(level), input, options, perf.get()));
+                print_result(results.back());
+            }
+        }
+    }
+
+    if (results.empty()) {
+        std::cerr << "Error: No benchmark configurations selected\n";
+        return 1;
+    }
+
+    if (perf) {
+        std::cout << "\nHardware counters (per tokenizer run)\n\n";
+        std::cout << std::left << std::setw(14) << "SIMD"
+                  << std::setw(12) << "Level"
+                  << std::right << std::setw(8) << "Size"
+                  << std::setw(12) << "Cycles/B"
+                  << std::setw(12) << "Instr/B"
+                  << std::setw(12) << "IPC"
+                  << std::setw(12) << "BrMiss/tok"
+                  << std::setw(12) << "L1D miss/KB"
+                  << std::setw(12) << "Uops/B" << "\n";
+        std::cout << std::string(106, '-') << "\n";
+        for (const auto& result : results) {
+            print_counters(result);
+        }
+    }
+
+    if (!options.json_path.empty()) {
+        std::ofstream out(options.json_path);
+        if (!out) {
+            std::cerr << "Error: Cannot write " << options.json_path << "\n";
+            return 1;
+        }
+        out << to_json(results, options) << "\n";
+        std::cout << "\nResults written to " << options.json_path << "\n";
+    }
+
+    if (!options.trace_path.empty()) {
+        if (!Tracer::write_chrome_json(options.trace_path)) {
+            std::cerr << "Error: Cannot write " << options.trace_path << "\n";
+            return 1;
+        }
+        std::cout << "\nTrace written to " << options.trace_path << " (open in ui.perfetto.dev)\n";
+    }
+
+    std::cout << "\n✅ Benchmark complete (" << results.size() << " configurations).\n";
+    return 0;
+}
@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2024 Chiradip Mandal
+ * Author: Chiradip Mandal
+ * Organization: Space-RF.org
+ *
+ * This file is part of DB25 SQL Tokenizer.
+ *
+ * Licensed under the MIT License. See LICENSE file for details.
+ */
+
+#pragma once
+
+// ============================================================================
+// Hardware performance counters for benchmarks
+// ============================================================================
+// Reads cycles, instructions, branch misses, L1D read misses and (on Intel)
+// issued uops through Linux perf_event_open around a measured region. The
+// events form one group so they are scheduled together; counts are scaled if
+// the kernel multiplexed the group. Counters that cannot be opened (other
+// OS, perf_event_paranoid, virtual machines, missing PMU events) are simply
+// reported as unavailable.
+// ============================================================================
+
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#if defined(__linux__) && __has_include(<linux/perf_event.h>)
+    #include <linux/perf_event.h>
+    #include <sys/ioctl.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+    #define DB25_HAS_PERF_EVENTS 1
+#endif
+
+#if defined(__x86_64__) && __has_include(<cpuid.h>)
+    #include <cpuid.h>
+#endif
+
+namespace db25::bench {
+
+enum class Counter : uint8_t {
+    Cycles,
+    Instructions,
+    BranchMisses,
+    L1DMisses,
+    Uops,
+    Count
+};
+
+inline constexpr size_t kCounterCount = static_cast<size_t>(Counter::Count);
+
+// Counts for one measured region; `valid[i]` is false for unavailable events
+struct CounterSample {
+    std::array<double, kCounterCount> value{};
+    std::array<bool, kCounterCount> valid{};
+
+    [[nodiscard]] bool has(Counter counter) const {
+        return valid[static_cast<size_t>(counter)];
+    }
+
+    [[nodiscard]] double get(Counter counter) const {
+        return value[static_cast<size_t>(counter)];
+    }
+};
+
+// True on Intel CPUs, whose UOPS_ISSUED.ANY raw encoding is used for uops
+inline bool is_intel_cpu() {
+#if defined(__x86_64__) && __has_include(<cpuid.h>)
+    unsigned int eax, ebx, ecx, edx;
+    if (__get_cpuid(0, &eax, &ebx, &ecx, &edx)) {
+        return ebx == 0x756E6547 && edx == 0x49656E69 && ecx == 0x6C65746E;  // "GenuineIntel"
+    }
+#endif
+    return false;
+}
+
+class PerfCounters {
+private:
+    std::array<int, kCounterCount> fds_;
+    std::array<bool, kCounterCount> open_{};
+    int leader_ = -1;
+    std::string error_;
+
+#ifdef DB25_HAS_PERF_EVENTS
+    static int open_event(uint32_t type, uint64_t config, int group_fd) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = group_fd == -1 ? 1 : 0;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_ID |
+                           PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0));
+    }
+#endif
+
+public:
+    PerfCounters() {
+        fds_.fill(-1);
+#ifdef DB25_HAS_PERF_EVENTS
+        struct EventSpec {
+            uint32_t type;
+            uint64_t config;
+        };
+        constexpr uint64_t l1d_read_miss = PERF_COUNT_HW_CACHE_L1D |
+                                           (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                           (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        const std::array<EventSpec, kCounterCount> events = {{
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+            {PERF_TYPE_HW_CACHE, l1d_read_miss},
+            {PERF_TYPE_RAW, 0x010E},  // UOPS_ISSUED.ANY (Intel)
+        }};
+
+        for (size_t i = 0; i < kCounterCount; ++i) {
+            if (static_cast<Counter>(i) == Counter::Uops && !is_intel_cpu()) {
+                continue;
+            }
+            int fd = open_event(events[i].type, events[i].config, leader_);
+            if (fd < 0) {
+                if (i == 0) {
+                    error_ = std::string("perf_event_open failed: ") + std::strerror(errno);
+                    return;
+                }
+                continue;
+            }
+            fds_[i] = fd;
+            open_[i] = true;
+            if (leader_ == -1) {
+                leader_ = fd;
+            }
+        }
+#else
+        error_ = "perf_event_open is not available on this platform";
+#endif
+    }
+
+    ~PerfCounters() {
+#ifdef DB25_HAS_PERF_EVENTS
+        for (int fd : fds_) {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+#endif
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    [[nodiscard]] bool available() const { return leader_ >= 0; }
+    [[nodiscard]] const std::string& error() const { return error_; }
+
+    void start() {
+#ifdef DB25_HAS_PERF_EVENTS
+        if (available()) {
+            ioctl(leader_, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+            ioctl(leader_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        }
+#endif
+    }
+
+    // Stops counting and returns the counts since start()
+    CounterSample stop() {
+        CounterSample sample;
+#ifdef DB25_HAS_PERF_EVENTS
+        if (!available()) {
+            return sample;
+        }
+        ioctl(leader_, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+        // Layout: nr, time_enabled, time_running, then {value, id} per event
+        std::array<uint64_t, 3 + 2 * kCounterCount> buffer{};
+        if (read(leader_, buffer.data(), sizeof(buffer)) <= 0) {
+            return sample;
+        }
+        uint64_t count = buffer[0];
+        double enabled = static_cast<double>(buffer[1]);
+        double running = static_cast<double>(buffer[2]);
+        double scale = running > 0 ? enabled / running : 0;
+
+        // Group members are reported in the order they were opened
+        size_t slot = 0;
+        for (size_t i = 0; i < kCounterCount && slot < count; ++i) {
+            if (!open_[i]) {
+                continue;
+            }
+            sample.value[i] = static_cast<double>(buffer[3 + 2 * slot]) * scale;
+            sample.valid[i] = scale > 0;
+            ++slot;
+        }
+#endif
+        return sample;
+    }
+};
+
+}  // namespace db25::bench
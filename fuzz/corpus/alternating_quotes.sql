@@ -0,0 +1 @@
+'a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''b''a''
\ No newline at end of file
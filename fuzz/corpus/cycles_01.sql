@@ -0,0 +1 @@
+ e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6e6ab e6ab e6ab e6ab e6`ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6 e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ae6ab ebb e6ab e6ab e6ab e6ab e6ab e6ab e6ab e67b e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6ab e6a e6 e6ab e e
\ No newline at end of file
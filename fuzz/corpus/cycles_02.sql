@@ -0,0 +1 @@
+b e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab eb e6ab e
\ No newline at end of file
@@ -0,0 +1 @@
+ab cd ef gh ij kl ab cd ef gh ij kl ab cd ef gh ij kl ab cd ef gh ij kl ab cd ef gh ij kl ab cd ef gh ij kl ab cd ef gh ij kl ab cd ef gh ij kl ab cd ef gh ij kl ab cd ef gh ij kl ab cd ef gh ij kl ab cd ef gh ij kl ab cd ef gh ij kl ab cd ef gh ij kl ab cd ef gh ij kl ab cd ef gh ij kl ab cd ef gh ij kl ab cd ef gh ij kl ab cd ef gh ij kl ab cd ef gh ij kl ab cd ef gh ij kl ab cd ef gh ij kl ab cd ef gh ij kl ab cd ef gh ij kl ab cd ef gh ij kl ab cd ef gh ij kl ab cd ef gh ij kl ab cd ef gh ij kl ab cd ef gh ij kl ab cd ef gh ij kl ab cd ef gh ij kl ab cd ef gh ij kl ab cd ef gh ij kl ab cd ef gh ij kl ab cd ef gh ij kl ab cd ef gh ij kl ab cd ef gh ij kl ab cd ef gh ij kl ab cd ef gh ij kl ab cd ef gh ij kl ab cd ef gh ij kl ab cd ef gh ij kl ab cd ef gh ij kl ab cd ef gh ij kl ab cd ef gh ij kl ab cd ef gh ij kl ab cd ef gh ij kl ab cd ef gh ij kl ab cd ef gh ij kl ab cd ef gh ij kl ab cd ef gh ij kl ab cd ef gh ij kl ab cd ef gh ij kl ab cd ef gh ij kl ab cd ef gh ij kl ab cd ef gh ij kl ab cd ef gh ij k
\ No newline at end of file
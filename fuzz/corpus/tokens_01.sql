@@ -0,0 +1 @@
+$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$:,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$3,$1,$2,$
\ No newline at end of file
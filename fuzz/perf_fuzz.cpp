@@ -0,0 +1,488 @@
+/*
+ * Copyright (c) 2024 Chiradip Mandal
+ * Author: Chiradip Mandal
+ * Organization: Space-RF.org
+ *
+ * This file is part of DB25 SQL Tokenizer.
+ *
+ * Licensed under the MIT License. See LICENSE file for details.
+ */
+
+// DB25 SQL Tokenizer - Performance Fuzzer
+// ========================================
+// Searches for inputs that make SimdTokenizer::tokenize() expensive, so the
+// cost of tokenizing untrusted SQL can be bounded.
+//
+// Standalone (default build):
+//   perf_fuzz [--metric cycles|tokens] [--iterations N] --output DIR
+//       Evolves a population of inputs, all normalized to --length bytes, by
+//       mutation and splicing, keeping those with the highest cycles/byte
+//       (TSC) or tokens/byte. The worst cases are written to DIR.
+//   perf_fuzz --replay DIR [--max-cycles-per-byte X] [--max-baseline-ratio R]
+//       Regression benchmark: measures every file in DIR against the
+//       cycles/byte of the regular corpus and fails above either bound. The
+//       ratio holds across build types; an absolute bound does not.
+//
+// libFuzzer (-DENABLE_LIBFUZZER=ON with Clang, DB25_LIBFUZZER):
+//   LLVMFuzzerTestOneInput tokenizes each input and aborts, so libFuzzer
+//   saves it, when cycles/byte exceeds DB25_PERF_FUZZ_MAX_CPB.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "bench_common.hpp"
+#include "cycle_clock.hpp"
+#include "simd_tokenizer.hpp"
+
+using namespace db25;
+using namespace db25::bench;
+
+namespace {
+
+struct Cost {
+    size_t bytes = 0;
+    size_t tokens = 0;
+    double cycles_per_byte = 0;  // TSC ticks: reference cycles on x86
+    double tokens_per_byte = 0;
+};
+
+// Fastest of `repetitions` runs, so scheduling noise does not look like cost
+Cost measure(std::string_view input, size_t repetitions) {
+    Cost cost;
+    cost.bytes = input.size();
+    uint64_t best = UINT64_MAX;
+    for (size_t r = 0; r < repetitions; ++r) {
+        uint64_t start = CycleClock::fenced_now();
+        SimdTokenizer tokenizer(reinterpret_cast<const std::byte*>(input.data()), input.size());
+        auto tokens = tokenizer.tokenize();
+        uint64_t end = CycleClock::fenced_now();
+        do_not_optimize(tokens.data());
+        cost.tokens = tokens.size();
+        best = std::min(best, end - start);
+    }
+    double bytes = static_cast<double>(std::max<size_t>(1, input.size()));
+    cost.cycles_per_byte = static_cast<double>(best) / bytes;
+    cost.tokens_per_byte = static_cast<double>(cost.tokens) / bytes;
+    return cost;
+}
+
+}  // namespace
+
+#ifdef DB25_LIBFUZZER
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    static const double max_cpb = [] {
+        const char* value = std::getenv("DB25_PERF_FUZZ_MAX_CPB");
+        return value ? std::atof(value) : 0.0;
+    }();
+
+    std::string_view input(reinterpret_cast<const char*>(data), size);
+    Cost cost = measure(input, 3);
+    // Fixed per-call overhead dominates tiny inputs
+    if (max_cpb > 0 && size >= 256 && cost.cycles_per_byte > max_cpb) {
+        std::cerr << "Slow input: " << cost.cycles_per_byte << " cycles/byte over " << size
+                  << " bytes (bound " << max_cpb << ")\n";
+        std::abort();
+    }
+    return 0;
+}
+
+#else
+
+namespace {
+
+enum class Metric { Cycles, Tokens };
+
+struct Options {
+    Metric metric = Metric::Cycles;
+    std::string output;
+    std::string replay;
+    std::string corpus = "test/sql_test.sqls";
+    size_t length = 1024;
+    size_t iterations = 5000;
+    size_t population = 16;
+    size_t repetitions = 7;
+    uint64_t seed = 41;
+    double max_cycles_per_byte = 0;
+    double max_baseline_ratio = 0;
+};
+
+class Random {
+private:
+    uint64_t state;
+
+public:
+    explicit Random(uint64_t seed) : state(seed) {}
+
+    uint64_t next() {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    // Uniform in [0, n)
+    size_t below(size_t n) {
+        return n == 0 ? 0 : static_cast<size_t>(next() % n);
+    }
+
+    // Uniform in [lo, hi]
+    size_t between(size_t lo, size_t hi) {
+        return lo + below(hi - lo + 1);
+    }
+
+    template<typename T, size_t N>
+    const T& pick(const T (&items)[N]) {
+        return items[below(N)];
+    }
+};
+
+// Bytes the lexer treats specially
+constexpr std::string_view kAlphabet =
+    "abcxyzABCXYZ_0123456789 \t\n\r'\"`[]()<>=!|&^%~:;,.+-*/\\$@#?{}eE";
+
+// Fragments that start or end tokens, or sit on slow paths
+constexpr std::string_view kDictionary[] = {
+    "'", "''", "\"", "\"\"", "`", "[", "]", "--", "/*", "*/", "-- x\n",
+    "E'", "$$", "$a$", "1e", "1.", ".5", "0x", "::", "->>", "<=>", "||",
+    "SELECT", "FROM", "a", "_x", "xyz", "\xC3\xA9", "\xE2\x82\xAC", "\xF0\x9F\x98\x80", "\xFF",
+    "\\", "\\'", " ", "\n", "(", ")", ",", ";", "+", "-",
+};
+
+// Worst-case shapes to start from, next to the regular corpus
+constexpr std::string_view kSeeds[] = {
+    "+-*/%<>=!|&^~",                 // One-byte operators
+    "a b c d e f g h i j k l m n ",  // Short identifiers that miss the keyword table
+    "'a''b''c'''",                   // Alternating quotes
+    "x1 y2 z3 ab cd ef ",
+    "1 2.5 3e4 0x1F .5 ",
+    "/**/--\n/**/",
+    "\xC3\xA9 \xE2\x82\xAC \xF0\x9F\x98\x80 ",
+    "\"a\"\"b\" `c` [d] ",
+    "$1,$2,$3,",
+};
+
+// Repeats (or cuts) `input` to exactly `length` bytes so costs per byte compare
+std::string normalize(std::string input, size_t length) {
+    if (input.empty()) {
+        input.push_back(' ');
+    }
+    std::string out;
+    out.reserve(length);
+    while (out.size() < length) {
+        out.append(input, 0, std::min(input.size(), length - out.size()));
+    }
+    return out;
+}
+
+std::string mutate(std::string input, const std::vector<std::string>& population, Random& random) {
+    size_t steps = random.between(1, 4);
+    for (size_t s = 0; s < steps; ++s) {
+        size_t pos = random.below(input.size() + 1);
+        switch (random.below(7)) {
+            case 0:  // Replace a byte
+                if (!input.empty()) {
+                    input[random.below(input.size())] = kAlphabet[random.below(kAlphabet.size())];
+                }
+                break;
+            case 1:  // Insert a dictionary fragment
+                input.insert(pos, random.pick(kDictionary));
+                break;
+            case 2: {  // Erase a range
+                size_t count = random.between(1, 16);
+                if (pos < input.size()) {
+                    input.erase(pos, count);
+                }
+                break;
+            }
+            case 3: {  // Duplicate a chunk in place
+                if (pos < input.size()) {
+                    std::string chunk = input.substr(pos, random.between(1, 32));
+                    input.insert(pos, chunk);
+                }
+                break;
+            }
+            case 4: {  // Splice in part of another member
+                const std::string& other = population[random.below(population.size())];
+                size_t from = random.below(other.size());
+                input.insert(pos, other.substr(from, random.between(1, 64)));
+                break;
+            }
+            case 5: {  // Tile the input with a short pattern it contains
+                if (!input.empty()) {
+                    size_t from = random.below(input.size());
+                    input = input.substr(from, random.between(1, 12));
+                }
+                break;
+            }
+            default:  // Random byte anywhere, including non-ASCII
+                input.insert(input.begin() + static_cast<std::ptrdiff_t>(pos),
+                             static_cast<char>(random.below(256)));
+                break;
+        }
+    }
+    return input;
+}
+
+void print_usage(const char* program) {
+    std::cout << "Usage: " << program << " [options]\n"
+              << "  --metric NAME               cycles (default) or tokens: quantity per byte to maximize\n"
+              << "  --output DIR                Write the worst inputs found to DIR\n"
+              << "  --iterations N              Mutations to evaluate (default: 5000)\n"
+              << "  --length N                  Input length every candidate is normalized to (default: 1024)\n"
+              << "  --population N              Worst cases kept (default: 16)\n"
+              << "  --repetitions N             Runs per measurement, fastest counts (default: 7)\n"
+              << "  --seed N                    Random seed (default: 41)\n"
+              << "  --corpus PATH               Seed and baseline corpus (default: test/sql_test.sqls)\n"
+              << "  --replay DIR                Measure the inputs in DIR instead of searching\n"
+              << "  --max-cycles-per-byte X     With --replay: fail when an input exceeds X\n"
+              << "  --max-baseline-ratio R      With --replay: fail when an input exceeds R x baseline\n";
+}
+
+bool parse_options(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-h" || arg == "--help") {
+            print_usage(argv[0]);
+            return false;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Error: Missing value for " << arg << "\n";
+            return false;
+        }
+        std::string value = argv[++i];
+
+        if (arg == "--metric") {
+            if (value != "cycles" && value != "tokens") {
+                std::cerr << "Error: Unknown metric: " << value << "\n";
+                return false;
+            }
+            options.metric = value == "cycles" ? Metric::Cycles : Metric::Tokens;
+        } else if (arg == "--output") {
+            options.output = value;
+        } else if (arg == "--replay") {
+            options.replay = value;
+        } else if (arg == "--corpus") {
+            options.corpus = value;
+        } else if (arg == "--max-cycles-per-byte") {
+            options.max_cycles_per_byte = std::atof(value.c_str());
+        } else if (arg == "--max-baseline-ratio") {
+            options.max_baseline_ratio = std::atof(value.c_str());
+        } else if (arg == "--iterations" || arg == "--length" || arg == "--population" ||
+                   arg == "--repetitions" || arg == "--seed") {
+            auto parsed = parse_size(value);
+            if (!parsed || (*parsed == 0 && arg != "--seed")) {
+                std::cerr << "Error: Invalid value for " << arg << ": " << value << "\n";
+                return false;
+            }
+            if (arg == "--iterations") options.iterations = *parsed;
+            if (arg == "--length") options.length = *parsed;
+            if (arg == "--population") options.population = *parsed;
+            if (arg == "--repetitions") options.repetitions = *parsed;
+            if (arg == "--seed") options.seed = *parsed;
+        } else {
+            std::cerr << "Error: Unknown option " << arg << "\n";
+            print_usage(argv[0]);
+            return false;
+        }
+    }
+    return true;
+}
+
+// Cycles/byte of the regular corpus at the same length, for comparison
+double baseline_cycles_per_byte(const Options& options) {
+    auto corpus = load_corpus(options.corpus);
+    if (!corpus) {
+        return 0;
+    }
+    return measure(synthesize_input(corpus->at("ALL"), options.length), options.repetitions).cycles_per_byte;
+}
+
+std::string printable(std::string_view input, size_t limit = 48) {
+    std::string out;
+    for (char ch : input.substr(0, limit)) {
+        auto byte = static_cast<unsigned char>(ch);
+        out += (byte >= 0x20 && byte < 0x7F) ? ch : '.';
+    }
+    return out;
+}
+
+int replay(const Options& options) {
+    namespace fs = std::filesystem;
+    std::error_code error;
+    std::vector<fs::path> files;
+    for (const auto& entry : fs::directory_iterator(options.replay, error)) {
+        if (entry.is_regular_file()) {
+            files.push_back(entry.path());
+        }
+    }
+    if (error || files.empty()) {
+        std::cerr << "Error: No inputs in " << options.replay << "\n";
+        return 1;
+    }
+    std::sort(files.begin(), files.end());
+
+    double baseline = baseline_cycles_per_byte(options);
+    if (options.max_baseline_ratio > 0 && baseline <= 0) {
+        std::cerr << "Error: --max-baseline-ratio needs the corpus " << options.corpus << "\n";
+        return 1;
+    }
+    std::cout << "Baseline:    " << std::fixed << std::setprecision(2) << baseline
+              << " cycles/byte (" << options.corpus << ")\n\n";
+    std::cout << std::left << std::setw(24) << "Input"
+              << std::right << std::setw(8) << "Bytes"
+              << std::setw(10) << "Tokens/B"
+              << std::setw(12) << "Cycles/B"
+              << std::setw(12) << "x Baseline" << "\n";
+    std::cout << std::string(66, '-') << "\n";
+
+    double worst = 0;
+    for (const auto& path : files) {
+        std::ifstream file(path, std::ios::binary);
+        std::string input((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        Cost cost = measure(input, options.repetitions);
+        worst = std::max(worst, cost.cycles_per_byte);
+        std::cout << std::left << std::setw(24) << path.filename().string()
+                  << std::right << std::setw(8) << cost.bytes
+                  << std::fixed << std::setprecision(3) << std::setw(10) << cost.tokens_per_byte
+                  << std::setprecision(2) << std::setw(12) << cost.cycles_per_byte
+                  << std::setw(12) << (baseline > 0 ? cost.cycles_per_byte / baseline : 0) << "\n";
+    }
+
+    std::cout << "\nWorst:       " << worst << " cycles/byte\n";
+    if (options.max_cycles_per_byte > 0 && worst > options.max_cycles_per_byte) {
+        std::cout << "Bound of " << options.max_cycles_per_byte << " cycles/byte exceeded: FAIL\n";
+        return 1;
+    }
+    if (options.max_baseline_ratio > 0 && worst > options.max_baseline_ratio * baseline) {
+        std::cout << "Bound of " << options.max_baseline_ratio << " x baseline exceeded: FAIL\n";
+        return 1;
+    }
+    std::cout << "\n✅ Replay complete (" << files.size() << " inputs).\n";
+    return 0;
+}
+
+int search(const Options& options) {
+    Random random(options.seed);
+    auto score = [&](const Cost& cost) {
+        return options.metric == Metric::Cycles ? cost.cycles_per_byte : cost.tokens_per_byte;
+    };
+
+    struct Entry {
+        std::string input;
+        double score;
+    };
+    std::vector<Entry> population;
+    auto consider = [&](std::string input) {
+        Entry entry{normalize(std::move(input), options.length), 0};
+        entry.score = score(measure(entry.input, options.repetitions));
+        if (population.size() < options.population) {
+            population.push_back(std::move(entry));
+            return true;
+        }
+        auto weakest = std::min_element(population.begin(), population.end(),
+                                        [](const Entry& a, const Entry& b) { return a.score < b.score; });
+        if (entry.score > weakest->score) {
+            *weakest = std::move(entry);
+            return true;
+        }
+        return false;
+    };
+
+    for (std::string_view seed : kSeeds) {
+        consider(std::string(seed));
+    }
+    if (auto corpus = load_corpus(options.corpus)) {
+        for (const auto& sql : corpus->at("ALL")) {
+            consider(sql);
+        }
+    }
+
+    double baseline = baseline_cycles_per_byte(options);
+    const char* unit = options.metric == Metric::Cycles ? "cycles/byte" : "tokens/byte";
+    std::cout << "Baseline:    " << std::fixed << std::setprecision(2) << baseline << " cycles/byte\n";
+    std::cout << "Searching:   " << options.iterations << " mutations, maximizing " << unit << "\n\n";
+
+    size_t improvements = 0;
+    std::vector<std::string> inputs;
+    for (size_t i = 0; i < options.iterations; ++i) {
+        // Tournament of two, favouring the costlier parent
+        const Entry& a = population[random.below(population.size())];
+        const Entry& b = population[random.below(population.size())];
+        const std::string& parent = a.score >= b.score ? a.input : b.input;
+        inputs.clear();
+        for (const auto& entry : population) {
+            inputs.push_back(entry.input);
+        }
+        improvements += consider(mutate(parent, inputs, random));
+
+        if ((i + 1) % 1000 == 0 || i + 1 == options.iterations) {
+            auto best = std::max_element(population.begin(), population.end(),
+                                         [](const Entry& x, const Entry& y) { return x.score < y.score; });
+            std::cout << "  " << std::setw(8) << i + 1 << " mutations, best " << std::setprecision(3)
+                      << best->score << " " << unit << "\n";
+        }
+    }
+
+    std::sort(population.begin(), population.end(),
+              [](const Entry& a, const Entry& b) { return a.score > b.score; });
+    std::cout << "\n" << std::left << std::setw(6) << "Rank" << std::setw(52) << "Input (start)"
+              << std::right << std::setw(10) << "Tokens/B" << std::setw(12) << "Cycles/B" << "\n";
+    std::cout << std::string(80, '-') << "\n";
+    for (size_t i = 0; i < population.size(); ++i) {
+        Cost cost = measure(population[i].input, options.repetitions);
+        std::cout << std::left << std::setw(6) << i + 1 << std::setw(52) << printable(population[i].input)
+                  << std::right << std::setprecision(3) << std::setw(10) << cost.tokens_per_byte
+                  << std::setprecision(2) << std::setw(12) << cost.cycles_per_byte << "\n";
+    }
+
+    if (!options.output.empty()) {
+        namespace fs = std::filesystem;
+        std::error_code error;
+        fs::create_directories(options.output, error);
+        const char* prefix = options.metric == Metric::Cycles ? "cycles" : "tokens";
+        for (size_t i = 0; i < population.size(); ++i) {
+            char name[32];
+            std::snprintf(name, sizeof(name), "%s_%02zu.sql", prefix, i + 1);
+            std::ofstream file(fs::path(options.output) / name, std::ios::binary);
+            file << population[i].input;
+            if (!file) {
+                std::cerr << "Error: Cannot write " << (fs::path(options.output) / name).string() << "\n";
+                return 1;
+            }
+        }
+        std::cout << "\nWorst cases written to " << options.output << "\n";
+    }
+
+    std::cout << "\n✅ Search complete (" << improvements << " improvements).\n";
+    return 0;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parse_options(argc, argv, options)) {
+        return argc > 1 && (std::string(argv[1]) == "-h" || std::string(argv[1]) == "--help") ? 0 : 1;
+    }
+
+    std::cout << "DB25 Tokenizer Performance Fuzzer\n";
+    std::cout << "=================================\n";
+    std::cout << "SIMD level:  " << CpuDetection::level_name(CpuDetection::configured_level())
+              << (CpuDetection::configured_level() == CpuDetection::detect() ? " (detected)" : " (DB25_SIMD_LEVEL)")
+              << "\n";
+    std::cout << "Build:       " << build_description() << "\n";
+
+    return options.replay.empty() ? search(options) : replay(options);
+}
+
+#endif
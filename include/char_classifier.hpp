@@ -100,7 +100,7 @@ alignas(64) inline constexpr uint8_t char_lookup_table[256] = {
     CHAR_OPERATOR,    // ~
     0,                // DEL
 
-    // 0x80 - 0xFF: Extended ASCII (not used in SQL)
+    // 0x80 - 0xFF: UTF-8 lead/continuation bytes (see is_non_ascii)
     0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
     0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
     0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
@@ -140,4 +140,10 @@ inline bool is_quote(uint8_t ch) {
     return (char_lookup_table[ch] & CHAR_QUOTE) != 0;
 }
 
+// Bytes of multi-byte UTF-8 sequences; these continue identifiers and are
+// validated as a whole once the token has been delimited.
+inline bool is_non_ascii(uint8_t ch) {
+    return ch >= 0x80;
+}
+
 }  // namespace db25
\ No newline at end of file
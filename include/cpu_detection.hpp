@@ -11,8 +11,12 @@
 #pragma once
 
 #include <cstdint>
+#include <cstdlib>
 #include <atomic>
 #include <bit>
+#include <optional>
+#include <string_view>
+#include <vector>
 
 #if defined(__x86_64__) || defined(_M_X64)
     #include <immintrin.h>
@@ -31,107 +35,193 @@
 
 namespace db25 {
 
+// AVX512_VBMI is numbered after NEON so existing values stay stable; use
+// CpuDetection::tier() rather than comparing levels directly.
 enum class SimdLevel : uint8_t {
     None = 0,
     SSE42 = 1,
     AVX2 = 2,
     AVX512 = 3,
-    NEON = 4
+    NEON = 4,
+    AVX512_VBMI = 5  // AVX-512 plus VBMI, VBMI2 and BMI2 (Ice Lake, Zen 4 and later)
+};
+
+// The AVX512_VBMI processor is compiled only when the target enables every
+// extension it uses (e.g. -march=native on a host that has them)
+#if (defined(__x86_64__) || defined(_M_X64)) && defined(__AVX512VBMI__) && \
+    defined(__AVX512VBMI2__) && defined(__BMI2__)
+    #define DB25_HAS_AVX512_VBMI 1
+    inline constexpr bool kAvx512VbmiCompiled = true;
+#else
+    inline constexpr bool kAvx512VbmiCompiled = false;
+#endif
+
+// Raw CPUID feature bits relevant to the processors
+struct CpuFeatures {
+    bool sse42 = false;
+    bool avx2 = false;
+    bool bmi2 = false;
+    bool avx512f = false;
+    bool avx512bw = false;
+    bool avx512vl = false;
+    bool avx512vbmi = false;
+    bool avx512vbmi2 = false;
+    uint8_t avx10_version = 0;  // 0 when AVX10 is not enumerated
+    bool avx10_512 = false;     // AVX10 with 512-bit vectors
+    
+    // AVX10/512 implies the AVX-512 subsets used here
+    [[nodiscard]] bool avx512() const noexcept {
+        return (avx512f && avx512bw && avx512vl) || avx10_512;
+    }
+    
+    [[nodiscard]] bool avx512_vbmi() const noexcept {
+        return avx512() && ((avx512vbmi && avx512vbmi2) || avx10_512) && bmi2;
+    }
 };
 
 class CpuDetection {
 private:
-    static std::atomic<SimdLevel> detected_level_;
-    static std::atomic<bool> detection_done_;
+    static constexpr SimdLevel kUndetected = static_cast<SimdLevel>(0xFF);
+
+    // Written once, then only read by every tokenizer construction: padded
+    // to a cache line of its own so it never shares one with written data
+    struct alignas(64) DetectedLevel {
+        std::atomic<SimdLevel> value{kUndetected};
+    };
+    static DetectedLevel detected_level_;
     
-    static void detect_x86_features() noexcept {
+    // CPUID leaf/subleaf into eax, ebx, ecx, edx; false if the leaf is absent
+    static bool cpuid([[maybe_unused]] unsigned leaf, [[maybe_unused]] unsigned subleaf,
+                      unsigned (&regs)[4]) noexcept {
         #if defined(__x86_64__) || defined(_M_X64)
-        SimdLevel level = SimdLevel::None;
-        
         #ifdef __GNUC__
-        unsigned int eax, ebx, ecx, edx;
-        
-        // Check for SSE4.2
-        if (__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
-            if (ecx & bit_SSE4_2) {
-                level = SimdLevel::SSE42;
-            }
+        return __get_cpuid_count(leaf, subleaf, &regs[0], &regs[1], &regs[2], &regs[3]) != 0;
+        #elif defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, static_cast<int>(leaf & 0x80000000U));
+        if (static_cast<unsigned>(info[0]) < leaf) {
+            return false;
         }
-        
-        // Check for AVX2
-        if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
-            if (ebx & bit_AVX2) {
-                level = SimdLevel::AVX2;
-            }
-            
-            // Check for AVX-512
-            if (ebx & bit_AVX512F && ebx & bit_AVX512BW && ebx & bit_AVX512VL) {
-                level = SimdLevel::AVX512;
-            }
+        __cpuidex(info, static_cast<int>(leaf), static_cast<int>(subleaf));
+        for (int i = 0; i < 4; ++i) {
+            regs[i] = static_cast<unsigned>(info[i]);
         }
-        #elif defined(_MSC_VER)
-        int cpuInfo[4];
+        return true;
+        #endif
+        #endif
+        regs[0] = regs[1] = regs[2] = regs[3] = 0;
+        return false;
+    }
+    
+    [[nodiscard]] static CpuFeatures read_x86_features() noexcept {
+        CpuFeatures features;
+        unsigned regs[4];
+        enum { EAX, EBX, ECX, EDX };
         
-        // Check for SSE4.2
-        __cpuid(cpuInfo, 1);
-        if (cpuInfo[2] & (1 << 20)) {
-            level = SimdLevel::SSE42;
+        if (cpuid(1, 0, regs)) {
+            features.sse42 = regs[ECX] & (1U << 20);
         }
         
-        // Check for AVX2
-        __cpuidex(cpuInfo, 7, 0);
-        if (cpuInfo[1] & (1 << 5)) {
-            level = SimdLevel::AVX2;
+        if (cpuid(7, 0, regs)) {
+            features.avx2 = regs[EBX] & (1U << 5);
+            features.bmi2 = regs[EBX] & (1U << 8);
+            features.avx512f = regs[EBX] & (1U << 16);
+            features.avx512bw = regs[EBX] & (1U << 30);
+            features.avx512vl = regs[EBX] & (1U << 31);
+            features.avx512vbmi = regs[ECX] & (1U << 1);
+            features.avx512vbmi2 = regs[ECX] & (1U << 6);
         }
         
-        // Check for AVX-512
-        if ((cpuInfo[1] & (1 << 16)) && (cpuInfo[1] & (1 << 30)) && (cpuInfo[1] & (1 << 31))) {
-            level = SimdLevel::AVX512;
+        // AVX10: CPUID.(7,1):EDX[19], version and vector lengths in leaf 0x24
+        if (cpuid(7, 1, regs) && (regs[EDX] & (1U << 19)) && cpuid(0x24, 0, regs)) {
+            features.avx10_version = static_cast<uint8_t>(regs[EBX] & 0xFF);
+            features.avx10_512 = regs[EBX] & (1U << 18);
         }
+        return features;
+    }
+    
+    [[nodiscard]] static SimdLevel detect_x86_features() noexcept {
+        #if defined(__x86_64__) || defined(_M_X64)
+        const CpuFeatures& cpu = features();
+        if (kAvx512VbmiCompiled && cpu.avx512_vbmi()) return SimdLevel::AVX512_VBMI;
+        if (cpu.avx512()) return SimdLevel::AVX512;
+        if (cpu.avx2) return SimdLevel::AVX2;
+        if (cpu.sse42) return SimdLevel::SSE42;
         #endif
-        
-        detected_level_.store(level, std::memory_order_release);
-        #endif
+        return SimdLevel::None;
     }
     
-    static void detect_arm_features() noexcept {
+    [[nodiscard]] static SimdLevel detect_arm_features() noexcept {
         #if defined(__aarch64__) || defined(_M_ARM64)
-        SimdLevel level = SimdLevel::NEON;
-        detected_level_.store(level, std::memory_order_release);
+        return SimdLevel::NEON;
+        #else
+        return SimdLevel::None;
+        #endif
+    }
+    
+    // Racing first callers compute the same value, so a plain store suffices
+    [[nodiscard]] static SimdLevel detect_slow() noexcept {
+        #if defined(__x86_64__) || defined(_M_X64)
+            SimdLevel level = detect_x86_features();
+        #elif defined(__aarch64__) || defined(_M_ARM64)
+            SimdLevel level = detect_arm_features();
+        #else
+            SimdLevel level = SimdLevel::None;
         #endif
+        detected_level_.value.store(level, std::memory_order_release);
+        return level;
     }
     
 public:
+    // One acquire load (a plain load on x86) once detection has run
     [[nodiscard]] static SimdLevel detect() noexcept {
-        bool expected = false;
-        if (detection_done_.compare_exchange_strong(expected, true, 
-                                                   std::memory_order_acq_rel,
-                                                   std::memory_order_acquire)) {
+        SimdLevel level = detected_level_.value.load(std::memory_order_acquire);
+        if (level != kUndetected) [[likely]] {
+            return level;
+        }
+        return detect_slow();
+    }
+    
+    // CPUID feature bits, read once (all false off x86)
+    [[nodiscard]] static const CpuFeatures& features() noexcept {
+        static const CpuFeatures cpu = [] {
             #if defined(__x86_64__) || defined(_M_X64)
-                detect_x86_features();
-            #elif defined(__aarch64__) || defined(_M_ARM64)
-                detect_arm_features();
+            return read_x86_features();
             #else
-                detected_level_.store(SimdLevel::None, std::memory_order_release);
+            return CpuFeatures{};
             #endif
+        }();
+        return cpu;
+    }
+    
+    // Position of an x86 level in the x86 order (scalar 0 up to AVX-512 VBMI
+    // 4); NEON is not on that ladder and returns -1
+    [[nodiscard]] static constexpr int tier(SimdLevel level) noexcept {
+        switch (level) {
+            case SimdLevel::None: return 0;
+            case SimdLevel::SSE42: return 1;
+            case SimdLevel::AVX2: return 2;
+            case SimdLevel::AVX512: return 3;
+            case SimdLevel::AVX512_VBMI: return 4;
+            case SimdLevel::NEON: return -1;
         }
-        
-        return detected_level_.load(std::memory_order_acquire);
+        return -1;
     }
     
     [[nodiscard]] static bool supports_sse42() noexcept {
-        auto level = detect();
-        return level >= SimdLevel::SSE42;
+        return tier(detect()) >= tier(SimdLevel::SSE42);
     }
     
     [[nodiscard]] static bool supports_avx2() noexcept {
-        auto level = detect();
-        return level >= SimdLevel::AVX2;
+        return tier(detect()) >= tier(SimdLevel::AVX2);
     }
     
     [[nodiscard]] static bool supports_avx512() noexcept {
-        auto level = detect();
-        return level >= SimdLevel::AVX512;
+        return tier(detect()) >= tier(SimdLevel::AVX512);
+    }
+    
+    [[nodiscard]] static bool supports_avx512_vbmi() noexcept {
+        return detect() == SimdLevel::AVX512_VBMI;
     }
     
     [[nodiscard]] static bool supports_neon() noexcept {
@@ -139,19 +229,98 @@ public:
         return level == SimdLevel::NEON;
     }
     
-    [[nodiscard]] static const char* level_name() noexcept {
-        switch (detect()) {
+    [[nodiscard]] static const char* level_name(SimdLevel level) noexcept {
+        switch (level) {
             case SimdLevel::None: return "Scalar";
             case SimdLevel::SSE42: return "SSE4.2";
             case SimdLevel::AVX2: return "AVX2";
             case SimdLevel::AVX512: return "AVX-512";
+            case SimdLevel::AVX512_VBMI: return "AVX-512 VBMI";
             case SimdLevel::NEON: return "ARM NEON";
         }
         return "Unknown";
     }
+    
+    [[nodiscard]] static const char* level_name() noexcept {
+        return level_name(detect());
+    }
+    
+    // Parses a level name as used by DB25_SIMD_LEVEL: scalar, sse42, avx2,
+    // avx512, avx512vbmi or neon (case-insensitive; "sse4.2", "avx-512" and
+    // "avx-512-vbmi" also accepted)
+    [[nodiscard]] static std::optional<SimdLevel> parse_level(std::string_view name) noexcept {
+        char lower[16] = {};
+        if (name.empty() || name.size() >= sizeof(lower)) {
+            return std::nullopt;
+        }
+        for (size_t i = 0; i < name.size(); ++i) {
+            char ch = name[i];
+            lower[i] = (ch >= 'A' && ch <= 'Z') ? static_cast<char>(ch - 'A' + 'a') : ch;
+        }
+        std::string_view text(lower, name.size());
+        
+        if (text == "scalar" || text == "none") return SimdLevel::None;
+        if (text == "sse42" || text == "sse4.2") return SimdLevel::SSE42;
+        if (text == "avx2") return SimdLevel::AVX2;
+        if (text == "avx512" || text == "avx-512") return SimdLevel::AVX512;
+        if (text == "avx512vbmi" || text == "avx-512-vbmi") return SimdLevel::AVX512_VBMI;
+        if (text == "neon") return SimdLevel::NEON;
+        return std::nullopt;
+    }
+    
+    [[nodiscard]] static bool is_supported(SimdLevel level) noexcept {
+        SimdLevel detected = detect();
+        if (level == SimdLevel::None) {
+            return true;
+        }
+        if (level == SimdLevel::NEON || detected == SimdLevel::NEON) {
+            return level == detected;
+        }
+        return tier(level) <= tier(detected);
+    }
+    
+    // Highest supported level not above `requested`, so a request acts as a
+    // cap on hosts that lack it (falls back to scalar at worst)
+    [[nodiscard]] static SimdLevel clamp(SimdLevel requested) noexcept {
+        if (is_supported(requested)) {
+            return requested;
+        }
+        SimdLevel detected = detect();
+        if (requested == SimdLevel::NEON || detected == SimdLevel::NEON) {
+            return SimdLevel::None;
+        }
+        return detected;
+    }
+    
+    // Every level usable on this host, lowest first
+    [[nodiscard]] static std::vector<SimdLevel> supported_levels() {
+        std::vector<SimdLevel> levels;
+        for (SimdLevel level : {SimdLevel::None, SimdLevel::SSE42, SimdLevel::AVX2,
+                                SimdLevel::AVX512, SimdLevel::AVX512_VBMI, SimdLevel::NEON}) {
+            if (is_supported(level)) {
+                levels.push_back(level);
+            }
+        }
+        return levels;
+    }
+    
+    // Level used by default-constructed dispatchers: the detected level,
+    // capped by the DB25_SIMD_LEVEL environment variable when it is set.
+    // The environment is read once per process.
+    [[nodiscard]] static SimdLevel configured_level() noexcept {
+        static const SimdLevel level = [] {
+            const char* requested = std::getenv("DB25_SIMD_LEVEL");
+            if (requested != nullptr) {
+                if (auto parsed = parse_level(requested)) {
+                    return clamp(*parsed);
+                }
+            }
+            return detect();
+        }();
+        return level;
+    }
 };
 
-inline std::atomic<SimdLevel> CpuDetection::detected_level_{SimdLevel::None};
-inline std::atomic<bool> CpuDetection::detection_done_{false};
+inline CpuDetection::DetectedLevel CpuDetection::detected_level_;
 
 }  // namespace db25
\ No newline at end of file
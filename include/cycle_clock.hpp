@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2024 Chiradip Mandal
+ * Author: Chiradip Mandal
+ * Organization: Space-RF.org
+ *
+ * This file is part of DB25 SQL Tokenizer.
+ *
+ * Licensed under the MIT License. See LICENSE file for details.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64)
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+    #else
+        #include <x86intrin.h>
+    #endif
+#endif
+
+namespace db25 {
+
+// Cheapest available timestamp: the TSC on x86-64, the virtual counter on
+// AArch64 and steady_clock nanoseconds elsewhere. Ticks are converted to
+// seconds with a rate calibrated once against steady_clock.
+class CycleClock {
+public:
+    [[nodiscard]] static uint64_t now() noexcept {
+        #if defined(__x86_64__) || defined(_M_X64)
+        return __rdtsc();
+        #elif defined(__aarch64__) && defined(__GNUC__)
+        uint64_t ticks;
+        asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+        return ticks;
+        #else
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+        #endif
+    }
+
+    // now() ordered against surrounding instructions, for timing intervals of
+    // a few hundred cycles where out-of-order execution would blur the edges
+    [[nodiscard]] static uint64_t fenced_now() noexcept {
+        #if defined(__x86_64__) || defined(_M_X64)
+        _mm_lfence();
+        uint64_t ticks = __rdtsc();
+        _mm_lfence();
+        return ticks;
+        #elif defined(__aarch64__) && defined(__GNUC__)
+        uint64_t ticks;
+        asm volatile("isb\n\tmrs %0, cntvct_el0\n\tisb" : "=r"(ticks) : : "memory");
+        return ticks;
+        #else
+        return now();
+        #endif
+    }
+
+    // Ticks per second (calibrated on first use, about 10 ms)
+    [[nodiscard]] static double frequency() noexcept {
+        static const double hz = calibrate();
+        return hz;
+    }
+
+    [[nodiscard]] static double to_seconds(uint64_t ticks) noexcept {
+        return static_cast<double>(ticks) / frequency();
+    }
+
+private:
+    static double calibrate() noexcept {
+        #if defined(__aarch64__) && defined(__GNUC__)
+        uint64_t hz;
+        asm volatile("mrs %0, cntfrq_el0" : "=r"(hz));
+        return static_cast<double>(hz);
+        #elif defined(__x86_64__) || defined(_M_X64)
+        using clock = std::chrono::steady_clock;
+        auto start_time = clock::now();
+        uint64_t start = now();
+        while (clock::now() - start_time < std::chrono::milliseconds(10)) {
+        }
+        uint64_t ticks = now() - start;
+        double seconds = std::chrono::duration<double>(clock::now() - start_time).count();
+        return static_cast<double>(ticks) / seconds;
+        #else
+        return 1e9;
+        #endif
+    }
+};
+
+}  // namespace db25
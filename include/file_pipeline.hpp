@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2024 Chiradip Mandal
+ * Author: Chiradip Mandal
+ * Organization: Space-RF.org
+ *
+ * This file is part of DB25 SQL Tokenizer.
+ *
+ * Licensed under the MIT License. See LICENSE file for details.
+ */
+
+#pragma once
+
+#include "token_buffer.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace db25 {
+
+// One tokenized file
+struct FileTokens {
+    size_t index = 0;               // Position in the pipeline's file list
+    std::filesystem::path path;
+    TokenBuffer tokens;             // Empty if `error` is set
+    std::error_code error;          // From opening or reading the file
+};
+
+enum class IoBackend : uint8_t {
+    Auto,      // io_uring where the kernel allows it, else Threads
+    IoUring,   // Linux io_uring; falls back to Threads if unavailable
+    Threads    // Blocking reads on reader threads
+};
+
+[[nodiscard]] std::string_view io_backend_name(IoBackend backend) noexcept;
+
+struct FilePipelineOptions {
+    IoBackend backend = IoBackend::Auto;
+    size_t reads_in_flight = 8;   // io_uring queue depth, or number of reader threads
+    size_t workers = 0;           // Tokenizing threads; 0 for one per hardware thread
+    size_t max_results = 64;      // Finished files held before workers wait for the consumer
+    // Tokenizer per file, e.g. &TokenBuffer::tokenize<PostgresTokenizer>
+    TokenBuffer (*tokenize)(std::string_view) = &TokenBuffer::tokenize<SimdTokenizer>;
+};
+
+// Reads and tokenizes a list of files concurrently. Reads go into a fixed
+// pool of recycled buffers (reads_in_flight + workers of them); workers
+// tokenize each completed read into a TokenBuffer and return its buffer to
+// the pool while further reads are in flight. A slow consumer holds back the
+// workers (max_results), and busy workers hold back the reads (the pool),
+// so memory stays bounded.
+//
+// Results arrive in completion order, through next() or co_await:
+//
+//     while (auto file = co_await pipeline.next_async()) { ... }
+//
+// A suspended coroutine is resumed on the pipeline thread that finished the
+// file. Only one consumer may wait at a time, and the pipeline must not be
+// destroyed from a coroutine it resumed.
+class FilePipeline {
+public:
+    class NextAwaiter {
+    public:
+        [[nodiscard]] bool await_ready() { return pipeline_.try_next(result_); }
+        [[nodiscard]] bool await_suspend(std::coroutine_handle<> handle) {
+            return pipeline_.suspend(*this, handle);
+        }
+        [[nodiscard]] std::optional<FileTokens> await_resume() { return std::move(result_); }
+
+    private:
+        friend class FilePipeline;
+
+        explicit NextAwaiter(FilePipeline& pipeline) noexcept : pipeline_(pipeline) {}
+
+        FilePipeline& pipeline_;
+        std::optional<FileTokens> result_;
+        std::coroutine_handle<> handle_;
+    };
+
+    explicit FilePipeline(std::vector<std::filesystem::path> files, FilePipelineOptions options = {});
+    // Stops issuing reads, waits for the ones in flight and joins all threads
+    ~FilePipeline();
+
+    FilePipeline(const FilePipeline&) = delete;
+    FilePipeline& operator=(const FilePipeline&) = delete;
+
+    // The next finished file; blocks until one is ready. std::nullopt once
+    // every file has been returned.
+    [[nodiscard]] std::optional<FileTokens> next();
+
+    // As next(), for co_await
+    [[nodiscard]] NextAwaiter next_async() noexcept { return NextAwaiter(*this); }
+
+    // The backend in use, after Auto and fallbacks are resolved
+    [[nodiscard]] IoBackend backend() const noexcept { return backend_; }
+    [[nodiscard]] size_t size() const noexcept { return files_.size(); }
+
+private:
+    static constexpr size_t kNoBuffer = SIZE_MAX;
+
+    struct Buffer {
+        std::unique_ptr<std::byte[]> data;
+        size_t capacity = 0;
+    };
+
+    // A finished read waiting for a worker
+    struct Read {
+        size_t index;
+        size_t buffer;      // kNoBuffer for empty files and errors
+        size_t size;
+        std::error_code error;
+    };
+
+    std::vector<std::filesystem::path> files_;
+    FilePipelineOptions options_;
+    IoBackend backend_ = IoBackend::Threads;
+    std::atomic<bool> stop_{false};
+
+    std::mutex pool_mutex_;
+    std::condition_variable pool_ready_;
+    std::vector<Buffer> buffers_;
+    std::vector<size_t> free_buffers_;
+
+    std::mutex reads_mutex_;
+    std::condition_variable reads_ready_;
+    std::deque<Read> reads_;
+    size_t readers_left_ = 0;   // Reader threads still running
+
+    std::mutex results_mutex_;
+    std::condition_variable results_ready_;
+    std::condition_variable results_space_;
+    std::deque<FileTokens> results_;
+    size_t delivered_ = 0;
+    NextAwaiter* waiter_ = nullptr;
+
+    std::atomic<size_t> next_file_{0};
+    std::vector<std::thread> readers_;
+    std::vector<std::thread> workers_;
+
+    std::optional<size_t> acquire_buffer(size_t size, bool wait);
+    void release_buffer(size_t buffer);
+    void push_read(Read read);
+    void reader_finished();
+
+    struct IoRing;   // io_uring instance, on Linux builds with DB25_HAS_IO_URING
+
+    void read_with_threads();
+    bool start_io_uring();
+    void read_with_io_uring(IoRing& ring);
+    void work();
+    void deliver(FileTokens result);
+
+    bool try_next(std::optional<FileTokens>& result);
+    bool suspend(NextAwaiter& awaiter, std::coroutine_handle<> handle);
+};
+
+}  // namespace db25
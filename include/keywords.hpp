@@ -546,4 +546,18 @@ template<typename Processor>
     return "INVALID";
 }
 
+// Fingerprint of the keyword table (spellings and IDs). Token files store
+// keyword IDs and record this value, so a file written against a different
+// table is rejected instead of decoding to the wrong keywords.
+inline constexpr uint64_t kKeywordTableVersion = [] {
+    uint64_t hash = 0xcbf29ce484222325ULL;  // FNV-1a
+    for (const auto& entry : KEYWORDS) {
+        for (char c : entry.text) {
+            hash = (hash ^ static_cast<uint8_t>(c)) * 0x100000001b3ULL;
+        }
+        hash = (hash ^ static_cast<uint16_t>(entry.id)) * 0x100000001b3ULL;
+    }
+    return hash;
+}();
+
 }  // namespace db25
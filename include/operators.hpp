@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) 2024 Chiradip Mandal
+ * Author: Chiradip Mandal
+ * Organization: Space-RF.org
+ *
+ * This file is part of DB25 SQL Tokenizer.
+ *
+ * Licensed under the MIT License. See LICENSE file for details.
+ */
+
+#pragma once
+
+// ============================================================================
+// Operator and delimiter identifiers
+// ============================================================================
+// Every Operator and Delimiter token carries an Operator ID so the parser can
+// switch on an integer instead of comparing spellings. IDs are shared by all
+// dialects; which multi-character spellings are recognized is decided by each
+// dialect's `operators` list (see sql_dialect.hpp).
+// ============================================================================
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+namespace db25 {
+
+enum class Operator : uint8_t {
+    UNKNOWN = 0,
+
+    // Single character
+    PLUS,
+    MINUS,
+    STAR,
+    SLASH,
+    PERCENT,
+    CARET,
+    AMPERSAND,
+    PIPE,
+    TILDE,
+    BANG,
+    EQUAL,
+    LESS,
+    GREATER,
+    AT,
+    HASH,
+    QUESTION,
+    COLON,
+    DOLLAR,
+    BACKSLASH,
+    BACKTICK,
+
+    // Brackets and separators
+    LEFT_PAREN,
+    RIGHT_PAREN,
+    LEFT_BRACKET,
+    RIGHT_BRACKET,
+    LEFT_BRACE,
+    RIGHT_BRACE,
+    COMMA,
+    SEMICOLON,
+    DOT,
+
+    // Two characters
+    LESS_EQUAL,             // <=
+    GREATER_EQUAL,          // >=
+    NOT_EQUAL,              // <>
+    BANG_EQUAL,             // !=
+    EQUAL_EQUAL,            // ==
+    CONCAT,                 // ||
+    AND_AND,                // &&
+    CAST,                   // ::
+    SHIFT_LEFT,             // <<
+    SHIFT_RIGHT,            // >>
+    ASSIGN,                 // :=
+    ARROW,                  // ->
+    HASH_ARROW,             // #>
+    CONTAINS,               // @>
+    CONTAINED_BY,           // <@
+    REGEX_IMATCH,           // ~*
+    REGEX_NOT_MATCH,        // !~
+    STARTS_WITH,            // ^@
+    NOT_LESS,               // !<
+    NOT_GREATER,            // !>
+    PLUS_ASSIGN,            // +=
+    MINUS_ASSIGN,           // -=
+    STAR_ASSIGN,            // *=
+    SLASH_ASSIGN,           // /=
+    PERCENT_ASSIGN,         // %=
+    AMPERSAND_ASSIGN,       // &=
+    PIPE_ASSIGN,            // |=
+    CARET_ASSIGN,           // ^=
+
+    // Three characters
+    ARROW_TEXT,             // ->>
+    HASH_ARROW_TEXT,        // #>>
+    NULL_SAFE_EQUAL,        // <=>
+    REGEX_NOT_IMATCH,       // !~*
+    CUBE_ROOT               // ||/
+};
+
+struct OperatorEntry {
+    std::string_view text;
+    Operator id;
+};
+
+// Spelling of every operator ID, in enum order
+inline constexpr std::array<OperatorEntry, 62> OPERATORS = {{
+    {"+", Operator::PLUS},
+    {"-", Operator::MINUS},
+    {"*", Operator::STAR},
+    {"/", Operator::SLASH},
+    {"%", Operator::PERCENT},
+    {"^", Operator::CARET},
+    {"&", Operator::AMPERSAND},
+    {"|", Operator::PIPE},
+    {"~", Operator::TILDE},
+    {"!", Operator::BANG},
+    {"=", Operator::EQUAL},
+    {"<", Operator::LESS},
+    {">", Operator::GREATER},
+    {"@", Operator::AT},
+    {"#", Operator::HASH},
+    {"?", Operator::QUESTION},
+    {":", Operator::COLON},
+    {"$", Operator::DOLLAR},
+    {"\\", Operator::BACKSLASH},
+    {"`", Operator::BACKTICK},
+    {"(", Operator::LEFT_PAREN},
+    {")", Operator::RIGHT_PAREN},
+    {"[", Operator::LEFT_BRACKET},
+    {"]", Operator::RIGHT_BRACKET},
+    {"{", Operator::LEFT_BRACE},
+    {"}", Operator::RIGHT_BRACE},
+    {",", Operator::COMMA},
+    {";", Operator::SEMICOLON},
+    {".", Operator::DOT},
+    {"<=", Operator::LESS_EQUAL},
+    {">=", Operator::GREATER_EQUAL},
+    {"<>", Operator::NOT_EQUAL},
+    {"!=", Operator::BANG_EQUAL},
+    {"==", Operator::EQUAL_EQUAL},
+    {"||", Operator::CONCAT},
+    {"&&", Operator::AND_AND},
+    {"::", Operator::CAST},
+    {"<<", Operator::SHIFT_LEFT},
+    {">>", Operator::SHIFT_RIGHT},
+    {":=", Operator::ASSIGN},
+    {"->", Operator::ARROW},
+    {"#>", Operator::HASH_ARROW},
+    {"@>", Operator::CONTAINS},
+    {"<@", Operator::CONTAINED_BY},
+    {"~*", Operator::REGEX_IMATCH},
+    {"!~", Operator::REGEX_NOT_MATCH},
+    {"^@", Operator::STARTS_WITH},
+    {"!<", Operator::NOT_LESS},
+    {"!>", Operator::NOT_GREATER},
+    {"+=", Operator::PLUS_ASSIGN},
+    {"-=", Operator::MINUS_ASSIGN},
+    {"*=", Operator::STAR_ASSIGN},
+    {"/=", Operator::SLASH_ASSIGN},
+    {"%=", Operator::PERCENT_ASSIGN},
+    {"&=", Operator::AMPERSAND_ASSIGN},
+    {"|=", Operator::PIPE_ASSIGN},
+    {"^=", Operator::CARET_ASSIGN},
+    {"->>", Operator::ARROW_TEXT},
+    {"#>>", Operator::HASH_ARROW_TEXT},
+    {"<=>", Operator::NULL_SAFE_EQUAL},
+    {"!~*", Operator::REGEX_NOT_IMATCH},
+    {"||/", Operator::CUBE_ROOT},
+}};
+
+static_assert([] {
+    for (size_t i = 0; i < OPERATORS.size(); ++i) {
+        if (OPERATORS[i].id != static_cast<Operator>(i + 1)) return false;
+    }
+    return OPERATORS.size() == static_cast<size_t>(Operator::CUBE_ROOT);
+}(), "OPERATORS must list every Operator ID in enum order");
+
+// ID for an operator spelling (UNKNOWN if there is none). Used at compile
+// time to build the dialect operator tables.
+[[nodiscard]] constexpr Operator find_operator(std::string_view text) noexcept {
+    for (const auto& entry : OPERATORS) {
+        if (entry.text == text) {
+            return entry.id;
+        }
+    }
+    return Operator::UNKNOWN;
+}
+
+// Operator name lookup
+[[nodiscard]] inline std::string_view operator_name(Operator op) noexcept {
+    if (op == Operator::UNKNOWN) return "UNKNOWN";
+    size_t idx = static_cast<size_t>(op) - 1;
+    if (idx < OPERATORS.size()) {
+        return OPERATORS[idx].text;
+    }
+    return "INVALID";
+}
+
+// Fingerprint of the operator table (spellings and IDs), recorded in token
+// files alongside kKeywordTableVersion
+inline constexpr uint64_t kOperatorTableVersion = [] {
+    uint64_t hash = 0xcbf29ce484222325ULL;  // FNV-1a
+    for (const auto& entry : OPERATORS) {
+        for (char c : entry.text) {
+            hash = (hash ^ static_cast<uint8_t>(c)) * 0x100000001b3ULL;
+        }
+        hash = (hash ^ static_cast<uint8_t>(entry.id)) * 0x100000001b3ULL;
+    }
+    return hash;
+}();
+
+}  // namespace db25
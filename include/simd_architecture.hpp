@@ -43,6 +43,135 @@ concept SimdProcessor = requires(T t, const std::byte* data, size_t size) {
     { T::vector_size() } -> std::convertible_to<size_t>;
 };
 
+// Marks the second quote of every doubled pair ('' -> ') in a block of
+// `width` quote bits. A pair split across blocks is carried in `pending`.
+[[nodiscard]] inline uint64_t doubled_quote_drop_mask(uint64_t quotes, unsigned width,
+                                                      bool& pending) noexcept {
+    uint64_t drop = 0;
+    if (pending) {
+        drop = 1;
+        quotes &= ~uint64_t{1};
+        pending = false;
+    }
+    while (quotes != 0) {
+        unsigned first = static_cast<unsigned>(std::countr_zero(quotes));
+        if (first + 1 >= width) {
+            pending = true;
+            break;
+        }
+        drop |= uint64_t{1} << (first + 1);
+        quotes &= ~(uint64_t{3} << first);
+    }
+    return drop;
+}
+
+// Marks the bytes escaped by a backslash in a 64-byte block, given the
+// block's backslash bits. Only the last backslash of an odd-length run
+// escapes anything, so runs are classified by the parity of their start
+// position with one carrying add instead of a per-byte state machine.
+// `carry` is set when the first byte of the next block is escaped.
+[[nodiscard]] inline uint64_t escaped_mask(uint64_t backslashes, uint64_t& carry) noexcept {
+    constexpr uint64_t even_bits = 0x5555555555555555ULL;
+    
+    backslashes &= ~carry;
+    uint64_t follows_escape = (backslashes << 1) | carry;
+    uint64_t odd_starts = backslashes & ~even_bits & ~follows_escape;
+    uint64_t sequences_starting_on_even_bits = odd_starts + backslashes;
+    carry = sequences_starting_on_even_bits < odd_starts ? 1 : 0;
+    uint64_t invert_mask = sequences_starting_on_even_bits << 1;
+    return (even_bits ^ invert_mask) & follows_escape;
+}
+
+// Byte-shuffle indices that pack the set bits of an 8-bit keep mask to the
+// front of an 8-byte lane (0x80 zeroes the unused tail).
+inline constexpr std::array<uint64_t, 256> compaction_shuffle_table = [] {
+    std::array<uint64_t, 256> table{};
+    for (unsigned mask = 0; mask < 256; ++mask) {
+        uint64_t entry = 0x8080808080808080ULL;
+        unsigned out = 0;
+        for (unsigned bit = 0; bit < 8; ++bit) {
+            if (mask & (1U << bit)) {
+                entry &= ~(uint64_t{0xFF} << (out * 8));
+                entry |= uint64_t{bit} << (out * 8);
+                ++out;
+            }
+        }
+        table[mask] = entry;
+    }
+    return table;
+}();
+
+// UTF-8 validation lookup tables (Keiser & Lemire, "Validating UTF-8 In
+// Less Than One Instruction Per Byte"). Each table maps a nibble of the
+// previous or current byte to the set of errors it could be part of; an
+// error survives only if all three lookups agree.
+namespace utf8_error {
+    inline constexpr uint8_t TOO_SHORT   = 1 << 0;  // Lead byte not followed by continuation
+    inline constexpr uint8_t TOO_LONG    = 1 << 1;  // ASCII followed by continuation
+    inline constexpr uint8_t OVERLONG_3  = 1 << 2;  // 11100000 100_____
+    inline constexpr uint8_t TOO_LARGE   = 1 << 3;  // Code point above U+10FFFF
+    inline constexpr uint8_t SURROGATE   = 1 << 4;  // 11101101 101_____
+    inline constexpr uint8_t OVERLONG_2  = 1 << 5;  // 1100000_ 10______
+    inline constexpr uint8_t TOO_LARGE_1000 = 1 << 6;
+    inline constexpr uint8_t OVERLONG_4  = 1 << 6;  // 11110000 1000____
+    inline constexpr uint8_t TWO_CONTS   = 1 << 7;  // Continuation after continuation
+    inline constexpr uint8_t CARRY = TOO_SHORT | TOO_LONG | TWO_CONTS;
+}
+
+alignas(16) inline constexpr uint8_t utf8_byte_1_high[16] = {
+    // 0_______ ASCII
+    utf8_error::TOO_LONG, utf8_error::TOO_LONG, utf8_error::TOO_LONG, utf8_error::TOO_LONG,
+    utf8_error::TOO_LONG, utf8_error::TOO_LONG, utf8_error::TOO_LONG, utf8_error::TOO_LONG,
+    // 10______ continuation
+    utf8_error::TWO_CONTS, utf8_error::TWO_CONTS, utf8_error::TWO_CONTS, utf8_error::TWO_CONTS,
+    // 1100____ two-byte lead
+    utf8_error::TOO_SHORT | utf8_error::OVERLONG_2,
+    // 1101____ two-byte lead
+    utf8_error::TOO_SHORT,
+    // 1110____ three-byte lead
+    utf8_error::TOO_SHORT | utf8_error::OVERLONG_3 | utf8_error::SURROGATE,
+    // 1111____ four-byte lead
+    utf8_error::TOO_SHORT | utf8_error::TOO_LARGE | utf8_error::TOO_LARGE_1000 | utf8_error::OVERLONG_4
+};
+
+alignas(16) inline constexpr uint8_t utf8_byte_1_low[16] = {
+    utf8_error::CARRY | utf8_error::OVERLONG_3 | utf8_error::OVERLONG_2 | utf8_error::OVERLONG_4,
+    utf8_error::CARRY | utf8_error::OVERLONG_2,
+    utf8_error::CARRY,
+    utf8_error::CARRY,
+    utf8_error::CARRY | utf8_error::TOO_LARGE,
+    utf8_error::CARRY | utf8_error::TOO_LARGE | utf8_error::TOO_LARGE_1000,
+    utf8_error::CARRY | utf8_error::TOO_LARGE | utf8_error::TOO_LARGE_1000,
+    utf8_error::CARRY | utf8_error::TOO_LARGE | utf8_error::TOO_LARGE_1000,
+    utf8_error::CARRY | utf8_error::TOO_LARGE | utf8_error::TOO_LARGE_1000,
+    utf8_error::CARRY | utf8_error::TOO_LARGE | utf8_error::TOO_LARGE_1000,
+    utf8_error::CARRY | utf8_error::TOO_LARGE | utf8_error::TOO_LARGE_1000,
+    utf8_error::CARRY | utf8_error::TOO_LARGE | utf8_error::TOO_LARGE_1000,
+    utf8_error::CARRY | utf8_error::TOO_LARGE | utf8_error::TOO_LARGE_1000,
+    utf8_error::CARRY | utf8_error::TOO_LARGE | utf8_error::TOO_LARGE_1000 | utf8_error::SURROGATE,
+    utf8_error::CARRY | utf8_error::TOO_LARGE | utf8_error::TOO_LARGE_1000,
+    utf8_error::CARRY | utf8_error::TOO_LARGE | utf8_error::TOO_LARGE_1000
+};
+
+alignas(16) inline constexpr uint8_t utf8_byte_2_high[16] = {
+    // ________ 0_______ ASCII
+    utf8_error::TOO_SHORT, utf8_error::TOO_SHORT, utf8_error::TOO_SHORT, utf8_error::TOO_SHORT,
+    utf8_error::TOO_SHORT, utf8_error::TOO_SHORT, utf8_error::TOO_SHORT, utf8_error::TOO_SHORT,
+    // ________ 1000____
+    utf8_error::TOO_LONG | utf8_error::OVERLONG_2 | utf8_error::TWO_CONTS |
+        utf8_error::OVERLONG_3 | utf8_error::TOO_LARGE_1000 | utf8_error::OVERLONG_4,
+    // ________ 1001____
+    utf8_error::TOO_LONG | utf8_error::OVERLONG_2 | utf8_error::TWO_CONTS |
+        utf8_error::OVERLONG_3 | utf8_error::TOO_LARGE,
+    // ________ 101_____
+    utf8_error::TOO_LONG | utf8_error::OVERLONG_2 | utf8_error::TWO_CONTS |
+        utf8_error::SURROGATE | utf8_error::TOO_LARGE,
+    utf8_error::TOO_LONG | utf8_error::OVERLONG_2 | utf8_error::TWO_CONTS |
+        utf8_error::SURROGATE | utf8_error::TOO_LARGE,
+    // ________ 11______ lead byte
+    utf8_error::TOO_SHORT, utf8_error::TOO_SHORT, utf8_error::TOO_SHORT, utf8_error::TOO_SHORT
+};
+
 class ScalarProcessor {
 public:
     static constexpr size_t vector_size() noexcept { return 1; }
@@ -73,6 +202,45 @@ public:
         }
         return i;
     }
+
+    [[nodiscard]] size_t find_byte(const std::byte* data, size_t size, uint8_t byte) const noexcept {
+        return find_delimiter(data, size, [byte](std::byte b) {
+            return static_cast<uint8_t>(b) == byte;
+        });
+    }
+
+    [[nodiscard]] size_t count_byte(const std::byte* data, size_t size, uint8_t byte) const noexcept {
+        size_t count = 0;
+        for (size_t i = 0; i < size; ++i) {
+            count += static_cast<uint8_t>(data[i]) == byte;
+        }
+        return count;
+    }
+
+    // Bit i is set when data[i] == byte; reads exactly 64 bytes
+    [[nodiscard]] uint64_t byte_mask64(const std::byte* data, uint8_t byte) const noexcept {
+        uint64_t mask = 0;
+        for (size_t i = 0; i < 64; ++i) {
+            mask |= uint64_t{static_cast<uint8_t>(data[i]) == byte} << i;
+        }
+        return mask;
+    }
+
+    // Length of the leading run of identifier bytes (CHAR_IDENT_CONT or
+    // non-ASCII). Sets 0x80 in `seen` if the run contains non-ASCII bytes.
+    [[nodiscard]] size_t identifier_length(const std::byte* data, size_t size,
+                                           uint8_t& seen) const noexcept {
+        size_t i = 0;
+        while (i < size) {
+            uint8_t ch = static_cast<uint8_t>(data[i]);
+            if (!is_identifier_cont(ch) && !is_non_ascii(ch)) {
+                break;
+            }
+            seen |= ch & 0x80;
+            ++i;
+        }
+        return i;
+    }
     
     [[nodiscard]] bool matches_keyword(const std::byte* data, size_t size, 
                                       const char* keyword, size_t kw_len) const noexcept {
@@ -94,6 +262,76 @@ public:
         
         return true;
     }
+
+    // Collapses doubled quotes in the body of a quoted literal; returns the
+    // number of bytes written to `out`. `pending` skips a leading partner
+    // quote left over from a vector block.
+    size_t unescape_quotes(const std::byte* data, size_t size, uint8_t quote,
+                           char* out, bool pending = false) const noexcept {
+        size_t written = 0;
+        size_t i = pending ? 1 : 0;
+        while (i < size) {
+            uint8_t ch = static_cast<uint8_t>(data[i]);
+            out[written++] = static_cast<char>(ch);
+            i += (ch == quote) ? 2 : 1;
+        }
+        return written;
+    }
+
+    [[nodiscard]] bool validate_utf8(const std::byte* data, size_t size) const noexcept {
+        size_t i = 0;
+        while (i < size) {
+            // ASCII fast path, eight bytes at a time
+            if (i + 8 <= size) {
+                uint64_t word;
+                std::memcpy(&word, data + i, sizeof(word));
+                if ((word & 0x8080808080808080ULL) == 0) {
+                    i += 8;
+                    continue;
+                }
+            }
+
+            uint8_t lead = static_cast<uint8_t>(data[i]);
+            if (lead < 0x80) {
+                ++i;
+                continue;
+            }
+
+            size_t length;
+            uint32_t code_point;
+            if ((lead & 0xE0) == 0xC0) {
+                length = 2;
+                code_point = lead & 0x1F;
+            } else if ((lead & 0xF0) == 0xE0) {
+                length = 3;
+                code_point = lead & 0x0F;
+            } else if ((lead & 0xF8) == 0xF0) {
+                length = 4;
+                code_point = lead & 0x07;
+            } else {
+                return false;
+            }
+
+            if (i + length > size) return false;
+
+            for (size_t j = 1; j < length; ++j) {
+                uint8_t cont = static_cast<uint8_t>(data[i + j]);
+                if ((cont & 0xC0) != 0x80) return false;
+                code_point = (code_point << 6) | (cont & 0x3F);
+            }
+
+            if ((length == 2 && code_point < 0x80) ||
+                (length == 3 && code_point < 0x800) ||
+                (length == 4 && code_point < 0x10000) ||
+                code_point > 0x10FFFF ||
+                (code_point >= 0xD800 && code_point <= 0xDFFF)) {
+                return false;
+            }
+
+            i += length;
+        }
+        return true;
+    }
 };
 
 #if defined(__x86_64__) || defined(_M_X64)
@@ -148,11 +386,159 @@ public:
         return i + scalar.skip_whitespace(data + i, size - i);
     }
     
+    [[nodiscard]] size_t find_byte(const std::byte* data, size_t size, uint8_t byte) const noexcept {
+        const __m128i needle = _mm_set1_epi8(static_cast<char>(byte));
+        
+        size_t i = 0;
+        
+        for (; i + 16 <= size; i += 16) {
+            __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            uint32_t mask = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, needle));
+            if (mask != 0) {
+                return i + std::countr_zero(mask);
+            }
+        }
+        
+        ScalarProcessor scalar;
+        return i + scalar.find_byte(data + i, size - i, byte);
+    }
+    
+    [[nodiscard]] size_t count_byte(const std::byte* data, size_t size, uint8_t byte) const noexcept {
+        const __m128i needle = _mm_set1_epi8(static_cast<char>(byte));
+        
+        size_t count = 0;
+        size_t i = 0;
+        
+        for (; i + 16 <= size; i += 16) {
+            __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            count += std::popcount(static_cast<uint32_t>(
+                _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, needle))));
+        }
+        
+        ScalarProcessor scalar;
+        return count + scalar.count_byte(data + i, size - i, byte);
+    }
+    
+    [[nodiscard]] uint64_t byte_mask64(const std::byte* data, uint8_t byte) const noexcept {
+        const __m128i needle = _mm_set1_epi8(static_cast<char>(byte));
+        
+        uint64_t mask = 0;
+        for (size_t i = 0; i < 4; ++i) {
+            __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i * 16));
+            mask |= static_cast<uint64_t>(static_cast<uint32_t>(
+                _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, needle)))) << (i * 16);
+        }
+        return mask;
+    }
+    
+    [[nodiscard]] size_t identifier_length(const std::byte* data, size_t size,
+                                           uint8_t& seen) const noexcept {
+        return ScalarProcessor{}.identifier_length(data, size, seen);
+    }
+    
     [[nodiscard]] bool matches_keyword(const std::byte* data, size_t size,
                                       const char* keyword, size_t kw_len) const noexcept {
         ScalarProcessor scalar;
         return scalar.matches_keyword(data, size, keyword, kw_len);
     }
+
+    // Packs the bytes selected by a 16-bit keep mask; may write up to 16
+    // bytes past the returned pointer.
+    static char* compact_block(__m128i chunk, uint32_t keep, char* out) noexcept {
+        uint32_t lo = keep & 0xFF;
+        uint32_t hi = (keep >> 8) & 0xFF;
+        const __m128i shuffle = _mm_set_epi64x(
+            static_cast<long long>(compaction_shuffle_table[hi] + 0x0808080808080808ULL),
+            static_cast<long long>(compaction_shuffle_table[lo]));
+        __m128i packed = _mm_shuffle_epi8(chunk, shuffle);
+
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out), packed);
+        out += std::popcount(lo);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out), _mm_unpackhi_epi64(packed, packed));
+        return out + std::popcount(hi);
+    }
+
+    size_t unescape_quotes(const std::byte* data, size_t size, uint8_t quote,
+                           char* out) const noexcept {
+        const __m128i quotes = _mm_set1_epi8(static_cast<char>(quote));
+        char* const begin = out;
+        bool pending = false;
+        size_t i = 0;
+
+        for (; i + 16 <= size; i += 16) {
+            __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            uint32_t mask = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, quotes));
+
+            if (mask == 0 && !pending) {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out), chunk);
+                out += 16;
+                continue;
+            }
+
+            uint32_t keep = ~static_cast<uint32_t>(doubled_quote_drop_mask(mask, 16, pending));
+            out = compact_block(chunk, keep & 0xFFFF, out);
+        }
+
+        ScalarProcessor scalar;
+        return static_cast<size_t>(out - begin) +
+               scalar.unescape_quotes(data + i, size - i, quote, out, pending);
+    }
+
+    [[nodiscard]] bool validate_utf8(const std::byte* data, size_t size) const noexcept {
+        const __m128i byte_1_high = _mm_load_si128(reinterpret_cast<const __m128i*>(utf8_byte_1_high));
+        const __m128i byte_1_low = _mm_load_si128(reinterpret_cast<const __m128i*>(utf8_byte_1_low));
+        const __m128i byte_2_high = _mm_load_si128(reinterpret_cast<const __m128i*>(utf8_byte_2_high));
+        const __m128i nibble = _mm_set1_epi8(0x0F);
+        const __m128i incomplete_max = _mm_setr_epi8(
+            -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+            static_cast<char>(0xF0 - 1), static_cast<char>(0xE0 - 1), static_cast<char>(0xC0 - 1));
+
+        __m128i error = _mm_setzero_si128();
+        __m128i prev_input = _mm_setzero_si128();
+        __m128i prev_incomplete = _mm_setzero_si128();
+
+        auto check_block = [&](__m128i input) {
+            if (_mm_movemask_epi8(input) == 0) {
+                // Pure ASCII: only a sequence left open by the previous block can fail
+                error = _mm_or_si128(error, prev_incomplete);
+                prev_incomplete = _mm_setzero_si128();
+                prev_input = input;
+                return;
+            }
+
+            __m128i prev1 = _mm_alignr_epi8(input, prev_input, 15);
+            __m128i special = _mm_and_si128(
+                _mm_and_si128(
+                    _mm_shuffle_epi8(byte_1_high, _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble)),
+                    _mm_shuffle_epi8(byte_1_low, _mm_and_si128(prev1, nibble))),
+                _mm_shuffle_epi8(byte_2_high, _mm_and_si128(_mm_srli_epi16(input, 4), nibble)));
+
+            __m128i prev2 = _mm_alignr_epi8(input, prev_input, 14);
+            __m128i prev3 = _mm_alignr_epi8(input, prev_input, 13);
+            __m128i must_be_continuation = _mm_and_si128(
+                _mm_or_si128(_mm_subs_epu8(prev2, _mm_set1_epi8(static_cast<char>(0xE0 - 0x80))),
+                             _mm_subs_epu8(prev3, _mm_set1_epi8(static_cast<char>(0xF0 - 0x80)))),
+                _mm_set1_epi8(static_cast<char>(0x80)));
+
+            error = _mm_or_si128(error, _mm_xor_si128(must_be_continuation, special));
+            prev_incomplete = _mm_subs_epu8(input, incomplete_max);
+            prev_input = input;
+        };
+
+        size_t i = 0;
+        for (; i + 16 <= size; i += 16) {
+            check_block(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)));
+        }
+
+        if (i < size) {
+            alignas(16) uint8_t tail[16] = {};
+            std::memcpy(tail, data + i, size - i);
+            check_block(_mm_load_si128(reinterpret_cast<const __m128i*>(tail)));
+        }
+
+        error = _mm_or_si128(error, prev_incomplete);
+        return _mm_testz_si128(error, error) != 0;
+    }
 };
 
 class AVX2Processor {
@@ -221,6 +607,54 @@ public:
         return i + sse42.skip_whitespace(data + i, size - i);
     }
     
+    [[nodiscard]] size_t find_byte(const std::byte* data, size_t size, uint8_t byte) const noexcept {
+        const __m256i needle = _mm256_set1_epi8(static_cast<char>(byte));
+        
+        size_t i = 0;
+        
+        for (; i + 32 <= size; i += 32) {
+            __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+            uint32_t mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, needle));
+            if (mask != 0) {
+                return i + std::countr_zero(mask);
+            }
+        }
+        
+        SSE42Processor sse42;
+        return i + sse42.find_byte(data + i, size - i, byte);
+    }
+    
+    [[nodiscard]] size_t count_byte(const std::byte* data, size_t size, uint8_t byte) const noexcept {
+        const __m256i needle = _mm256_set1_epi8(static_cast<char>(byte));
+        
+        size_t count = 0;
+        size_t i = 0;
+        
+        for (; i + 32 <= size; i += 32) {
+            __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+            count += std::popcount(static_cast<uint32_t>(
+                _mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, needle))));
+        }
+        
+        SSE42Processor sse42;
+        return count + sse42.count_byte(data + i, size - i, byte);
+    }
+    
+    [[nodiscard]] uint64_t byte_mask64(const std::byte* data, uint8_t byte) const noexcept {
+        const __m256i needle = _mm256_set1_epi8(static_cast<char>(byte));
+        
+        __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+        __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + 32));
+        uint32_t lo_mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, needle));
+        uint32_t hi_mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, needle));
+        return (static_cast<uint64_t>(hi_mask) << 32) | lo_mask;
+    }
+    
+    [[nodiscard]] size_t identifier_length(const std::byte* data, size_t size,
+                                           uint8_t& seen) const noexcept {
+        return ScalarProcessor{}.identifier_length(data, size, seen);
+    }
+    
     [[nodiscard]] bool matches_keyword(const std::byte* data, size_t size,
                                       const char* keyword, size_t kw_len) const noexcept {
         if (size < kw_len || kw_len > 32) {
@@ -244,8 +678,104 @@ public:
         __m256i cmp = _mm256_cmpeq_epi8(data_vec, kw_vec);
         uint32_t mask = _mm256_movemask_epi8(cmp);
         
-        uint32_t expected_mask = (1U << kw_len) - 1;
-        return (mask & expected_mask) == expected_mask;
+        uint32_t expected_mask = static_cast<uint32_t>((uint64_t{1} << kw_len) - 1);
+        if ((mask & expected_mask) != expected_mask) {
+            return false;
+        }
+        
+        if (size > kw_len) {
+            return !is_identifier_cont(static_cast<uint8_t>(data[kw_len]));
+        }
+        return true;
+    }
+
+    size_t unescape_quotes(const std::byte* data, size_t size, uint8_t quote,
+                           char* out) const noexcept {
+        const __m256i quotes = _mm256_set1_epi8(static_cast<char>(quote));
+        char* const begin = out;
+        bool pending = false;
+        size_t i = 0;
+
+        for (; i + 32 <= size; i += 32) {
+            __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+            uint32_t mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, quotes));
+
+            if (mask == 0 && !pending) {
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), chunk);
+                out += 32;
+                continue;
+            }
+
+            uint32_t keep = ~static_cast<uint32_t>(doubled_quote_drop_mask(mask, 32, pending));
+            out = SSE42Processor::compact_block(_mm256_castsi256_si128(chunk), keep & 0xFFFF, out);
+            out = SSE42Processor::compact_block(_mm256_extracti128_si256(chunk, 1), keep >> 16, out);
+        }
+
+        ScalarProcessor scalar;
+        return static_cast<size_t>(out - begin) +
+               scalar.unescape_quotes(data + i, size - i, quote, out, pending);
+    }
+
+    [[nodiscard]] bool validate_utf8(const std::byte* data, size_t size) const noexcept {
+        const __m256i byte_1_high = _mm256_broadcastsi128_si256(
+            _mm_load_si128(reinterpret_cast<const __m128i*>(utf8_byte_1_high)));
+        const __m256i byte_1_low = _mm256_broadcastsi128_si256(
+            _mm_load_si128(reinterpret_cast<const __m128i*>(utf8_byte_1_low)));
+        const __m256i byte_2_high = _mm256_broadcastsi128_si256(
+            _mm_load_si128(reinterpret_cast<const __m128i*>(utf8_byte_2_high)));
+        const __m256i nibble = _mm256_set1_epi8(0x0F);
+        const __m256i incomplete_max = _mm256_setr_epi8(
+            -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+            -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+            static_cast<char>(0xF0 - 1), static_cast<char>(0xE0 - 1), static_cast<char>(0xC0 - 1));
+
+        __m256i error = _mm256_setzero_si256();
+        __m256i prev_input = _mm256_setzero_si256();
+        __m256i prev_incomplete = _mm256_setzero_si256();
+
+        auto check_block = [&](__m256i input) {
+            if (_mm256_movemask_epi8(input) == 0) {
+                error = _mm256_or_si256(error, prev_incomplete);
+                prev_incomplete = _mm256_setzero_si256();
+                prev_input = input;
+                return;
+            }
+
+            // Previous bytes across the 128-bit lane boundary
+            __m256i carried = _mm256_permute2x128_si256(prev_input, input, 0x21);
+            __m256i prev1 = _mm256_alignr_epi8(input, carried, 15);
+            __m256i prev2 = _mm256_alignr_epi8(input, carried, 14);
+            __m256i prev3 = _mm256_alignr_epi8(input, carried, 13);
+
+            __m256i special = _mm256_and_si256(
+                _mm256_and_si256(
+                    _mm256_shuffle_epi8(byte_1_high, _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble)),
+                    _mm256_shuffle_epi8(byte_1_low, _mm256_and_si256(prev1, nibble))),
+                _mm256_shuffle_epi8(byte_2_high, _mm256_and_si256(_mm256_srli_epi16(input, 4), nibble)));
+
+            __m256i must_be_continuation = _mm256_and_si256(
+                _mm256_or_si256(_mm256_subs_epu8(prev2, _mm256_set1_epi8(static_cast<char>(0xE0 - 0x80))),
+                                _mm256_subs_epu8(prev3, _mm256_set1_epi8(static_cast<char>(0xF0 - 0x80)))),
+                _mm256_set1_epi8(static_cast<char>(0x80)));
+
+            error = _mm256_or_si256(error, _mm256_xor_si256(must_be_continuation, special));
+            prev_incomplete = _mm256_subs_epu8(input, incomplete_max);
+            prev_input = input;
+        };
+
+        size_t i = 0;
+        for (; i + 32 <= size; i += 32) {
+            check_block(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)));
+        }
+
+        if (i < size) {
+            alignas(32) uint8_t tail[32] = {};
+            std::memcpy(tail, data + i, size - i);
+            check_block(_mm256_load_si256(reinterpret_cast<const __m256i*>(tail)));
+        }
+
+        error = _mm256_or_si256(error, prev_incomplete);
+        return _mm256_testz_si256(error, error) != 0;
     }
 };
 
@@ -308,13 +838,185 @@ public:
         return i + avx2.skip_whitespace(data + i, size - i);
     }
     
+    [[nodiscard]] size_t find_byte(const std::byte* data, size_t size, uint8_t byte) const noexcept {
+        const __m512i needle = _mm512_set1_epi8(static_cast<char>(byte));
+        
+        size_t i = 0;
+        
+        for (; i + 64 <= size; i += 64) {
+            __m512i chunk = _mm512_loadu_si512(data + i);
+            __mmask64 mask = _mm512_cmpeq_epi8_mask(chunk, needle);
+            if (mask != 0) {
+                return i + std::countr_zero(mask);
+            }
+        }
+        
+        AVX2Processor avx2;
+        return i + avx2.find_byte(data + i, size - i, byte);
+    }
+    
+    [[nodiscard]] size_t count_byte(const std::byte* data, size_t size, uint8_t byte) const noexcept {
+        const __m512i needle = _mm512_set1_epi8(static_cast<char>(byte));
+        
+        size_t count = 0;
+        size_t i = 0;
+        
+        for (; i + 64 <= size; i += 64) {
+            __m512i chunk = _mm512_loadu_si512(data + i);
+            count += std::popcount(static_cast<uint64_t>(_mm512_cmpeq_epi8_mask(chunk, needle)));
+        }
+        
+        AVX2Processor avx2;
+        return count + avx2.count_byte(data + i, size - i, byte);
+    }
+    
+    [[nodiscard]] uint64_t byte_mask64(const std::byte* data, uint8_t byte) const noexcept {
+        return _mm512_cmpeq_epi8_mask(_mm512_loadu_si512(data), _mm512_set1_epi8(static_cast<char>(byte)));
+    }
+    
+    [[nodiscard]] size_t identifier_length(const std::byte* data, size_t size,
+                                           uint8_t& seen) const noexcept {
+        return ScalarProcessor{}.identifier_length(data, size, seen);
+    }
+    
     [[nodiscard]] bool matches_keyword(const std::byte* data, size_t size,
                                       const char* keyword, size_t kw_len) const noexcept {
         AVX2Processor avx2;
         return avx2.matches_keyword(data, size, keyword, kw_len);
     }
+
+    size_t unescape_quotes(const std::byte* data, size_t size, uint8_t quote,
+                           char* out) const noexcept {
+        AVX2Processor avx2;
+        return avx2.unescape_quotes(data, size, quote, out);
+    }
+    [[nodiscard]] bool validate_utf8(const std::byte* data, size_t size) const noexcept {
+        AVX2Processor avx2;
+        return avx2.validate_utf8(data, size);
+    }
+};
+
+#ifdef DB25_HAS_AVX512_VBMI
+
+// AVX-512 with VBMI, VBMI2 and BMI2. Every kernel classifies 64 bytes with
+// one byte permute (vpermi2b) of the first 128 entries of char_lookup_table,
+// and handles the final partial block with a BZHI mask and a masked load
+// instead of falling back to narrower processors. Masked-off bytes are never
+// read, so loads near the end of a buffer cannot fault.
+class AVX512VbmiProcessor {
+private:
+    // char_lookup_table[byte] for 64 bytes; non-ASCII bytes classify as 0
+    [[nodiscard]] static __m512i classify64(__m512i chars) noexcept {
+        const __m512i low = _mm512_load_si512(char_lookup_table);
+        const __m512i high = _mm512_load_si512(char_lookup_table + 64);
+        return _mm512_maskz_permutex2var_epi8(~_mm512_movepi8_mask(chars), low, chars, high);
+    }
+    
+    // Valid-byte mask for a block of min(remaining, 64) bytes
+    [[nodiscard]] static __mmask64 block_mask(size_t remaining) noexcept {
+        return remaining >= 64 ? ~__mmask64{0} : _bzhi_u64(~uint64_t{0}, static_cast<unsigned>(remaining));
+    }
+    
+    // Bit i set when byte i of the block has any of the `classes` bits
+    [[nodiscard]] static __mmask64 class_mask(const std::byte* data, __mmask64 valid,
+                                              uint8_t classes) noexcept {
+        __m512i chars = _mm512_maskz_loadu_epi8(valid, data);
+        return _mm512_mask_test_epi8_mask(valid, classify64(chars),
+                                          _mm512_set1_epi8(static_cast<char>(classes)));
+    }
+    
+public:
+    static constexpr size_t vector_size() noexcept { return 64; }
+    
+    [[nodiscard]] size_t find_whitespace(const std::byte* data, size_t size) const noexcept {
+        for (size_t i = 0; i < size; i += 64) {
+            __mmask64 whitespace = class_mask(data + i, block_mask(size - i), CHAR_WHITESPACE);
+            if (whitespace != 0) {
+                return i + std::countr_zero(whitespace);
+            }
+        }
+        return size;
+    }
+    
+    [[nodiscard]] size_t skip_whitespace(const std::byte* data, size_t size) const noexcept {
+        for (size_t i = 0; i < size; i += 64) {
+            __mmask64 valid = block_mask(size - i);
+            __mmask64 other = valid & ~class_mask(data + i, valid, CHAR_WHITESPACE);
+            if (other != 0) {
+                return i + std::countr_zero(other);
+            }
+        }
+        return size;
+    }
+    
+    [[nodiscard]] size_t find_byte(const std::byte* data, size_t size, uint8_t byte) const noexcept {
+        return AVX512Processor{}.find_byte(data, size, byte);
+    }
+    
+    [[nodiscard]] size_t count_byte(const std::byte* data, size_t size, uint8_t byte) const noexcept {
+        return AVX512Processor{}.count_byte(data, size, byte);
+    }
+    
+    [[nodiscard]] uint64_t byte_mask64(const std::byte* data, uint8_t byte) const noexcept {
+        return AVX512Processor{}.byte_mask64(data, byte);
+    }
+    
+    [[nodiscard]] size_t identifier_length(const std::byte* data, size_t size,
+                                           uint8_t& seen) const noexcept {
+        const __m512i ident = _mm512_set1_epi8(static_cast<char>(CHAR_IDENT_CONT));
+        
+        for (size_t i = 0; i < size; i += 64) {
+            __mmask64 valid = block_mask(size - i);
+            __m512i chars = _mm512_maskz_loadu_epi8(valid, data + i);
+            __mmask64 non_ascii = _mm512_movepi8_mask(chars);
+            __mmask64 word = _mm512_test_epi8_mask(classify64(chars), ident) | non_ascii;
+            __mmask64 stop = valid & ~word;
+            
+            size_t length = stop != 0 ? static_cast<size_t>(std::countr_zero(stop)) : 64;
+            if (_bzhi_u64(non_ascii, static_cast<unsigned>(length)) != 0) {
+                seen |= 0x80;
+            }
+            if (stop != 0) {
+                return i + length;
+            }
+        }
+        return size;
+    }
+    
+    // Keywords of up to 64 bytes are compared in one masked load
+    [[nodiscard]] bool matches_keyword(const std::byte* data, size_t size,
+                                      const char* keyword, size_t kw_len) const noexcept {
+        if (size < kw_len) return false;
+        if (kw_len > 64) {
+            return AVX512Processor{}.matches_keyword(data, size, keyword, kw_len);
+        }
+        
+        const __m512i case_mask = _mm512_set1_epi8(static_cast<char>(0xDF));
+        __mmask64 valid = block_mask(kw_len);
+        __m512i text = _mm512_and_si512(_mm512_maskz_loadu_epi8(valid, data), case_mask);
+        __m512i word = _mm512_and_si512(_mm512_maskz_loadu_epi8(valid, keyword), case_mask);
+        if (_mm512_cmpneq_epi8_mask(text, word) != 0) {
+            return false;
+        }
+        
+        if (size > kw_len) {
+            return !is_identifier_cont(static_cast<uint8_t>(data[kw_len]));
+        }
+        return true;
+    }
+
+    size_t unescape_quotes(const std::byte* data, size_t size, uint8_t quote,
+                           char* out) const noexcept {
+        return AVX512Processor{}.unescape_quotes(data, size, quote, out);
+    }
+
+    [[nodiscard]] bool validate_utf8(const std::byte* data, size_t size) const noexcept {
+        return AVX512Processor{}.validate_utf8(data, size);
+    }
 };
 
+#endif  // DB25_HAS_AVX512_VBMI
+
 #elif defined(__aarch64__) || defined(_M_ARM64)
 
 class NeonProcessor {
@@ -396,6 +1098,58 @@ public:
         return i + scalar.skip_whitespace(data + i, size - i);
     }
     
+    [[nodiscard]] size_t find_byte(const std::byte* data, size_t size, uint8_t byte) const noexcept {
+        const uint8x16_t needle = vdupq_n_u8(byte);
+        
+        size_t i = 0;
+        
+        for (; i + 16 <= size; i += 16) {
+            uint8x16_t matches = vceqq_u8(vld1q_u8(reinterpret_cast<const uint8_t*>(data + i)), needle);
+            uint8x8_t narrowed = vshrn_n_u16(vreinterpretq_u16_u8(matches), 4);
+            uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(narrowed), 0);
+            if (mask != 0) {
+                return i + (std::countr_zero(mask) >> 2);
+            }
+        }
+        
+        ScalarProcessor scalar;
+        return i + scalar.find_byte(data + i, size - i, byte);
+    }
+    
+    [[nodiscard]] size_t count_byte(const std::byte* data, size_t size, uint8_t byte) const noexcept {
+        const uint8x16_t needle = vdupq_n_u8(byte);
+        
+        size_t count = 0;
+        size_t i = 0;
+        
+        for (; i + 16 <= size; i += 16) {
+            uint8x16_t matches = vceqq_u8(vld1q_u8(reinterpret_cast<const uint8_t*>(data + i)), needle);
+            count += vaddvq_u8(vshrq_n_u8(matches, 7));
+        }
+        
+        ScalarProcessor scalar;
+        return count + scalar.count_byte(data + i, size - i, byte);
+    }
+    
+    [[nodiscard]] uint64_t byte_mask64(const std::byte* data, uint8_t byte) const noexcept {
+        const uint8x16_t needle = vdupq_n_u8(byte);
+        const uint8x16_t bits = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+        const uint8_t* ptr = reinterpret_cast<const uint8_t*>(data);
+        
+        uint8x16_t m0 = vandq_u8(vceqq_u8(vld1q_u8(ptr), needle), bits);
+        uint8x16_t m1 = vandq_u8(vceqq_u8(vld1q_u8(ptr + 16), needle), bits);
+        uint8x16_t m2 = vandq_u8(vceqq_u8(vld1q_u8(ptr + 32), needle), bits);
+        uint8x16_t m3 = vandq_u8(vceqq_u8(vld1q_u8(ptr + 48), needle), bits);
+        uint8x16_t sum = vpaddq_u8(vpaddq_u8(m0, m1), vpaddq_u8(m2, m3));
+        sum = vpaddq_u8(sum, sum);
+        return vgetq_lane_u64(vreinterpretq_u64_u8(sum), 0);
+    }
+    
+    [[nodiscard]] size_t identifier_length(const std::byte* data, size_t size,
+                                           uint8_t& seen) const noexcept {
+        return ScalarProcessor{}.identifier_length(data, size, seen);
+    }
+    
     [[nodiscard]] bool matches_keyword(const std::byte* data, size_t size,
                                       const char* keyword, size_t kw_len) const noexcept {
         if (size < kw_len || kw_len > 16) {
@@ -432,6 +1186,97 @@ public:
         
         return true;
     }
+
+    size_t unescape_quotes(const std::byte* data, size_t size, uint8_t quote,
+                           char* out) const noexcept {
+        const uint8x16_t quotes = vdupq_n_u8(quote);
+        const uint8x16_t bit_weights = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+        char* const begin = out;
+        bool pending = false;
+        size_t i = 0;
+
+        for (; i + 16 <= size; i += 16) {
+            uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8_t*>(data + i));
+            uint8x16_t matches = vandq_u8(vceqq_u8(chunk, quotes), bit_weights);
+            uint32_t mask = vaddv_u8(vget_low_u8(matches)) |
+                            (static_cast<uint32_t>(vaddv_u8(vget_high_u8(matches))) << 8);
+
+            if (mask == 0 && !pending) {
+                vst1q_u8(reinterpret_cast<uint8_t*>(out), chunk);
+                out += 16;
+                continue;
+            }
+
+            uint32_t keep = ~static_cast<uint32_t>(doubled_quote_drop_mask(mask, 16, pending));
+            uint32_t lo = keep & 0xFF;
+            uint32_t hi = (keep >> 8) & 0xFF;
+            vst1_u8(reinterpret_cast<uint8_t*>(out),
+                    vtbl1_u8(vget_low_u8(chunk), vcreate_u8(compaction_shuffle_table[lo])));
+            out += std::popcount(lo);
+            vst1_u8(reinterpret_cast<uint8_t*>(out),
+                    vtbl1_u8(vget_high_u8(chunk), vcreate_u8(compaction_shuffle_table[hi])));
+            out += std::popcount(hi);
+        }
+
+        ScalarProcessor scalar;
+        return static_cast<size_t>(out - begin) +
+               scalar.unescape_quotes(data + i, size - i, quote, out, pending);
+    }
+
+    [[nodiscard]] bool validate_utf8(const std::byte* data, size_t size) const noexcept {
+        const uint8x16_t byte_1_high = vld1q_u8(utf8_byte_1_high);
+        const uint8x16_t byte_1_low = vld1q_u8(utf8_byte_1_low);
+        const uint8x16_t byte_2_high = vld1q_u8(utf8_byte_2_high);
+        const uint8x16_t nibble = vdupq_n_u8(0x0F);
+        const uint8x16_t incomplete_max = {
+            255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+            0xF0 - 1, 0xE0 - 1, 0xC0 - 1};
+
+        uint8x16_t error = vdupq_n_u8(0);
+        uint8x16_t prev_input = vdupq_n_u8(0);
+        uint8x16_t prev_incomplete = vdupq_n_u8(0);
+
+        auto check_block = [&](uint8x16_t input) {
+            if (vmaxvq_u8(input) < 0x80) {
+                error = vorrq_u8(error, prev_incomplete);
+                prev_incomplete = vdupq_n_u8(0);
+                prev_input = input;
+                return;
+            }
+
+            uint8x16_t prev1 = vextq_u8(prev_input, input, 15);
+            uint8x16_t prev2 = vextq_u8(prev_input, input, 14);
+            uint8x16_t prev3 = vextq_u8(prev_input, input, 13);
+
+            uint8x16_t special = vandq_u8(
+                vandq_u8(vqtbl1q_u8(byte_1_high, vshrq_n_u8(prev1, 4)),
+                         vqtbl1q_u8(byte_1_low, vandq_u8(prev1, nibble))),
+                vqtbl1q_u8(byte_2_high, vshrq_n_u8(input, 4)));
+
+            uint8x16_t must_be_continuation = vandq_u8(
+                vorrq_u8(vqsubq_u8(prev2, vdupq_n_u8(0xE0 - 0x80)),
+                         vqsubq_u8(prev3, vdupq_n_u8(0xF0 - 0x80))),
+                vdupq_n_u8(0x80));
+
+            error = vorrq_u8(error, veorq_u8(must_be_continuation, special));
+            prev_incomplete = vqsubq_u8(input, incomplete_max);
+            prev_input = input;
+        };
+
+        size_t i = 0;
+        for (; i + 16 <= size; i += 16) {
+            check_block(vld1q_u8(reinterpret_cast<const uint8_t*>(data + i)));
+        }
+
+        if (i < size) {
+            alignas(16) uint8_t tail[16] = {};
+            std::memcpy(tail, data + i, size - i);
+            check_block(vld1q_u8(tail));
+        }
+
+        error = vorrq_u8(error, prev_incomplete);
+        return vmaxvq_u8(error) == 0;
+    }
 };
 
 #endif
@@ -441,12 +1286,19 @@ private:
     SimdLevel level_;
     
 public:
-    SimdDispatcher() : level_(CpuDetection::detect()) {}
+    SimdDispatcher() : level_(CpuDetection::configured_level()) {}
+    
+    // Pins dispatch to `level`, or the highest supported level below it
+    explicit SimdDispatcher(SimdLevel level) : level_(CpuDetection::clamp(level)) {}
     
     template<typename Func>
     auto dispatch(Func&& func) const {
         #if defined(__x86_64__) || defined(_M_X64)
         switch (level_) {
+            #ifdef DB25_HAS_AVX512_VBMI
+            case SimdLevel::AVX512_VBMI:
+                return func(AVX512VbmiProcessor{});
+            #endif
             case SimdLevel::AVX512:
                 return func(AVX512Processor{});
             case SimdLevel::AVX2:
@@ -467,7 +1319,7 @@ public:
     }
     
     [[nodiscard]] SimdLevel level() const noexcept { return level_; }
-    [[nodiscard]] const char* level_name() const noexcept { return CpuDetection::level_name(); }
+    [[nodiscard]] const char* level_name() const noexcept { return CpuDetection::level_name(level_); }
 };
 
 }  // namespace db25
\ No newline at end of file
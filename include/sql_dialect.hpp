@@ -0,0 +1,268 @@
+/*
+ * Copyright (c) 2024 Chiradip Mandal
+ * Author: Chiradip Mandal
+ * Organization: Space-RF.org
+ *
+ * This file is part of DB25 SQL Tokenizer.
+ *
+ * Licensed under the MIT License. See LICENSE file for details.
+ */
+
+#pragma once
+
+// ============================================================================
+// SQL dialect policies
+// ============================================================================
+// A dialect is a stateless policy type that switches lexical features on or
+// off at compile time. BasicSimdTokenizer<Dialect> tests every feature with
+// `if constexpr`, so a disabled feature generates no code at all.
+//
+//   backtick_identifiers  `name`      (MySQL)
+//   bracket_identifiers   [name]      (SQL Server)
+//   hash_comments         # comment   (MySQL)
+//   dollar_quoted_strings $tag$...$tag$ (PostgreSQL)
+//   dollar_identifiers    a$b         '$' continues an identifier (PostgreSQL)
+//   backslash_escapes     'it\'s'     (MySQL, all string literals)
+//   escape_string_prefix  E'it\'s'    (PostgreSQL)
+//   operators             Multi-character operator spellings (2 or 3 bytes)
+//
+// Each dialect gets its own character class table, derived from
+// char_lookup_table, and its own longest-match operator table.
+// ============================================================================
+
+#include "char_classifier.hpp"
+#include "operators.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace db25 {
+
+struct GenericDialect {
+    static constexpr std::string_view name = "Generic";
+    static constexpr bool backtick_identifiers = false;
+    static constexpr bool bracket_identifiers = false;
+    static constexpr bool hash_comments = false;
+    static constexpr bool dollar_quoted_strings = false;
+    static constexpr bool dollar_identifiers = false;
+    static constexpr bool backslash_escapes = false;
+    static constexpr bool escape_string_prefix = false;
+    static constexpr std::array<std::string_view, 20> operators = {{
+        "<=", "<>", ">=", "!=", "==", "||", "&&", "::", "<<", ">>",
+        "->", "->>", "#>", "#>>", "@>", "<@", "<=>", "!~", "!~*", "||/"
+    }};
+};
+
+struct PostgresDialect {
+    static constexpr std::string_view name = "PostgreSQL";
+    static constexpr bool backtick_identifiers = false;
+    static constexpr bool bracket_identifiers = false;
+    static constexpr bool hash_comments = false;
+    static constexpr bool dollar_quoted_strings = true;
+    static constexpr bool dollar_identifiers = true;
+    static constexpr bool backslash_escapes = false;
+    static constexpr bool escape_string_prefix = true;
+    static constexpr std::array<std::string_view, 21> operators = {{
+        "<=", "<>", ">=", "!=", "||", "&&", "::", "<<", ">>",
+        "->", "#>", "@>", "<@", "~*", "!~", "^@",
+        "->>", "#>>", "!~*", "||/", ":="
+    }};
+};
+
+struct MySqlDialect {
+    static constexpr std::string_view name = "MySQL";
+    static constexpr bool backtick_identifiers = true;
+    static constexpr bool bracket_identifiers = false;
+    static constexpr bool hash_comments = true;
+    static constexpr bool dollar_quoted_strings = false;
+    static constexpr bool dollar_identifiers = false;
+    static constexpr bool backslash_escapes = true;
+    static constexpr bool escape_string_prefix = false;
+    static constexpr std::array<std::string_view, 12> operators = {{
+        "<=", "<>", ">=", "!=", "||", "&&", "<<", ">>", ":=", "->",
+        "->>", "<=>"
+    }};
+};
+
+struct SqlServerDialect {
+    static constexpr std::string_view name = "SQL Server";
+    static constexpr bool backtick_identifiers = false;
+    static constexpr bool bracket_identifiers = true;
+    static constexpr bool hash_comments = false;
+    static constexpr bool dollar_quoted_strings = false;
+    static constexpr bool dollar_identifiers = false;
+    static constexpr bool backslash_escapes = false;
+    static constexpr bool escape_string_prefix = false;
+    static constexpr std::array<std::string_view, 15> operators = {{
+        "<=", "<>", ">=", "!=", "!<", "!>", "::",
+        "+=", "-=", "*=", "/=", "%=", "&=", "|=", "^="
+    }};
+};
+
+// Closing delimiter for a quoting character ('[' closes with ']')
+[[nodiscard]] constexpr uint8_t closing_quote(uint8_t opening) noexcept {
+    return opening == '[' ? ']' : opening;
+}
+
+// Backtick and bracket quoting produce identifiers, not string literals
+[[nodiscard]] constexpr bool is_identifier_quote(uint8_t opening) noexcept {
+    return opening == '`' || opening == '[';
+}
+
+// Dense index over the 32 ASCII punctuation bytes (0xFF for all others), so
+// operator tables can use 32-bit rows instead of 256-entry ones.
+inline constexpr std::array<uint8_t, 256> punctuation_index = [] {
+    std::array<uint8_t, 256> index{};
+    uint8_t next = 0;
+    for (size_t ch = 0; ch < 256; ++ch) {
+        bool punct = (ch >= '!' && ch <= '/') || (ch >= ':' && ch <= '@') ||
+                     (ch >= '[' && ch <= '`') || (ch >= '{' && ch <= '~');
+        index[ch] = punct ? next++ : 0xFF;
+    }
+    return index;
+}();
+
+// Longest-match operator table over punctuation indices. pair[i][j] holds
+// the two-byte operator i,j and, when some three-byte operator starts with
+// i,j, a row of `triple` indexed by the third byte.
+struct OperatorTable {
+    struct PairEntry {
+        Operator op = Operator::UNKNOWN;
+        uint8_t triple_row = 0;  // 0 = no three-byte continuation
+    };
+
+    static constexpr size_t kMaxTripleRows = 8;
+
+    std::array<Operator, 32> single{};
+    std::array<std::array<PairEntry, 32>, 32> pair{};
+    std::array<std::array<Operator, 32>, kMaxTripleRows> triple{};
+
+    // Matches the operator at data[0..available) and sets `length` to its
+    // byte count (1 for a lone punctuation byte).
+    [[nodiscard]] constexpr Operator match(const std::byte* data, size_t available,
+                                           size_t& length) const noexcept {
+        uint8_t i = punctuation_index[static_cast<uint8_t>(data[0])];
+        length = 1;
+        if (i == 0xFF) {
+            return Operator::UNKNOWN;
+        }
+        if (available >= 2) {
+            uint8_t j = punctuation_index[static_cast<uint8_t>(data[1])];
+            if (j != 0xFF) {
+                const PairEntry& entry = pair[i][j];
+                if (entry.triple_row != 0 && available >= 3) {
+                    uint8_t k = punctuation_index[static_cast<uint8_t>(data[2])];
+                    // An operator never swallows the start of a /* comment
+                    bool opens_comment = available >= 4 && static_cast<uint8_t>(data[2]) == '/' &&
+                                         static_cast<uint8_t>(data[3]) == '*';
+                    if (k != 0xFF && !opens_comment && triple[entry.triple_row][k] != Operator::UNKNOWN) {
+                        length = 3;
+                        return triple[entry.triple_row][k];
+                    }
+                }
+                if (entry.op != Operator::UNKNOWN) {
+                    length = 2;
+                    return entry.op;
+                }
+            }
+        }
+        return single[i];
+    }
+};
+
+template<typename Dialect>
+[[nodiscard]] constexpr OperatorTable make_operator_table() noexcept {
+    OperatorTable table;
+    for (size_t ch = 0; ch < 256; ++ch) {
+        uint8_t i = punctuation_index[ch];
+        if (i != 0xFF) {
+            char text[1] = {static_cast<char>(ch)};
+            table.single[i] = find_operator(std::string_view(text, 1));
+        }
+    }
+
+    uint8_t rows = 1;
+    for (std::string_view op : Dialect::operators) {
+        Operator id = find_operator(op);
+        uint8_t i = punctuation_index[static_cast<uint8_t>(op[0])];
+        uint8_t j = punctuation_index[static_cast<uint8_t>(op[1])];
+        auto& entry = table.pair[i][j];
+        if (op.size() == 2) {
+            entry.op = id;
+        } else {
+            if (entry.triple_row == 0) {
+                entry.triple_row = rows++;
+            }
+            table.triple[entry.triple_row][punctuation_index[static_cast<uint8_t>(op[2])]] = id;
+        }
+    }
+    return table;
+}
+
+// Rejects dialect operator lists containing unknown spellings or exceeding
+// the three-byte row budget
+template<typename Dialect>
+[[nodiscard]] constexpr bool valid_operator_list() noexcept {
+    size_t prefixes = 0;
+    for (size_t n = 0; n < Dialect::operators.size(); ++n) {
+        std::string_view op = Dialect::operators[n];
+        if (op.size() < 2 || op.size() > 3 || find_operator(op) == Operator::UNKNOWN) {
+            return false;
+        }
+        if (op.size() == 3) {
+            bool seen = false;
+            for (size_t m = 0; m < n; ++m) {
+                std::string_view other = Dialect::operators[m];
+                seen |= other.size() == 3 && other.substr(0, 2) == op.substr(0, 2);
+            }
+            prefixes += seen ? 0 : 1;
+        }
+    }
+    return prefixes < OperatorTable::kMaxTripleRows;
+}
+
+template<typename Dialect>
+[[nodiscard]] constexpr std::array<uint8_t, 256> make_char_table() noexcept {
+    std::array<uint8_t, 256> table{};
+    for (size_t ch = 0; ch < 256; ++ch) {
+        table[ch] = char_lookup_table[ch];
+    }
+    if constexpr (Dialect::backtick_identifiers) {
+        table['`'] = CHAR_QUOTE;
+    }
+    if constexpr (Dialect::bracket_identifiers) {
+        table['['] = CHAR_QUOTE;
+    }
+    return table;
+}
+
+// Compile-time tables and classification helpers for one dialect
+template<typename Dialect>
+struct DialectTraits {
+    alignas(64) static constexpr std::array<uint8_t, 256> char_table = make_char_table<Dialect>();
+    static_assert(valid_operator_list<Dialect>(), "Dialect lists an unknown operator spelling");
+    static constexpr OperatorTable operator_table = make_operator_table<Dialect>();
+
+    static bool is_identifier_start(uint8_t ch) noexcept {
+        return (char_table[ch] & CHAR_IDENT_START) != 0;
+    }
+
+    static bool is_identifier_cont(uint8_t ch) noexcept {
+        return (char_table[ch] & CHAR_IDENT_CONT) != 0;
+    }
+
+    static bool is_digit(uint8_t ch) noexcept {
+        return (char_table[ch] & CHAR_DIGIT) != 0;
+    }
+
+    static bool is_quote(uint8_t ch) noexcept {
+        return (char_table[ch] & CHAR_QUOTE) != 0;
+    }
+
+    static bool is_delimiter(uint8_t ch) noexcept {
+        return (char_table[ch] & CHAR_DELIMITER) != 0;
+    }
+};
+
+}  // namespace db25
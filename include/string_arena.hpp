@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2024 Chiradip Mandal
+ * Author: Chiradip Mandal
+ * Organization: Space-RF.org
+ *
+ * This file is part of DB25 SQL Tokenizer.
+ *
+ * Licensed under the MIT License. See LICENSE file for details.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <algorithm>
+
+namespace db25 {
+
+// Bump allocator for decoded token text (see Token::unescaped).
+// Every allocation is followed by at least kPadding writable bytes so SIMD
+// kernels may store whole vectors past the logical end of their output.
+// Not thread-safe; use one arena per thread or per tokenized batch.
+class StringArena {
+public:
+    static constexpr size_t kPadding = 64;
+    static constexpr size_t kDefaultBlockSize = 4096;
+
+private:
+    struct Block {
+        std::unique_ptr<char[]> data;
+        size_t capacity;
+    };
+
+    std::vector<Block> blocks_;
+    size_t block_size_;
+    size_t current_ = 0;   // Index of the block being filled
+    size_t offset_ = 0;    // Bytes used in the current block
+    size_t bytes_used_ = 0;
+
+public:
+    explicit StringArena(size_t block_size = kDefaultBlockSize) noexcept
+        : block_size_(block_size) {}
+
+    StringArena(const StringArena&) = delete;
+    StringArena& operator=(const StringArena&) = delete;
+    StringArena(StringArena&&) noexcept = default;
+    StringArena& operator=(StringArena&&) noexcept = default;
+
+    [[nodiscard]] char* allocate(size_t size) {
+        while (current_ < blocks_.size()) {
+            Block& block = blocks_[current_];
+            if (offset_ + size + kPadding <= block.capacity) {
+                char* ptr = block.data.get() + offset_;
+                offset_ += size;
+                bytes_used_ += size;
+                return ptr;
+            }
+            ++current_;
+            offset_ = 0;
+        }
+
+        size_t capacity = std::max(block_size_, size + kPadding);
+        blocks_.push_back({std::make_unique<char[]>(capacity), capacity});
+        current_ = blocks_.size() - 1;
+        offset_ = size;
+        bytes_used_ += size;
+        return blocks_.back().data.get();
+    }
+
+    // Releases all allocations but keeps the blocks for reuse.
+    void reset() noexcept {
+        current_ = 0;
+        offset_ = 0;
+        bytes_used_ = 0;
+    }
+
+    [[nodiscard]] size_t bytes_used() const noexcept { return bytes_used_; }
+
+    [[nodiscard]] size_t bytes_reserved() const noexcept {
+        size_t total = 0;
+        for (const auto& block : blocks_) {
+            total += block.capacity;
+        }
+        return total;
+    }
+};
+
+}  // namespace db25
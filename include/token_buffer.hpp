@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2024 Chiradip Mandal
+ * Author: Chiradip Mandal
+ * Organization: Space-RF.org
+ *
+ * This file is part of DB25 SQL Tokenizer.
+ *
+ * Licensed under the MIT License. See LICENSE file for details.
+ */
+
+#pragma once
+
+#include "simd_tokenizer.hpp"
+#include <cstring>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace db25 {
+
+// Tokens together with the input they point into. Every Token::value views
+// the buffer's own copy of the input, so a TokenBuffer can be handed to
+// another thread or pushed through a queue as is, and no token outlives its
+// text. Move-only: a move transfers the input and the token array without
+// touching the tokens, so views stay valid.
+//
+// The input is copied once and tokenized in place with one pass of
+// tokenize(); an exact-size layout would lex the input twice (see
+// count_tokens()), which costs more than the second allocation saves.
+class TokenBuffer {
+private:
+    std::unique_ptr<std::byte[]> input_;
+    size_t input_size_ = 0;
+    std::vector<Token> tokens_;
+
+    template<typename Tokenizer, typename... Level>
+    [[nodiscard]] static TokenBuffer build(std::string_view sql, Level... level) {
+        TokenBuffer buffer;
+        buffer.input_size_ = sql.size();
+        buffer.input_ = std::make_unique_for_overwrite<std::byte[]>(sql.size());
+        if (!sql.empty()) {
+            std::memcpy(buffer.input_.get(), sql.data(), sql.size());
+        }
+        buffer.tokens_ = Tokenizer(buffer.input_.get(), sql.size(), level...).tokenize();
+        return buffer;
+    }
+
+public:
+    TokenBuffer() noexcept = default;
+
+    TokenBuffer(const TokenBuffer&) = delete;
+    TokenBuffer& operator=(const TokenBuffer&) = delete;
+
+    TokenBuffer(TokenBuffer&& other) noexcept
+        : input_(std::move(other.input_))
+        , input_size_(std::exchange(other.input_size_, 0))
+        , tokens_(std::move(other.tokens_)) {}
+
+    TokenBuffer& operator=(TokenBuffer&& other) noexcept {
+        input_ = std::move(other.input_);
+        input_size_ = std::exchange(other.input_size_, 0);
+        tokens_ = std::move(other.tokens_);
+        return *this;
+    }
+
+    // Copies `sql` once and tokenizes the copy; `sql` may be released as
+    // soon as this returns
+    template<typename Tokenizer = SimdTokenizer>
+    [[nodiscard]] static TokenBuffer tokenize(std::string_view sql) {
+        return build<Tokenizer>(sql);
+    }
+
+    // As above with `level` (capped to what the CPU supports)
+    template<typename Tokenizer = SimdTokenizer>
+    [[nodiscard]] static TokenBuffer tokenize(std::string_view sql, SimdLevel level) {
+        return build<Tokenizer>(sql, level);
+    }
+
+    [[nodiscard]] std::span<const Token> tokens() const noexcept { return tokens_; }
+
+    // The owned input; every token value lies within it
+    [[nodiscard]] std::string_view input() const noexcept {
+        return {reinterpret_cast<const char*>(input_.get()), input_size_};
+    }
+
+    [[nodiscard]] size_t size() const noexcept { return tokens_.size(); }
+    [[nodiscard]] bool empty() const noexcept { return tokens_.empty(); }
+    [[nodiscard]] const Token& operator[](size_t index) const noexcept { return tokens_[index]; }
+    [[nodiscard]] const Token* begin() const noexcept { return tokens_.data(); }
+    [[nodiscard]] const Token* end() const noexcept { return tokens_.data() + tokens_.size(); }
+
+    // Bytes owned: token array capacity plus input
+    [[nodiscard]] size_t memory_bytes() const noexcept {
+        return tokens_.capacity() * sizeof(Token) + input_size_;
+    }
+};
+
+}  // namespace db25
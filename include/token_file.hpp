@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2024 Chiradip Mandal
+ * Author: Chiradip Mandal
+ * Organization: Space-RF.org
+ *
+ * This file is part of DB25 SQL Tokenizer.
+ *
+ * Licensed under the MIT License. See LICENSE file for details.
+ */
+
+#pragma once
+
+#include "token_stream.hpp"
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace db25 {
+
+// Token files (.db25tok) cache the tokens of a SQL text on disk.
+// open_token_file() maps the file and checks its header and block index (32
+// bytes per 128 tokens), so reopening reads a small fraction of the file.
+// Tokens are decoded from the mapping a block at a time on access, with no
+// parse or load pass.
+//
+// Layout (host byte order, which the header records; sections aligned to
+// 64 bytes):
+//
+//   header    96 bytes: magic "DB25TOK\0", format version, byte order mark,
+//             kKeywordTableVersion, kOperatorTableVersion, token count,
+//             source size and hash, then section offsets and sizes
+//   blocks    TokenStreamBlock[block count]
+//   bytes     tags and data of the compressed token stream (token_stream.hpp)
+//   source    the SQL text, unless written with embed_source = false
+//
+// A file whose keyword or operator table differs from the one compiled in
+// is rejected, since token IDs would decode to the wrong keywords.
+enum class TokenFileError : uint8_t {
+    Io,                   // Cannot open, map, read or write the file
+    NotATokenFile,        // Wrong magic or shorter than the header
+    UnsupportedVersion,   // Other format version or byte order
+    TableMismatch,        // Written with another keyword or operator table
+    Corrupt               // Sections outside the file, inconsistent counts or block index
+};
+
+[[nodiscard]] std::string_view token_file_error_name(TokenFileError error) noexcept;
+
+struct TokenFileOptions {
+    // Store the SQL text in the file. Without it the file holds only its size
+    // and hash, and tokens are decoded against a copy the caller keeps.
+    bool embed_source = true;
+};
+
+// 64-bit content hash of a SQL text as recorded in token files; fast, not
+// cryptographic
+[[nodiscard]] uint64_t token_source_hash(std::string_view source) noexcept;
+
+// An open token file. Move-only; the mapping is released on destruction, so
+// tokens decoded against source() must not outlive it.
+class TokenFile {
+public:
+    TokenFile() noexcept = default;
+    ~TokenFile();
+
+    TokenFile(const TokenFile&) = delete;
+    TokenFile& operator=(const TokenFile&) = delete;
+    TokenFile(TokenFile&& other) noexcept;
+    TokenFile& operator=(TokenFile&& other) noexcept;
+
+    // The compressed tokens, read in place from the mapping
+    [[nodiscard]] const TokenStreamView& stream() const noexcept { return stream_; }
+
+    // The embedded SQL text; empty if the file was written without it
+    [[nodiscard]] bool has_source() const noexcept { return has_source_; }
+    [[nodiscard]] std::string_view source() const noexcept { return source_; }
+    [[nodiscard]] uint64_t source_hash() const noexcept { return source_hash_; }
+
+    // Tokens viewing the embedded source. Without one, decode through
+    // stream() against the caller's copy of the text.
+    [[nodiscard]] std::vector<Token> tokens() const { return stream_.decode(source_); }
+    [[nodiscard]] Token token(size_t index) const { return stream_.token(index, source_); }
+    [[nodiscard]] size_t size() const noexcept { return stream_.size(); }
+
+    // Whether `source` is the text the file was written from (size and hash)
+    [[nodiscard]] bool matches(std::string_view source) const noexcept;
+
+    // Full integrity check: every token lies within the source and the
+    // embedded source hashes to the recorded value. Reads the whole file;
+    // opening checks only what decoding needs to stay within the mapping.
+    [[nodiscard]] bool verify() const noexcept;
+
+    [[nodiscard]] size_t file_size() const noexcept { return size_; }
+
+private:
+    friend std::expected<TokenFile, TokenFileError> open_token_file(const std::filesystem::path& path);
+
+    const std::byte* data_ = nullptr;   // Mapping of the whole file
+    size_t size_ = 0;
+    TokenStreamView stream_;
+    std::string_view source_;
+    bool has_source_ = false;
+    uint64_t source_hash_ = 0;
+
+    void release() noexcept;
+};
+
+// Writes `tokens`, produced by a tokenizer over `source`, to `path`. The
+// file is written under a unique temporary name in the same directory,
+// flushed to disk and renamed into place, so readers never see a partial
+// file, even after a crash.
+[[nodiscard]] std::expected<void, TokenFileError> write_token_file(
+    const std::filesystem::path& path, std::span<const Token> tokens, std::string_view source,
+    TokenFileOptions options = {});
+
+// Maps `path` and checks its header and block index
+[[nodiscard]] std::expected<TokenFile, TokenFileError> open_token_file(const std::filesystem::path& path);
+
+}  // namespace db25
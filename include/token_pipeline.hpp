@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2024 Chiradip Mandal
+ * Author: Chiradip Mandal
+ * Organization: Space-RF.org
+ *
+ * This file is part of DB25 SQL Tokenizer.
+ *
+ * Licensed under the MIT License. See LICENSE file for details.
+ */
+
+#pragma once
+
+#include "simd_tokenizer.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <thread>
+
+namespace db25 {
+
+// Single-producer, single-consumer ring of token blocks. The tokenizer
+// thread fills blocks in place through the TokenBlockSink interface; the
+// consumer thread reads them in order with next(). The two threads share
+// only the head and tail block counters, each on its own cache line, so
+// synchronization is one release store and one acquire load per block.
+// A full ring makes the producer wait, an empty one the consumer
+// (std::atomic::wait, so neither spins).
+class TokenRing final : public TokenBlockSink {
+public:
+    // `blocks` is rounded up to a power of two
+    TokenRing(size_t block_tokens, size_t blocks);
+
+    TokenRing(const TokenRing&) = delete;
+    TokenRing& operator=(const TokenRing&) = delete;
+
+    // Producer side
+    std::span<Token> acquire() override;
+    void publish(size_t count, bool last) override;
+
+    // Consumer side. Returns the next block, waiting for it if needed, and
+    // hands the previous one back to the producer; empty after the last
+    // block. The span is valid until the next call.
+    [[nodiscard]] std::span<const Token> next();
+    // Discards unread blocks and stops the producer at its next block
+    void close();
+
+    [[nodiscard]] size_t block_tokens() const noexcept { return block_tokens_; }
+    [[nodiscard]] size_t capacity() const noexcept { return mask_ + 1; }
+
+private:
+    struct Slot {
+        size_t count = 0;
+        bool last = false;
+    };
+
+    size_t block_tokens_;
+    size_t mask_;
+    std::unique_ptr<Token[]> tokens_;
+    std::unique_ptr<Slot[]> slots_;
+
+    alignas(64) std::atomic<size_t> head_{0};   // Blocks released by the consumer
+    alignas(64) std::atomic<size_t> tail_{0};   // Blocks published by the producer
+    alignas(64) std::atomic<bool> closed_{false};
+
+    // Consumer-only state
+    bool holding_ = false;    // The block at head_ was returned by next()
+    bool finished_ = false;
+};
+
+// Tokenizes `sql` into `sink` with `Tokenizer`; the default for
+// TokenPipelineOptions::tokenize
+template<typename Tokenizer = SimdTokenizer>
+size_t tokenize_blocks(std::string_view sql, TokenBlockSink& sink) {
+    Tokenizer tokenizer(reinterpret_cast<const std::byte*>(sql.data()), sql.size());
+    return tokenizer.tokenize_blocks(sink);
+}
+
+struct TokenPipelineOptions {
+    size_t block_tokens = 512;   // Tokens per block (24 KB of Token)
+    size_t ring_blocks = 8;      // Blocks the tokenizer may run ahead
+    // Tokenizer, e.g. &tokenize_blocks<PostgresTokenizer>
+    size_t (*tokenize)(std::string_view, TokenBlockSink&) = &tokenize_blocks<SimdTokenizer>;
+};
+
+// Tokenizes a script on a background thread while the caller consumes the
+// tokens, so lexing block N+1 overlaps with parsing block N:
+//
+//     TokenPipeline pipeline(sql);
+//     while (auto block = pipeline.next(); !block.empty()) {
+//         parser.feed(block);
+//     }
+//
+// Tokens view `sql`, which must outlive them. Destroying the pipeline
+// before the last block stops the tokenizer.
+class TokenPipeline {
+public:
+    explicit TokenPipeline(std::string_view sql, TokenPipelineOptions options = {});
+    ~TokenPipeline();
+
+    TokenPipeline(const TokenPipeline&) = delete;
+    TokenPipeline& operator=(const TokenPipeline&) = delete;
+
+    // The next block of tokens, in input order; empty after the last one
+    [[nodiscard]] std::span<const Token> next() { return ring_.next(); }
+
+private:
+    TokenRing ring_;
+    std::thread producer_;
+};
+
+}  // namespace db25
@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2024 Chiradip Mandal
+ * Author: Chiradip Mandal
+ * Organization: Space-RF.org
+ *
+ * This file is part of DB25 SQL Tokenizer.
+ *
+ * Licensed under the MIT License. See LICENSE file for details.
+ */
+
+#pragma once
+
+#include "simd_tokenizer.hpp"
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace db25 {
+
+// Token fields in columns (structure of arrays), decoded without the source
+// text: enough for keyword or operator statistics over a query log
+struct TokenColumns {
+    std::vector<TokenType> types;
+    std::vector<uint64_t> offsets;   // Byte offset of each token in the source
+    std::vector<uint64_t> lengths;
+    std::vector<Keyword> keywords;
+    std::vector<Operator> operators;
+    std::vector<uint8_t> flags;
+
+    [[nodiscard]] size_t size() const noexcept { return types.size(); }
+};
+
+// Tokens compressed for retention, at about 2-3 bytes per token instead of
+// sizeof(Token). The stream stores token extents, not text: decoding takes
+// the source the tokens were produced from and rebuilds every Token::value
+// as a view into it.
+//
+// Tokens are grouped in blocks of kBlockTokens. A block header holds the
+// offset, line and column of its first token, so any block decodes on its
+// own. Inside a block, one tag byte per token comes first (kind, gap width,
+// length width), followed by the data bytes of all tokens:
+//
+//   - the gap from the previous token's end: 0 or 1 in the tag, else 1 or 8 bytes
+//   - the length: 1, 2 or 8 bytes, or none when the keyword or operator
+//     ID spells it out
+//   - the keyword or operator ID, or the flags when they are set
+//
+// As in streamvbyte, widths come from the tag alone, so decoding is table
+// lookups and fixed-width loads with no per-byte continuation checks. Line
+// and column are recounted from the source the way the tokenizer counts them.
+class CompressedTokenStream;
+
+// Block header of a compressed token stream. The layout is part of the
+// .db25tok file format (see token_file.hpp).
+struct TokenStreamBlock {
+    uint64_t offset;   // Source offset of the first token
+    uint64_t line;     // Line and column of the first token
+    uint64_t column;
+    uint64_t data;     // Index of the block's first tag in the stream bytes
+};
+
+// Decoder over compressed blocks held elsewhere: a CompressedTokenStream or
+// a mapped token file. Cheap to copy; the memory must outlive it.
+class TokenStreamView {
+public:
+    static constexpr size_t kBlockTokens = 128;
+
+    TokenStreamView() = default;
+    // `bytes` includes the stream's trailing padding
+    TokenStreamView(std::span<const TokenStreamBlock> blocks, std::span<const uint8_t> bytes,
+                    size_t token_count, size_t source_size) noexcept
+        : blocks_(blocks), bytes_(bytes), token_count_(token_count), source_size_(source_size) {}
+
+    // All tokens, viewing `source`, which must be the text that was encoded;
+    // values never extend past the end of a shorter `source`
+    [[nodiscard]] std::vector<Token> decode(std::string_view source) const;
+
+    // Tokens of block `block` into `out`, which has room for them
+    // (kBlockTokens, fewer in the last block); returns the number written
+    size_t decode_block(size_t block, std::string_view source, std::span<Token> out) const;
+
+    // Token `index`, decoding only its block
+    [[nodiscard]] Token token(size_t index, std::string_view source) const;
+
+    // All tokens without line, column or text
+    [[nodiscard]] TokenColumns decode_columns() const;
+
+    // Whether the block headers are in order and within the text, and each
+    // block's tags and data lie within the bytes. Decoding relies on it, so
+    // check streams that come from untrusted storage; costs O(blocks).
+    [[nodiscard]] bool valid_blocks() const noexcept;
+
+    // valid_blocks(), and every token in order, within the text and with
+    // known type and IDs. Decodes the whole stream.
+    [[nodiscard]] bool valid() const noexcept;
+
+    [[nodiscard]] size_t size() const noexcept { return token_count_; }
+    [[nodiscard]] bool empty() const noexcept { return token_count_ == 0; }
+    [[nodiscard]] size_t block_count() const noexcept { return blocks_.size(); }
+    [[nodiscard]] size_t source_size() const noexcept { return source_size_; }
+    [[nodiscard]] std::span<const TokenStreamBlock> blocks() const noexcept { return blocks_; }
+    [[nodiscard]] std::span<const uint8_t> bytes() const noexcept { return bytes_; }
+
+    // Bytes used: block headers, tags and data
+    [[nodiscard]] size_t memory_bytes() const noexcept {
+        return blocks_.size() * sizeof(TokenStreamBlock) + bytes_.size();
+    }
+
+private:
+    friend class CompressedTokenStream;
+
+    std::span<const TokenStreamBlock> blocks_;
+    std::span<const uint8_t> bytes_;
+    size_t token_count_ = 0;
+    size_t source_size_ = 0;
+
+    template<typename Sink>
+    void decode_extents(size_t block, Sink&& sink) const;
+};
+
+class CompressedTokenStream {
+public:
+    static constexpr size_t kBlockTokens = TokenStreamView::kBlockTokens;
+
+    CompressedTokenStream() = default;
+
+    // `tokens` as produced by a tokenizer over `source`
+    [[nodiscard]] static CompressedTokenStream encode(std::span<const Token> tokens, std::string_view source);
+
+    [[nodiscard]] TokenStreamView view() const noexcept {
+        return {blocks_, bytes_, token_count_, source_size_};
+    }
+
+    // See TokenStreamView
+    [[nodiscard]] std::vector<Token> decode(std::string_view source) const { return view().decode(source); }
+    size_t decode_block(size_t block, std::string_view source, std::span<Token> out) const {
+        return view().decode_block(block, source, out);
+    }
+    [[nodiscard]] Token token(size_t index, std::string_view source) const { return view().token(index, source); }
+    [[nodiscard]] TokenColumns decode_columns() const { return view().decode_columns(); }
+
+    [[nodiscard]] size_t size() const noexcept { return token_count_; }
+    [[nodiscard]] bool empty() const noexcept { return token_count_ == 0; }
+    [[nodiscard]] size_t block_count() const noexcept { return blocks_.size(); }
+    [[nodiscard]] size_t source_size() const noexcept { return source_size_; }
+
+    // Bytes owned: block headers, tags and data
+    [[nodiscard]] size_t memory_bytes() const noexcept { return view().memory_bytes(); }
+
+private:
+    std::vector<TokenStreamBlock> blocks_;
+    std::vector<uint8_t> bytes_;   // Tags and data of every block, then padding
+    size_t token_count_ = 0;
+    size_t source_size_ = 0;
+};
+
+}  // namespace db25
@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2024 Chiradip Mandal
+ * Author: Chiradip Mandal
+ * Organization: Space-RF.org
+ *
+ * This file is part of DB25 SQL Tokenizer.
+ *
+ * Licensed under the MIT License. See LICENSE file for details.
+ */
+
+#pragma once
+
+#include "token_buffer.hpp"
+#include "token_stream.hpp"
+#include <chrono>
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace db25 {
+
+// A tokenizer daemon shared by the processes of one host through POSIX
+// shared memory. The segment holds a fixed number of request slots, each
+// with room for one SQL text and its compressed tokens (token_stream.hpp):
+//
+//   client   takes a free slot, copies the SQL into it and queues the slot
+//   daemon   tokenizes the text, writes the compressed tokens into the same
+//            slot and wakes the client
+//   client   decodes the tokens in place, viewing the SQL in the slot, and
+//            frees the slot when the TokenizedQuery is destroyed
+//
+// Slots move between processes through two lock-free queues of slot indices
+// (free and submitted); waiting uses futexes on Linux and short sleeps
+// elsewhere. No sockets are involved and nothing is serialized. The daemon
+// keeps its most recent results, so a text sent by several processes (a
+// pooler, an audit agent and an exporter seeing the same query stream) is
+// tokenized once per host.
+//
+// Slots of clients that exit without freeing them are reclaimed by the
+// daemon. Requires POSIX shared memory; elsewhere every call fails with
+// Unsupported.
+enum class TokenizerServiceError : uint8_t {
+    Unsupported,        // No POSIX shared memory on this platform
+    Io,                 // Cannot create, open or map the segment
+    NotRunning,         // No daemon under that name, or it has stopped
+    AlreadyRunning,     // A live daemon already serves that name
+    VersionMismatch,    // Other segment layout or keyword/operator tables
+    RequestTooLarge,    // SQL longer than the daemon's request_bytes
+    ResponseTooLarge,   // Compressed tokens longer than the daemon's response_bytes
+    Timeout             // No free slot or no reply within the client's timeout
+};
+
+[[nodiscard]] std::string_view tokenizer_service_error_name(TokenizerServiceError error) noexcept;
+
+// Shared memory object name used when none is given
+inline constexpr std::string_view kDefaultTokenizerService = "/db25-tokenizer";
+
+struct TokenizerDaemonOptions {
+    size_t slots = 64;                        // Requests in flight across all clients
+    size_t request_bytes = size_t{1} << 20;   // Longest SQL text per request
+    size_t response_bytes = size_t{1} << 20;  // Compressed tokens per request
+    size_t cache_bytes = size_t{64} << 20;    // Recent results kept for repeated texts; 0 disables
+    uint32_t permissions = 0600;              // Of the shared memory object
+    // Tokenizer, e.g. &TokenBuffer::tokenize<PostgresTokenizer>
+    TokenBuffer (*tokenize)(std::string_view) = &TokenBuffer::tokenize<SimdTokenizer>;
+};
+
+struct TokenizerServiceStats {
+    uint64_t requests = 0;     // Answered, including errors
+    uint64_t cache_hits = 0;   // Answered from the daemon's cache
+    uint64_t errors = 0;       // Answered with ResponseTooLarge
+    uint64_t reclaimed = 0;    // Slots taken back from exited clients
+};
+
+class TokenizerDaemon {
+public:
+    // Creates the shared memory segment `name` (leading '/', as for
+    // shm_open). A segment left behind by a daemon that died is replaced.
+    [[nodiscard]] static std::expected<TokenizerDaemon, TokenizerServiceError> create(
+        std::string_view name = kDefaultTokenizerService, TokenizerDaemonOptions options = {});
+
+    TokenizerDaemon(TokenizerDaemon&&) noexcept;
+    TokenizerDaemon& operator=(TokenizerDaemon&&) noexcept;
+    // Removes the segment; clients still connected get NotRunning
+    ~TokenizerDaemon();
+
+    // Serves requests on the calling thread until stop(), then answers the
+    // requests already queued, removes the name and returns; a new daemon
+    // may take the name from then on
+    void run();
+    // Callable from any thread and from signal handlers
+    void stop() noexcept;
+
+    [[nodiscard]] TokenizerServiceStats stats() const noexcept;
+    [[nodiscard]] const std::string& name() const noexcept;
+
+private:
+    struct State;
+    std::unique_ptr<State> state_;
+
+    explicit TokenizerDaemon(std::unique_ptr<State> state) noexcept;
+};
+
+class TokenizerClient;
+
+// The daemon's answer to one request. Holds its slot until destroyed, so
+// tokens decoded from it may view sql(); must not outlive its client.
+class TokenizedQuery {
+public:
+    TokenizedQuery() noexcept = default;
+    ~TokenizedQuery();
+
+    TokenizedQuery(const TokenizedQuery&) = delete;
+    TokenizedQuery& operator=(const TokenizedQuery&) = delete;
+    TokenizedQuery(TokenizedQuery&& other) noexcept;
+    TokenizedQuery& operator=(TokenizedQuery&& other) noexcept;
+
+    // The request text, in shared memory
+    [[nodiscard]] std::string_view sql() const noexcept { return sql_; }
+    // The compressed tokens, read in place
+    [[nodiscard]] const TokenStreamView& stream() const noexcept { return stream_; }
+
+    [[nodiscard]] std::vector<Token> tokens() const { return stream_.decode(sql_); }
+    [[nodiscard]] Token token(size_t index) const { return stream_.token(index, sql_); }
+    [[nodiscard]] size_t size() const noexcept { return stream_.size(); }
+    // Served from the daemon's cache rather than tokenized for this request
+    [[nodiscard]] bool cached() const noexcept { return cached_; }
+
+private:
+    friend class TokenizerClient;
+
+    std::byte* segment_ = nullptr;
+    size_t slot_ = 0;
+    std::string_view sql_;
+    TokenStreamView stream_;
+    bool cached_ = false;
+
+    void release() noexcept;
+};
+
+struct TokenizerClientOptions {
+    // Longest wait for a free slot plus the reply
+    std::chrono::milliseconds timeout{5000};
+};
+
+// A connection to a running daemon. Thread-safe: any number of threads may
+// call tokenize() on one client.
+class TokenizerClient {
+public:
+    [[nodiscard]] static std::expected<TokenizerClient, TokenizerServiceError> connect(
+        std::string_view name = kDefaultTokenizerService, TokenizerClientOptions options = {});
+
+    TokenizerClient(const TokenizerClient&) = delete;
+    TokenizerClient& operator=(const TokenizerClient&) = delete;
+    TokenizerClient(TokenizerClient&& other) noexcept;
+    TokenizerClient& operator=(TokenizerClient&& other) noexcept;
+    ~TokenizerClient();
+
+    // Sends `sql` to the daemon and waits for its tokens
+    [[nodiscard]] std::expected<TokenizedQuery, TokenizerServiceError> tokenize(std::string_view sql) const;
+
+    [[nodiscard]] TokenizerServiceStats stats() const noexcept;
+    // Largest text tokenize() accepts
+    [[nodiscard]] size_t max_request_bytes() const noexcept;
+
+private:
+    std::byte* segment_ = nullptr;   // Mapping of the whole segment
+    size_t size_ = 0;
+    TokenizerClientOptions options_;
+
+    TokenizerClient() noexcept = default;
+    void release() noexcept;
+};
+
+}  // namespace db25
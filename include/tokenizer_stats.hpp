@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2024 Chiradip Mandal
+ * Author: Chiradip Mandal
+ * Organization: Space-RF.org
+ *
+ * This file is part of DB25 SQL Tokenizer.
+ *
+ * Licensed under the MIT License. See LICENSE file for details.
+ */
+
+#pragma once
+
+// ============================================================================
+// Tokenizer statistics
+// ============================================================================
+// Statistics are a policy of BasicSimdTokenizer:
+//
+//   NoStats       Default. Empty; every hook compiles away.
+//   CountStats    Tokens and bytes per token type, keyword lookups and hits.
+//   ProfileStats  CountStats plus CycleClock ticks per tokenizer phase.
+//
+// A tokenizer accumulates into plain members and publishes once per
+// tokenize() call into a block owned by the calling thread. Each block has
+// a single writer, so publishing uses relaxed loads and stores (plain moves,
+// no locked instructions). StatsRegistry::snapshot() sums the blocks of all
+// threads plus those of threads that have exited.
+//
+// Building with -DENABLE_STATS=ON (DB25_ENABLE_STATS=1) makes CountStats the
+// default policy and -DENABLE_STATS_TIMING=ON (DB25_ENABLE_STATS=2) makes
+// it ProfileStats.
+// ============================================================================
+
+#include "cycle_clock.hpp"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace db25 {
+
+// Number of TokenType values (checked in simd_tokenizer.hpp)
+inline constexpr size_t kTokenTypeCount = 10;
+
+// Timed phases. Phases nest: Tokenize covers the whole call and
+// KeywordLookup is part of Identifier.
+enum class StatsPhase : uint8_t {
+    Tokenize,
+    Whitespace,
+    Identifier,
+    KeywordLookup,
+    Number,
+    String,
+    Comment,
+    Operator,
+    Count
+};
+
+inline constexpr size_t kStatsPhaseCount = static_cast<size_t>(StatsPhase::Count);
+
+[[nodiscard]] std::string_view stats_phase_name(StatsPhase phase) noexcept;
+
+// Point-in-time totals; also the per-call accumulator of CountStats
+struct StatsSnapshot {
+    uint64_t calls = 0;            // tokenize() calls
+    uint64_t input_bytes = 0;
+    std::array<uint64_t, kTokenTypeCount> tokens{};
+    std::array<uint64_t, kTokenTypeCount> bytes{};  // Whitespace: skipped bytes
+    uint64_t keyword_lookups = 0;
+    uint64_t keyword_hits = 0;
+    std::array<uint64_t, kStatsPhaseCount> phase_ticks{};
+    std::array<uint64_t, kStatsPhaseCount> phase_calls{};
+
+    StatsSnapshot& merge(const StatsSnapshot& other) noexcept;
+
+    [[nodiscard]] uint64_t total_tokens() const noexcept;
+    [[nodiscard]] double keyword_hit_rate() const noexcept;
+    [[nodiscard]] double phase_seconds(StatsPhase phase) const noexcept;
+
+    // Prometheus text exposition format (version 0.0.4)
+    [[nodiscard]] std::string to_prometheus(std::string_view prefix = "db25_tokenizer") const;
+};
+
+// Per-thread published totals (single writer: the owning thread)
+class StatsBlock {
+private:
+    static constexpr size_t kSlots = sizeof(StatsSnapshot) / sizeof(uint64_t);
+    static_assert(sizeof(StatsSnapshot) == kSlots * sizeof(uint64_t), "StatsSnapshot must be all uint64_t");
+
+    std::array<std::atomic<uint64_t>, kSlots> slots_{};
+
+public:
+    void add(const StatsSnapshot& delta) noexcept;
+    [[nodiscard]] StatsSnapshot load() const noexcept;
+    void clear() noexcept;
+};
+
+class StatsRegistry {
+public:
+    // All threads, including threads that have exited
+    [[nodiscard]] static StatsSnapshot snapshot();
+    // The calling thread only
+    [[nodiscard]] static StatsSnapshot thread_snapshot();
+    // Zero every block. Counts published concurrently may survive.
+    static void reset();
+    // Block of the calling thread, registered on first use
+    [[nodiscard]] static StatsBlock& local();
+};
+
+// ---------------------------------------------------------------------------
+// Policies
+// ---------------------------------------------------------------------------
+
+class NoStats {
+public:
+    static constexpr bool enabled = false;
+
+    struct Scope {
+        constexpr Scope(NoStats&, StatsPhase) noexcept {}
+    };
+
+    template<typename TokenT>
+    constexpr void count_token(const TokenT&) noexcept {}
+    constexpr void count_whitespace(size_t) noexcept {}
+    constexpr void count_keyword_lookup(bool) noexcept {}
+    constexpr void count_input(size_t) noexcept {}
+    constexpr void publish() noexcept {}
+    constexpr void discard() noexcept {}
+};
+
+class CountStats {
+protected:
+    StatsSnapshot pending_;
+
+public:
+    static constexpr bool enabled = true;
+
+    struct Scope {
+        constexpr Scope(CountStats&, StatsPhase) noexcept {}
+    };
+
+    template<typename TokenT>
+    void count_token(const TokenT& token) noexcept {
+        size_t type = static_cast<size_t>(token.type);
+        ++pending_.tokens[type];
+        pending_.bytes[type] += token.value.size();
+    }
+
+    void count_whitespace(size_t bytes) noexcept {
+        pending_.bytes[kWhitespaceType] += bytes;
+    }
+
+    void count_keyword_lookup(bool hit) noexcept {
+        ++pending_.keyword_lookups;
+        pending_.keyword_hits += hit;
+    }
+
+    void count_input(size_t bytes) noexcept {
+        ++pending_.calls;
+        pending_.input_bytes += bytes;
+    }
+
+    void publish() noexcept {
+        StatsRegistry::local().add(pending_);
+        pending_ = {};
+    }
+
+    // Drops everything counted since the last publish()
+    void discard() noexcept {
+        pending_ = {};
+    }
+
+    static constexpr size_t kWhitespaceType = 7;  // TokenType::Whitespace
+};
+
+class ProfileStats : public CountStats {
+public:
+    class Scope {
+    private:
+        ProfileStats& stats_;
+        size_t phase_;
+        uint64_t start_;
+
+    public:
+        Scope(ProfileStats& stats, StatsPhase phase) noexcept
+            : stats_(stats), phase_(static_cast<size_t>(phase)), start_(CycleClock::now()) {}
+
+        ~Scope() {
+            stats_.pending_.phase_ticks[phase_] += CycleClock::now() - start_;
+            ++stats_.pending_.phase_calls[phase_];
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+};
+
+#if defined(DB25_ENABLE_STATS) && DB25_ENABLE_STATS >= 2
+using DefaultStats = ProfileStats;
+#elif defined(DB25_ENABLE_STATS) && DB25_ENABLE_STATS
+using DefaultStats = CountStats;
+#else
+using DefaultStats = NoStats;
+#endif
+
+}  // namespace db25
@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2024 Chiradip Mandal
+ * Author: Chiradip Mandal
+ * Organization: Space-RF.org
+ *
+ * This file is part of DB25 SQL Tokenizer.
+ *
+ * Licensed under the MIT License. See LICENSE file for details.
+ */
+
+#pragma once
+
+// ============================================================================
+// Scoped tracing
+// ============================================================================
+// DB25_TRACE_SCOPE("name") records a complete event (begin and duration) for
+// the enclosing scope into a ring buffer owned by the calling thread. The
+// owner is the ring's only writer, so recording takes no lock and no locked
+// instruction; once a ring is full the oldest events are overwritten.
+// Tracer::chrome_json() dumps every thread's ring as Chrome trace-event JSON,
+// which loads in Perfetto (ui.perfetto.dev) and chrome://tracing.
+//
+// The tokenizer traces its phases, token-vector growth and each tokenize()
+// call; callers add their own scopes for batches or parallel chunks. Scopes
+// are compiled in only with -DENABLE_TRACING=ON (DB25_ENABLE_TRACING) and
+// record only while Tracer::set_enabled(true).
+// ============================================================================
+
+#include "cycle_clock.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace db25 {
+
+#ifdef DB25_ENABLE_TRACING
+inline constexpr bool kTracingCompiled = true;
+#else
+inline constexpr bool kTracingCompiled = false;
+#endif
+
+// Single-writer ring of complete events
+class TraceRing {
+public:
+    static constexpr size_t kDefaultCapacity = size_t{1} << 16;
+
+    struct Event {
+        std::atomic<const char*> name{nullptr};  // Static string
+        std::atomic<uint64_t> begin{0};          // CycleClock ticks
+        std::atomic<uint64_t> end{0};
+        std::atomic<uint64_t> arg{0};            // Optional size (e.g. bytes)
+    };
+
+    struct Copy {
+        const char* name;
+        uint64_t begin;
+        uint64_t end;
+        uint64_t arg;
+    };
+
+private:
+    std::unique_ptr<Event[]> events_;
+    size_t mask_;
+    std::atomic<uint64_t> begun_{0};  // Events whose write has started
+    std::atomic<uint64_t> head_{0};   // Events fully recorded
+    uint32_t thread_id_;
+    std::string thread_name_;
+
+public:
+    TraceRing(uint32_t thread_id, size_t capacity = kDefaultCapacity);
+
+    // Owner thread only
+    void record(const char* name, uint64_t begin, uint64_t end, uint64_t arg) noexcept {
+        uint64_t head = head_.load(std::memory_order_relaxed);
+        begun_.store(head + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        Event& event = events_[head & mask_];
+        event.name.store(name, std::memory_order_relaxed);
+        event.begin.store(begin, std::memory_order_relaxed);
+        event.end.store(end, std::memory_order_relaxed);
+        event.arg.store(arg, std::memory_order_relaxed);
+        head_.store(head + 1, std::memory_order_release);
+    }
+
+    // Events still in the ring, oldest first. Safe while the owner records:
+    // slots that may have been overwritten during the copy are dropped.
+    [[nodiscard]] size_t copy(Copy* out) const noexcept;
+
+    [[nodiscard]] size_t capacity() const noexcept { return mask_ + 1; }
+    [[nodiscard]] uint64_t recorded() const noexcept { return head_.load(std::memory_order_acquire); }
+    [[nodiscard]] uint32_t thread_id() const noexcept { return thread_id_; }
+    [[nodiscard]] const std::string& thread_name() const noexcept { return thread_name_; }  // Registry lock
+
+    void clear() noexcept {
+        head_.store(0, std::memory_order_relaxed);
+        begun_.store(0, std::memory_order_release);
+    }
+    void set_thread_name(std::string name) { thread_name_ = std::move(name); }  // Registry lock
+};
+
+class Tracer {
+private:
+    static inline std::atomic<bool> enabled_{false};
+
+public:
+    [[nodiscard]] static bool enabled() noexcept { return enabled_.load(std::memory_order_relaxed); }
+    static void set_enabled(bool enabled) noexcept { enabled_.store(enabled, std::memory_order_relaxed); }
+
+    // Ring of the calling thread, registered on first use. Rings outlive
+    // their threads so a dump still shows threads that have exited.
+    [[nodiscard]] static TraceRing& local();
+
+    // Capacity of rings created after the call (rounded up to a power of two)
+    static void set_ring_capacity(size_t events);
+
+    // Label of the calling thread's track in the trace viewer
+    static void set_thread_name(std::string name);
+
+    // Chrome trace-event JSON ({"traceEvents": [...]}) of every ring
+    [[nodiscard]] static std::string chrome_json();
+    static bool write_chrome_json(const std::string& path);
+
+    // Empties all rings and forgets rings of exited threads. Events recorded
+    // concurrently may survive.
+    static void clear();
+};
+
+// Records the enclosing scope if tracing is enabled at construction
+class TraceScope {
+private:
+    const char* name_;
+    uint64_t arg_;
+    uint64_t begin_;
+
+public:
+    explicit TraceScope(const char* name, uint64_t arg = 0) noexcept
+        : name_(Tracer::enabled() ? name : nullptr), arg_(arg), begin_(name_ ? CycleClock::now() : 0) {}
+
+    ~TraceScope() {
+        if (name_) {
+            Tracer::local().record(name_, begin_, CycleClock::now(), arg_);
+        }
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+};
+
+}  // namespace db25
+
+#define DB25_TRACE_CONCAT_(a, b) a##b
+#define DB25_TRACE_CONCAT(a, b) DB25_TRACE_CONCAT_(a, b)
+
+// DB25_TRACE_SCOPE(name [, arg]): `name` must be a string with static storage
+#ifdef DB25_ENABLE_TRACING
+#define DB25_TRACE_SCOPE(...) \
+    ::db25::TraceScope DB25_TRACE_CONCAT(db25_trace_scope_, __LINE__)(__VA_ARGS__)
+#else
+#define DB25_TRACE_SCOPE(...) static_cast<void>(0)
+#endif
@@ -0,0 +1,553 @@
+/*
+ * Copyright (c) 2024 Chiradip Mandal
+ * Author: Chiradip Mandal
+ * Organization: Space-RF.org
+ *
+ * This file is part of DB25 SQL Tokenizer.
+ *
+ * Licensed under the MIT License. See LICENSE file for details.
+ */
+
+#include "file_pipeline.hpp"
+#include <algorithm>
+#include <fstream>
+#include <utility>
+
+#ifdef DB25_HAS_IO_URING
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace db25 {
+
+std::string_view io_backend_name(IoBackend backend) noexcept {
+    switch (backend) {
+        case IoBackend::Auto: return "auto";
+        case IoBackend::IoUring: return "io_uring";
+        case IoBackend::Threads: return "threads";
+    }
+    return "unknown";
+}
+
+#ifdef DB25_HAS_IO_URING
+
+// Submission and completion rings of one io_uring, driven with the raw
+// system calls so there is no liburing dependency. Only the reader thread
+// touches it.
+struct FilePipeline::IoRing {
+    int fd = -1;
+    void* rings = MAP_FAILED;
+    size_t rings_size = 0;
+    void* completion_ring = MAP_FAILED;   // Separate mapping on kernels without IORING_FEAT_SINGLE_MMAP
+    size_t completion_size = 0;
+    io_uring_sqe* sqes = static_cast<io_uring_sqe*>(MAP_FAILED);
+    size_t sqes_size = 0;
+
+    unsigned* sq_tail = nullptr;
+    unsigned* sq_mask = nullptr;
+    unsigned* sq_array = nullptr;
+    unsigned* cq_head = nullptr;
+    unsigned* cq_tail = nullptr;
+    unsigned* cq_mask = nullptr;
+    io_uring_cqe* cqes = nullptr;
+    unsigned tail = 0;       // Next submission slot, published on submit()
+    unsigned queued = 0;     // Entries not yet passed to the kernel
+
+    IoRing() = default;
+    IoRing(const IoRing&) = delete;
+    IoRing& operator=(const IoRing&) = delete;
+
+    ~IoRing() { close(); }
+
+    void close() {
+        if (sqes != MAP_FAILED) munmap(sqes, sqes_size);
+        if (completion_ring != MAP_FAILED) munmap(completion_ring, completion_size);
+        if (rings != MAP_FAILED) munmap(rings, rings_size);
+        if (fd >= 0) ::close(fd);
+        sqes = static_cast<io_uring_sqe*>(MAP_FAILED);
+        completion_ring = rings = MAP_FAILED;
+        fd = -1;
+    }
+
+    // False if the kernel lacks io_uring or IORING_OP_READ (before 5.6), or
+    // a sandbox forbids it
+    bool init(unsigned entries) {
+        io_uring_params params{};
+        fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+        if (fd < 0 || !(params.features & IORING_FEAT_RW_CUR_POS)) {
+            return false;
+        }
+
+        rings_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        size_t cq_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool single = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (single) {
+            rings_size = std::max(rings_size, cq_size);
+        }
+        rings = mmap(nullptr, rings_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+        if (rings == MAP_FAILED) {
+            return false;
+        }
+        void* cq_base = rings;
+        if (!single) {
+            completion_size = cq_size;
+            completion_ring = mmap(nullptr, cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+                                   IORING_OFF_CQ_RING);
+            if (completion_ring == MAP_FAILED) {
+                return false;
+            }
+            cq_base = completion_ring;
+        }
+        sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+        sqes = static_cast<io_uring_sqe*>(
+            mmap(nullptr, sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES));
+        if (sqes == MAP_FAILED) {
+            return false;
+        }
+
+        auto* sq = static_cast<char*>(rings);
+        auto* cq = static_cast<char*>(cq_base);
+        sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sq_mask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cq_mask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        tail = *sq_tail;
+        return true;
+    }
+
+    // Caller keeps at most `entries` operations outstanding
+    io_uring_sqe& next_sqe() {
+        unsigned index = tail & *sq_mask;
+        sq_array[index] = index;
+        io_uring_sqe& sqe = sqes[index];
+        std::memset(&sqe, 0, sizeof(sqe));
+        ++tail;
+        ++queued;
+        return sqe;
+    }
+
+    // Publishes queued entries and waits for at least `wait` completions
+    int submit(unsigned wait) {
+        std::atomic_ref<unsigned>(*sq_tail).store(tail, std::memory_order_release);
+        for (;;) {
+            long submitted = syscall(__NR_io_uring_enter, fd, queued, wait, wait ? IORING_ENTER_GETEVENTS : 0,
+                                     nullptr, 0);
+            if (submitted >= 0) {
+                queued -= static_cast<unsigned>(submitted);
+                return 0;
+            }
+            if (errno != EINTR) {
+                return errno;
+            }
+        }
+    }
+
+    // Waits for a completion without passing queued entries to the kernel
+    int wait() {
+        for (;;) {
+            if (syscall(__NR_io_uring_enter, fd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0) >= 0) {
+                return 0;
+            }
+            if (errno != EINTR) {
+                return errno;
+            }
+        }
+    }
+
+    template<typename Handler>
+    void reap(Handler&& handler) {
+        std::atomic_ref<unsigned> head_ref(*cq_head);
+        unsigned head = head_ref.load(std::memory_order_relaxed);
+        unsigned end = std::atomic_ref<unsigned>(*cq_tail).load(std::memory_order_acquire);
+        for (; head != end; ++head) {
+            handler(cqes[head & *cq_mask]);
+        }
+        head_ref.store(head, std::memory_order_release);
+    }
+};
+
+bool FilePipeline::start_io_uring() {
+    auto ring = std::make_unique<IoRing>();
+    if (!ring->init(static_cast<unsigned>(options_.reads_in_flight))) {
+        return false;
+    }
+    readers_left_ = 1;
+    readers_.emplace_back([this, ring = std::move(ring)] { read_with_io_uring(*ring); });
+    return true;
+}
+
+// One thread keeps up to reads_in_flight reads queued in the kernel. Files
+// are opened synchronously (open and fstat are cheap next to the read), and
+// short reads are resubmitted for the remainder.
+void FilePipeline::read_with_io_uring(IoRing& ring) {
+    struct Slot {
+        size_t index;
+        size_t buffer;
+        int fd;
+        size_t size;
+        size_t done;
+    };
+    struct Opened {
+        size_t index = 0;
+        int fd = -1;   // -1 when no file is waiting
+        size_t size = 0;
+    };
+
+    std::vector<Slot> slots(options_.reads_in_flight);
+    std::vector<size_t> free_slots;
+    for (size_t slot = slots.size(); slot > 0; --slot) {
+        free_slots.push_back(slot - 1);
+    }
+    size_t in_flight = 0;
+    Opened opened;   // Waiting for a buffer
+
+    auto submit = [&](size_t s) {
+        Slot& slot = slots[s];
+        io_uring_sqe& sqe = ring.next_sqe();
+        sqe.opcode = IORING_OP_READ;
+        sqe.fd = slot.fd;
+        sqe.addr = reinterpret_cast<uint64_t>(buffers_[slot.buffer].data.get() + slot.done);
+        sqe.len = static_cast<uint32_t>(std::min<size_t>(slot.size - slot.done, size_t{1} << 30));
+        sqe.off = slot.done;
+        sqe.user_data = s;
+        ++in_flight;
+    };
+
+    auto finish = [&](size_t s, std::error_code error) {
+        Slot& slot = slots[s];
+        ::close(slot.fd);
+        if (error) {
+            release_buffer(slot.buffer);
+            push_read({slot.index, kNoBuffer, 0, error});
+        } else {
+            push_read({slot.index, slot.buffer, slot.done, {}});
+        }
+        free_slots.push_back(s);
+    };
+
+    for (;;) {
+        while (!stop_ && !free_slots.empty()) {
+            if (opened.fd < 0) {
+                size_t index = next_file_.fetch_add(1);
+                if (index >= files_.size()) {
+                    break;
+                }
+                int fd = ::open(files_[index].c_str(), O_RDONLY | O_CLOEXEC);
+                struct stat status;
+                if (fd < 0 || ::fstat(fd, &status) != 0) {
+                    std::error_code error(errno, std::system_category());
+                    if (fd >= 0) ::close(fd);
+                    push_read({index, kNoBuffer, 0, error});
+                    continue;
+                }
+                if (status.st_size == 0) {
+                    ::close(fd);
+                    push_read({index, kNoBuffer, 0, {}});
+                    continue;
+                }
+                opened = {index, fd, static_cast<size_t>(status.st_size)};
+            }
+
+            // Wait for a buffer only when no completion could free one
+            std::optional<size_t> buffer = acquire_buffer(opened.size, in_flight == 0);
+            if (!buffer) {
+                break;
+            }
+            size_t s = free_slots.back();
+            free_slots.pop_back();
+            slots[s] = {opened.index, *buffer, opened.fd, opened.size, 0};
+            opened = {};
+            submit(s);
+        }
+
+        if (in_flight == 0) {
+            break;
+        }
+        if (int error = ring.submit(1); error != 0 && error != EAGAIN && error != EBUSY) {
+            // The ring is unusable: fail what it holds and read the rest on
+            // this thread. Reads the kernel already took may still write to
+            // their buffers, so they are waited for and the ring closed
+            // before any buffer returns to the pool. If even waiting fails,
+            // those buffers are left to the kernel and replaced.
+            unsigned held = static_cast<unsigned>(in_flight) - ring.queued;
+            while (held > 0 && ring.wait() == 0) {
+                ring.reap([&](const io_uring_cqe&) { --held; });
+            }
+            ring.close();
+            for (size_t s = 0; s < slots.size(); ++s) {
+                if (std::find(free_slots.begin(), free_slots.end(), s) == free_slots.end()) {
+                    if (held > 0) {
+                        static_cast<void>(buffers_[slots[s].buffer].data.release());
+                        buffers_[slots[s].buffer].capacity = 0;
+                    }
+                    finish(s, std::error_code(error, std::system_category()));
+                }
+            }
+            if (opened.fd >= 0) {
+                ::close(opened.fd);
+                push_read({opened.index, kNoBuffer, 0, std::error_code(error, std::system_category())});
+            }
+            read_with_threads();   // Counted as the one io_uring reader
+            return;
+        }
+
+        ring.reap([&](const io_uring_cqe& cqe) {
+            auto s = static_cast<size_t>(cqe.user_data);
+            --in_flight;
+            if (cqe.res == -EAGAIN || cqe.res == -EINTR) {
+                submit(s);
+            } else if (cqe.res < 0) {
+                finish(s, std::error_code(-cqe.res, std::system_category()));
+            } else {
+                Slot& slot = slots[s];
+                slot.done += static_cast<size_t>(cqe.res);
+                if (cqe.res == 0 || slot.done == slot.size) {
+                    finish(s, {});   // A file that shrank ends at its new size
+                } else {
+                    submit(s);
+                }
+            }
+        });
+    }
+
+    if (opened.fd >= 0) {
+        ::close(opened.fd);
+    }
+    reader_finished();
+}
+
+#else
+
+bool FilePipeline::start_io_uring() {
+    return false;
+}
+
+void FilePipeline::read_with_io_uring(IoRing&) {}
+
+#endif
+
+FilePipeline::FilePipeline(std::vector<std::filesystem::path> files, FilePipelineOptions options)
+    : files_(std::move(files)), options_(options) {
+    options_.reads_in_flight = std::max<size_t>(options_.reads_in_flight, 1);
+    if (options_.workers == 0) {
+        options_.workers = std::max(1u, std::thread::hardware_concurrency());
+    }
+    options_.max_results = std::max<size_t>(options_.max_results, 1);
+
+    buffers_.resize(options_.reads_in_flight + options_.workers);
+    for (size_t buffer = buffers_.size(); buffer > 0; --buffer) {
+        free_buffers_.push_back(buffer - 1);
+    }
+
+    if (options_.backend != IoBackend::Threads && start_io_uring()) {
+        backend_ = IoBackend::IoUring;
+    } else {
+        backend_ = IoBackend::Threads;
+        readers_left_ = options_.reads_in_flight;
+        for (size_t i = 0; i < options_.reads_in_flight; ++i) {
+            readers_.emplace_back([this] { read_with_threads(); });
+        }
+    }
+    for (size_t i = 0; i < options_.workers; ++i) {
+        workers_.emplace_back([this] { work(); });
+    }
+}
+
+FilePipeline::~FilePipeline() {
+    stop_ = true;
+    // Taking each lock after setting stop_ means no waiter can miss it
+    for (std::mutex* mutex : {&pool_mutex_, &reads_mutex_, &results_mutex_}) {
+        std::lock_guard lock(*mutex);
+    }
+    pool_ready_.notify_all();
+    reads_ready_.notify_all();
+    results_space_.notify_all();
+
+    for (std::thread& reader : readers_) {
+        reader.join();
+    }
+    for (std::thread& worker : workers_) {
+        worker.join();
+    }
+}
+
+std::optional<size_t> FilePipeline::acquire_buffer(size_t size, bool wait) {
+    std::unique_lock lock(pool_mutex_);
+    if (wait) {
+        pool_ready_.wait(lock, [&] { return !free_buffers_.empty() || stop_; });
+    }
+    if (free_buffers_.empty() || stop_) {
+        return std::nullopt;
+    }
+
+    // Prefer a buffer that is already large enough
+    auto fits = std::find_if(free_buffers_.begin(), free_buffers_.end(),
+                             [&](size_t buffer) { return buffers_[buffer].capacity >= size; });
+    if (fits != free_buffers_.end()) {
+        std::iter_swap(fits, free_buffers_.end() - 1);
+    }
+    size_t index = free_buffers_.back();
+    free_buffers_.pop_back();
+
+    Buffer& buffer = buffers_[index];
+    if (buffer.capacity < size) {
+        buffer.data = std::make_unique_for_overwrite<std::byte[]>(size);
+        buffer.capacity = size;
+    }
+    return index;
+}
+
+void FilePipeline::release_buffer(size_t buffer) {
+    {
+        std::lock_guard lock(pool_mutex_);
+        free_buffers_.push_back(buffer);
+    }
+    pool_ready_.notify_one();
+}
+
+void FilePipeline::push_read(Read read) {
+    {
+        std::lock_guard lock(reads_mutex_);
+        reads_.push_back(read);
+    }
+    reads_ready_.notify_one();
+}
+
+void FilePipeline::reader_finished() {
+    bool last;
+    {
+        std::lock_guard lock(reads_mutex_);
+        last = --readers_left_ == 0;
+    }
+    if (last) {
+        reads_ready_.notify_all();
+    }
+}
+
+void FilePipeline::read_with_threads() {
+    while (!stop_) {
+        size_t index = next_file_.fetch_add(1);
+        if (index >= files_.size()) {
+            break;
+        }
+
+        std::error_code error;
+        size_t size = std::filesystem::file_size(files_[index], error);
+        if (error || size == 0) {
+            push_read({index, kNoBuffer, 0, error});
+            continue;
+        }
+
+        std::optional<size_t> buffer = acquire_buffer(size, true);
+        if (!buffer) {
+            break;
+        }
+        std::ifstream in(files_[index], std::ios::binary);
+        in.read(reinterpret_cast<char*>(buffers_[*buffer].data.get()), static_cast<std::streamsize>(size));
+        if (!in.is_open() || in.bad()) {
+            release_buffer(*buffer);
+            push_read({index, kNoBuffer, 0, std::make_error_code(std::errc::io_error)});
+            continue;
+        }
+        push_read({index, *buffer, static_cast<size_t>(in.gcount()), {}});
+    }
+    reader_finished();
+}
+
+void FilePipeline::work() {
+    for (;;) {
+        Read read;
+        {
+            std::unique_lock lock(reads_mutex_);
+            reads_ready_.wait(lock, [&] { return !reads_.empty() || readers_left_ == 0 || stop_; });
+            if (stop_ || reads_.empty()) {
+                return;
+            }
+            read = reads_.front();
+            reads_.pop_front();
+        }
+
+        FileTokens result{read.index, files_[read.index], {}, read.error};
+        if (read.buffer != kNoBuffer) {
+            auto text = reinterpret_cast<const char*>(buffers_[read.buffer].data.get());
+            result.tokens = options_.tokenize(std::string_view(text, read.size));
+            release_buffer(read.buffer);
+        }
+        deliver(std::move(result));
+    }
+}
+
+void FilePipeline::deliver(FileTokens result) {
+    std::unique_lock lock(results_mutex_);
+    results_space_.wait(lock, [&] { return results_.size() < options_.max_results || stop_; });
+    if (stop_) {
+        return;
+    }
+
+    if (NextAwaiter* awaiter = std::exchange(waiter_, nullptr)) {
+        awaiter->result_ = std::move(result);
+        ++delivered_;
+        lock.unlock();
+        awaiter->handle_.resume();
+        return;
+    }
+    results_.push_back(std::move(result));
+    lock.unlock();
+    results_ready_.notify_one();
+}
+
+std::optional<FileTokens> FilePipeline::next() {
+    std::unique_lock lock(results_mutex_);
+    results_ready_.wait(lock, [&] { return !results_.empty() || delivered_ == files_.size(); });
+    if (results_.empty()) {
+        return std::nullopt;
+    }
+
+    FileTokens result = std::move(results_.front());
+    results_.pop_front();
+    ++delivered_;
+    lock.unlock();
+    results_space_.notify_one();
+    return result;
+}
+
+bool FilePipeline::try_next(std::optional<FileTokens>& result) {
+    std::unique_lock lock(results_mutex_);
+    if (!results_.empty()) {
+        result = std::move(results_.front());
+        results_.pop_front();
+        ++delivered_;
+        lock.unlock();
+        results_space_.notify_one();
+        return true;
+    }
+    if (delivered_ == files_.size()) {
+        result.reset();
+        return true;
+    }
+    return false;
+}
+
+bool FilePipeline::suspend(NextAwaiter& awaiter, std::coroutine_handle<> handle) {
+    {
+        std::lock_guard lock(results_mutex_);
+        if (results_.empty() && delivered_ != files_.size()) {
+            awaiter.handle_ = handle;
+            waiter_ = &awaiter;
+            return true;
+        }
+    }
+    // A result arrived since await_ready(); take it without suspending
+    return !try_next(awaiter.result_);
+}
+
+}  // namespace db25
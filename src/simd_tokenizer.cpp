@@ -10,30 +10,46 @@
 
 #include "simd_tokenizer.hpp"
 #include "char_classifier.hpp"
+#include <cctype>
+#include <cstring>
+#include <type_traits>
+#include <utility>
 
 namespace db25 {
 
-SimdTokenizer::SimdTokenizer(const std::byte* input, size_t size)
+// Statistics scope and trace scope of one tokenizer phase
+#define DB25_PHASE_SCOPE(phase) \
+    [[maybe_unused]] typename Stats::Scope DB25_TRACE_CONCAT(phase_scope_, __LINE__)(stats_, StatsPhase::phase); \
+    DB25_TRACE_SCOPE(#phase)
+
+template<typename Dialect, typename Stats>
+BasicSimdTokenizer<Dialect, Stats>::BasicSimdTokenizer(const std::byte* input, size_t size)
         : input_(input)
         , input_size_(size)
         , position_(0)
         , line_(1)
         , column_(1) {}
+
+template<typename Dialect, typename Stats>
+BasicSimdTokenizer<Dialect, Stats>::BasicSimdTokenizer(const std::byte* input, size_t size, SimdLevel level)
+        : dispatcher_(level)
+        , input_(input)
+        , input_size_(size)
+        , position_(0)
+        , line_(1)
+        , column_(1) {}
     
-[[nodiscard]] std::vector<Token> SimdTokenizer::tokenize() {
-        std::vector<Token> tokens;
-        tokens.reserve(input_size_ / 8);
+template<typename Dialect, typename Stats>
+template<bool Record, typename Sink>
+void BasicSimdTokenizer<Dialect, Stats>::scan(Sink&& sink) {
+        position_ = 0;
+        line_ = 1;
+        column_ = 1;
         
         while (position_ < input_size_) {
-            size_t skip = dispatcher_.dispatch([this](auto processor) {
-                return processor.skip_whitespace(
-                    input_ + position_, 
-                    input_size_ - position_
-                );
-            });
-            
-            if (skip > 0) {
-                update_position(skip);
+            size_t skip = skip_whitespace();
+            if constexpr (Record) {
+                stats_.count_whitespace(skip);
             }
             
             if (position_ >= input_size_) {
@@ -42,24 +58,151 @@ SimdTokenizer::SimdTokenizer(const std::byte* input, size_t size)
             
             Token token = next_token();
             if (token.type != TokenType::Whitespace) {
-                tokens.push_back(token);
+                if constexpr (Record) {
+                    stats_.count_token(token);
+                }
+                if constexpr (std::is_same_v<decltype(sink(token)), bool>) {
+                    if (!sink(token)) {
+                        break;
+                    }
+                } else {
+                    sink(token);
+                }
             }
             
             if (token.type == TokenType::EndOfFile) {
                 break;
             }
         }
+    }
+
+template<typename Dialect, typename Stats>
+std::vector<Token> BasicSimdTokenizer<Dialect, Stats>::tokenize_reserved(size_t capacity) {
+        std::vector<Token> tokens;
         
+        {
+            // Closed before publish() so the Tokenize phase is recorded
+            [[maybe_unused]] typename Stats::Scope scope(stats_, StatsPhase::Tokenize);
+            DB25_TRACE_SCOPE("Tokenize", input_size_);
+            stats_.count_input(input_size_);
+            tokens.reserve(capacity);
+            
+            scan<true>([&tokens](const Token& token) {
+                if (kTracingCompiled && tokens.size() == tokens.capacity()) {
+                    DB25_TRACE_SCOPE("TokenVectorGrowth", tokens.capacity() * sizeof(Token));
+                    tokens.push_back(token);
+                } else {
+                    tokens.push_back(token);
+                }
+            });
+        }
+        
+        stats_.publish();
         return tokens;
     }
+
+template<typename Dialect, typename Stats>
+[[nodiscard]] std::vector<Token> BasicSimdTokenizer<Dialect, Stats>::tokenize() {
+        return tokenize_reserved(input_size_ / 8);
+    }
+
+template<typename Dialect, typename Stats>
+[[nodiscard]] size_t BasicSimdTokenizer<Dialect, Stats>::count_tokens() {
+        DB25_TRACE_SCOPE("CountTokens", input_size_);
+        size_t count = 0;
+        counting_ = true;
+        scan<false>([&count](const Token&) { ++count; });
+        counting_ = false;
+        stats_.discard();  // The scanners' phase scopes ran too
+        return count;
+    }
+
+template<typename Dialect, typename Stats>
+[[nodiscard]] std::vector<Token> BasicSimdTokenizer<Dialect, Stats>::tokenize_exact() {
+        return tokenize_reserved(count_tokens());
+    }
+
+template<typename Dialect, typename Stats>
+[[nodiscard]] size_t BasicSimdTokenizer<Dialect, Stats>::tokenize_into(std::span<Token> out) {
+        size_t count = 0;
+        
+        {
+            [[maybe_unused]] typename Stats::Scope scope(stats_, StatsPhase::Tokenize);
+            DB25_TRACE_SCOPE("Tokenize", input_size_);
+            stats_.count_input(input_size_);
+            
+            scan<true>([&](const Token& token) {
+                if (count < out.size()) {
+                    out[count] = token;
+                }
+                ++count;
+            });
+        }
+        
+        stats_.publish();
+        return count;
+    }
+
+template<typename Dialect, typename Stats>
+size_t BasicSimdTokenizer<Dialect, Stats>::tokenize_blocks(TokenBlockSink& sink) {
+        size_t count = 0;
+        std::span<Token> block = sink.acquire();
+        if (block.empty()) {
+            return 0;
+        }
+        
+        {
+            [[maybe_unused]] typename Stats::Scope scope(stats_, StatsPhase::Tokenize);
+            DB25_TRACE_SCOPE("Tokenize", input_size_);
+            stats_.count_input(input_size_);
+            
+            size_t filled = 0;
+            scan<true>([&](const Token& token) {
+                block[filled++] = token;
+                ++count;
+                if (filled < block.size()) {
+                    return true;
+                }
+                sink.publish(filled, false);
+                filled = 0;
+                block = sink.acquire();
+                return !block.empty();
+            });
+            if (!block.empty()) {
+                sink.publish(filled, true);
+            }
+        }
+        
+        stats_.publish();
+        return count;
+    }
+
+template<typename Dialect, typename Stats>
+size_t BasicSimdTokenizer<Dialect, Stats>::skip_whitespace() {
+        DB25_PHASE_SCOPE(Whitespace);
+        size_t skip = dispatcher_.dispatch([this](auto processor) {
+            return processor.skip_whitespace(
+                input_ + position_, 
+                input_size_ - position_
+            );
+        });
+        
+        if (skip > 0) {
+            update_position(skip);
+        }
+        return skip;
+    }
     
-[[nodiscard]] const char* SimdTokenizer::simd_level() const noexcept {
+template<typename Dialect, typename Stats>
+[[nodiscard]] const char* BasicSimdTokenizer<Dialect, Stats>::simd_level() const noexcept {
     return dispatcher_.level_name();
 }
 
-Token SimdTokenizer::next_token() {
+template<typename Dialect, typename Stats>
+Token BasicSimdTokenizer<Dialect, Stats>::next_token() {
         if (position_ >= input_size_) {
-            return {TokenType::EndOfFile, "", Keyword::UNKNOWN, line_, column_};
+            return {TokenType::EndOfFile, "", Keyword::UNKNOWN, TOKEN_FLAG_NONE, Operator::UNKNOWN,
+                    line_, column_};
         }
         
         size_t start = position_;
@@ -68,22 +211,40 @@ Token SimdTokenizer::next_token() {
         
         uint8_t first_char = static_cast<uint8_t>(input_[position_]);
 
+        if constexpr (Dialect::escape_string_prefix) {
+            if ((first_char == 'E' || first_char == 'e') && position_ + 1 < input_size_ &&
+                static_cast<uint8_t>(input_[position_ + 1]) == '\'') {
+                return scan_backslash_string(start, start_line, start_column, '\'', 1);
+            }
+        }
+
         // Use lookup table for character classification
-        if (is_identifier_start(first_char)) {
+        if (Traits::is_identifier_start(first_char) || is_non_ascii(first_char)) {
             return scan_identifier_or_keyword(start, start_line, start_column);
         }
 
-        if (is_digit(first_char)) {
+        if (Traits::is_digit(first_char)) {
             return scan_number(start, start_line, start_column);
         }
 
-        if (is_quote(first_char)) {
+        if (Traits::is_quote(first_char)) {
+            if constexpr (Dialect::backslash_escapes) {
+                if (!is_identifier_quote(first_char)) {
+                    return scan_backslash_string(start, start_line, start_column, first_char, 0);
+                }
+            }
             return scan_string(start, start_line, start_column, first_char);
         }
         
         if (first_char == '-' && position_ + 1 < input_size_ &&
             static_cast<uint8_t>(input_[position_ + 1]) == '-') {
-            return scan_comment(start, start_line, start_column);
+            return scan_comment(start, start_line, start_column, 2);
+        }
+        
+        if constexpr (Dialect::hash_comments) {
+            if (first_char == '#') {
+                return scan_comment(start, start_line, start_column, 1);
+            }
         }
         
         if (first_char == '/' && position_ + 1 < input_size_ &&
@@ -91,24 +252,69 @@ Token SimdTokenizer::next_token() {
             return scan_block_comment(start, start_line, start_column);
         }
         
+        if constexpr (Dialect::dollar_quoted_strings) {
+            if (first_char == '$') {
+                size_t tag_length = match_dollar_tag();
+                if (tag_length > 0) {
+                    return scan_dollar_string(start, start_line, start_column, tag_length);
+                }
+            }
+        }
+        
         return scan_operator_or_delimiter(start, start_line, start_column);
     }
 
-Token SimdTokenizer::scan_identifier_or_keyword(size_t start, size_t start_line, size_t start_column) {
-        while (position_ < input_size_) {
-            uint8_t ch = static_cast<uint8_t>(input_[position_]);
-            if (!is_identifier_cont(ch)) {
-                break;
+template<typename Dialect, typename Stats>
+Token BasicSimdTokenizer<Dialect, Stats>::scan_identifier_or_keyword(size_t start, size_t start_line, size_t start_column) {
+        DB25_PHASE_SCOPE(Identifier);
+        uint8_t seen = 0;
+        
+        // Dialects only reclassify quote characters, so the identifier bytes
+        // are those of char_lookup_table that the processors classify
+        size_t length = dispatcher_.dispatch([&](auto processor) {
+            return processor.identifier_length(input_ + position_, input_size_ - position_, seen);
+        });
+        // '$' after the first byte continues the identifier, so a$b$c is
+        // one token rather than `a` followed by a $b$ tag
+        if constexpr (Dialect::dollar_identifiers) {
+            while (position_ + length < input_size_ && static_cast<uint8_t>(input_[position_ + length]) == '$') {
+                ++length;
+                length += dispatcher_.dispatch([&](auto processor) {
+                    return processor.identifier_length(input_ + position_ + length,
+                                                       input_size_ - position_ - length, seen);
+                });
             }
-            ++position_;
-            ++column_;
         }
+        position_ += length;
+        column_ += length;
         
         std::string_view value(
             reinterpret_cast<const char*>(input_ + start),
             position_ - start
         );
         
+        if (counting_) {
+            return {TokenType::Identifier, value, Keyword::UNKNOWN, TOKEN_FLAG_NONE, Operator::UNKNOWN,
+                    start_line, start_column};
+        }
+        
+        // Keywords are pure ASCII; a non-ASCII identifier only needs its
+        // encoding checked
+        if (is_non_ascii(seen)) {
+            bool valid = dispatcher_.dispatch([&](auto processor) {
+                return processor.validate_utf8(input_ + start, value.length());
+            });
+            
+            if (!valid) {
+                return {TokenType::Unknown, value, Keyword::UNKNOWN, TOKEN_FLAG_INVALID_UTF8, Operator::UNKNOWN,
+                        start_line, start_column};
+            }
+            return {TokenType::Identifier, value, Keyword::UNKNOWN, TOKEN_FLAG_NONE, Operator::UNKNOWN,
+                    start_line, start_column};
+        }
+        
+        DB25_PHASE_SCOPE(KeywordLookup);
+        
         // Use generated keyword lookup
         Keyword kw = find_keyword(value);
         TokenType type = (kw != Keyword::UNKNOWN) ? TokenType::Keyword : TokenType::Identifier;
@@ -126,18 +332,21 @@ Token SimdTokenizer::scan_identifier_or_keyword(size_t start, size_t start_line,
                 type = TokenType::Keyword;
             }
         }
+        stats_.count_keyword_lookup(kw != Keyword::UNKNOWN);
         
-        return {type, value, kw, start_line, start_column};
+        return {type, value, kw, TOKEN_FLAG_NONE, Operator::UNKNOWN, start_line, start_column};
     }
 
-Token SimdTokenizer::scan_number(size_t start, size_t start_line, size_t start_column) {
+template<typename Dialect, typename Stats>
+Token BasicSimdTokenizer<Dialect, Stats>::scan_number(size_t start, size_t start_line, size_t start_column) {
+        DB25_PHASE_SCOPE(Number);
         bool has_dot = false;
         bool has_exp = false;
 
         while (position_ < input_size_) {
             uint8_t ch = static_cast<uint8_t>(input_[position_]);
 
-            if (is_digit(ch)) {
+            if (Traits::is_digit(ch)) {
                 ++position_;
                 ++column_;
             } else if (ch == '.' && !has_dot && !has_exp) {
@@ -166,22 +375,32 @@ Token SimdTokenizer::scan_number(size_t start, size_t start_line, size_t start_c
             position_ - start
         );
         
-        return {TokenType::Number, value, Keyword::UNKNOWN, start_line, start_column};
+        return {TokenType::Number, value, Keyword::UNKNOWN, TOKEN_FLAG_NONE, Operator::UNKNOWN,
+                start_line, start_column};
     }
 
-Token SimdTokenizer::scan_string(size_t start, size_t start_line, size_t start_column, uint8_t quote) {
+template<typename Dialect, typename Stats>
+Token BasicSimdTokenizer<Dialect, Stats>::scan_string(size_t start, size_t start_line, size_t start_column, uint8_t quote) {
+        DB25_PHASE_SCOPE(String);
         ++position_;
         ++column_;
         
+        const uint8_t closing = closing_quote(quote);
+        uint8_t flags = TOKEN_FLAG_QUOTED | TOKEN_FLAG_UNTERMINATED;
+        uint8_t seen = 0;
+        
         while (position_ < input_size_) {
             uint8_t ch = static_cast<uint8_t>(input_[position_]);
+            seen |= ch;
             
-            if (ch == quote) {
+            if (ch == closing) {
                 if (position_ + 1 < input_size_ &&
-                    static_cast<uint8_t>(input_[position_ + 1]) == quote) {
+                    static_cast<uint8_t>(input_[position_ + 1]) == closing) {
+                    flags |= TOKEN_FLAG_ESCAPED;
                     position_ += 2;
                     column_ += 2;
                 } else {
+                    flags &= ~TOKEN_FLAG_UNTERMINATED;
                     ++position_;
                     ++column_;
                     break;
@@ -201,12 +420,170 @@ Token SimdTokenizer::scan_string(size_t start, size_t start_line, size_t start_c
             position_ - start
         );
         
-        return {TokenType::String, value, Keyword::UNKNOWN, start_line, start_column};
+        if (is_non_ascii(seen) && !dispatcher_.dispatch([&](auto processor) {
+                return processor.validate_utf8(input_ + start, value.length());
+            })) {
+            flags |= TOKEN_FLAG_INVALID_UTF8;
+        }
+        
+        TokenType type = is_identifier_quote(quote) ? TokenType::Identifier : TokenType::String;
+        return {type, value, Keyword::UNKNOWN, flags, Operator::UNKNOWN, start_line, start_column};
     }
 
-Token SimdTokenizer::scan_comment(size_t start, size_t start_line, size_t start_column) {
-        position_ += 2;
-        column_ += 2;
+// Literal with backslash escapes. Quotes and backslashes are matched 64 bytes
+// at a time and escaped quotes are masked out with escaped_mask(), so the
+// first remaining quote bit is the closing quote (or half of a doubled one).
+template<typename Dialect, typename Stats>
+Token BasicSimdTokenizer<Dialect, Stats>::scan_backslash_string(size_t start, size_t start_line, size_t start_column,
+                                                         uint8_t quote, size_t prefix_length) {
+        DB25_PHASE_SCOPE(String);
+        size_t pos = start + prefix_length + 1;
+        size_t end = input_size_;
+        uint64_t carry = 0;
+        uint8_t flags = TOKEN_FLAG_QUOTED | TOKEN_FLAG_UNTERMINATED;
+        
+        while (pos < input_size_) {
+            size_t quote_at = input_size_;
+            
+            if (input_size_ - pos >= 64) {
+                auto [quotes, backslashes] = dispatcher_.dispatch([&](auto processor) {
+                    return std::pair{processor.byte_mask64(input_ + pos, quote),
+                                     processor.byte_mask64(input_ + pos, '\\')};
+                });
+                uint64_t closing = quotes & ~escaped_mask(backslashes, carry);
+                // Only backslashes before the quote belong to this literal
+                uint64_t inside = closing == 0 ? backslashes : backslashes & ((closing & -closing) - 1);
+                if (inside != 0) {
+                    flags |= TOKEN_FLAG_ESCAPED | TOKEN_FLAG_BACKSLASH;
+                }
+                if (closing == 0) {
+                    pos += 64;
+                    continue;
+                }
+                quote_at = pos + std::countr_zero(closing);
+            } else {
+                bool escaped = carry != 0;
+                for (; pos < input_size_; ++pos) {
+                    uint8_t ch = static_cast<uint8_t>(input_[pos]);
+                    if (escaped) {
+                        escaped = false;
+                    } else if (ch == '\\') {
+                        escaped = true;
+                        flags |= TOKEN_FLAG_ESCAPED | TOKEN_FLAG_BACKSLASH;
+                    } else if (ch == quote) {
+                        quote_at = pos;
+                        break;
+                    }
+                }
+                if (quote_at == input_size_) {
+                    break;
+                }
+            }
+            
+            // Scanning resumes after a quote, which never escapes its successor
+            carry = 0;
+            if (quote_at + 1 < input_size_ && static_cast<uint8_t>(input_[quote_at + 1]) == quote) {
+                flags |= TOKEN_FLAG_ESCAPED;
+                pos = quote_at + 2;
+                continue;
+            }
+            end = quote_at + 1;
+            flags &= ~TOKEN_FLAG_UNTERMINATED;
+            break;
+        }
+        
+        skip_span(end - position_);
+        
+        std::string_view value(
+            reinterpret_cast<const char*>(input_ + start),
+            end - start
+        );
+        
+        if (!dispatcher_.dispatch([&](auto processor) {
+                return processor.validate_utf8(input_ + start, value.length());
+            })) {
+            flags |= TOKEN_FLAG_INVALID_UTF8;
+        }
+        
+        return {TokenType::String, value, Keyword::UNKNOWN, flags, Operator::UNKNOWN,
+                start_line, start_column};
+    }
+
+// Length of the `$tag$` opening at position_, or 0 if there is none. Tags
+// follow identifier rules, so positional parameters like $1 are not tags.
+template<typename Dialect, typename Stats>
+size_t BasicSimdTokenizer<Dialect, Stats>::match_dollar_tag() const noexcept {
+        size_t i = position_ + 1;
+        
+        while (i < input_size_) {
+            uint8_t ch = static_cast<uint8_t>(input_[i]);
+            if (ch == '$') {
+                return i + 1 - position_;
+            }
+            bool valid = (i == position_ + 1)
+                ? Traits::is_identifier_start(ch) || is_non_ascii(ch)
+                : Traits::is_identifier_cont(ch) || is_non_ascii(ch);
+            if (!valid) {
+                return 0;
+            }
+            ++i;
+        }
+        
+        return 0;
+    }
+
+// Dollar-quoted bodies have no escapes: jump between '$' bytes with the
+// vectorized search and confirm each candidate against the full tag.
+template<typename Dialect, typename Stats>
+Token BasicSimdTokenizer<Dialect, Stats>::scan_dollar_string(size_t start, size_t start_line, size_t start_column,
+                                                      size_t tag_length) {
+        DB25_PHASE_SCOPE(String);
+        const std::byte* tag = input_ + start;
+        size_t body_start = start + tag_length;
+        size_t search = body_start;
+        size_t end = input_size_;
+        uint8_t flags = TOKEN_FLAG_QUOTED | TOKEN_FLAG_DOLLAR_QUOTED | TOKEN_FLAG_UNTERMINATED;
+        
+        while (search < input_size_) {
+            size_t offset = dispatcher_.dispatch([&](auto processor) {
+                return processor.find_byte(input_ + search, input_size_ - search, '$');
+            });
+            size_t candidate = search + offset;
+            if (candidate >= input_size_) {
+                break;
+            }
+            if (input_size_ - candidate >= tag_length &&
+                std::memcmp(input_ + candidate, tag, tag_length) == 0) {
+                end = candidate + tag_length;
+                flags &= ~TOKEN_FLAG_UNTERMINATED;
+                break;
+            }
+            search = candidate + 1;
+        }
+        
+        skip_span(end - position_);
+        
+        std::string_view value(
+            reinterpret_cast<const char*>(input_ + start),
+            end - start
+        );
+        
+        if (!dispatcher_.dispatch([&](auto processor) {
+                return processor.validate_utf8(input_ + body_start, end - body_start);
+            })) {
+            flags |= TOKEN_FLAG_INVALID_UTF8;
+        }
+        
+        return {TokenType::String, value, Keyword::UNKNOWN, flags, Operator::UNKNOWN,
+                start_line, start_column};
+    }
+
+template<typename Dialect, typename Stats>
+Token BasicSimdTokenizer<Dialect, Stats>::scan_comment(size_t start, size_t start_line, size_t start_column,
+                                                size_t prefix_length) {
+        DB25_PHASE_SCOPE(Comment);
+        position_ += prefix_length;
+        column_ += prefix_length;
         
         while (position_ < input_size_) {
             if (static_cast<uint8_t>(input_[position_]) == '\n') {
@@ -224,10 +601,13 @@ Token SimdTokenizer::scan_comment(size_t start, size_t start_line, size_t start_
             position_ - start
         );
         
-        return {TokenType::Comment, value, Keyword::UNKNOWN, start_line, start_column};
+        return {TokenType::Comment, value, Keyword::UNKNOWN, TOKEN_FLAG_NONE, Operator::UNKNOWN,
+                start_line, start_column};
     }
 
-Token SimdTokenizer::scan_block_comment(size_t start, size_t start_line, size_t start_column) {
+template<typename Dialect, typename Stats>
+Token BasicSimdTokenizer<Dialect, Stats>::scan_block_comment(size_t start, size_t start_line, size_t start_column) {
+        DB25_PHASE_SCOPE(Comment);
         position_ += 2;
         column_ += 2;
         
@@ -252,43 +632,205 @@ Token SimdTokenizer::scan_block_comment(size_t start, size_t start_line, size_t
             position_ - start
         );
         
-        return {TokenType::Comment, value, Keyword::UNKNOWN, start_line, start_column};
+        return {TokenType::Comment, value, Keyword::UNKNOWN, TOKEN_FLAG_NONE, Operator::UNKNOWN,
+                start_line, start_column};
     }
 
-Token SimdTokenizer::scan_operator_or_delimiter(size_t start, size_t start_line, size_t start_column) {
+template<typename Dialect, typename Stats>
+Token BasicSimdTokenizer<Dialect, Stats>::scan_operator_or_delimiter(size_t start, size_t start_line, size_t start_column) {
+        DB25_PHASE_SCOPE(Operator);
         uint8_t ch = static_cast<uint8_t>(input_[position_]);
-        ++position_;
-        ++column_;
 
         // Use lookup table to determine token type
-        TokenType type = is_delimiter(ch) ? TokenType::Delimiter : TokenType::Operator;
+        TokenType type = Traits::is_delimiter(ch) ? TokenType::Delimiter : TokenType::Operator;
         
-        if (position_ < input_size_) {
-            uint8_t next = static_cast<uint8_t>(input_[position_]);
-            
-            if ((ch == '<' && (next == '=' || next == '>')) ||
-                (ch == '>' && next == '=') ||
-                (ch == '!' && next == '=') ||
-                (ch == '=' && next == '=') ||  // Add support for ==
-                (ch == '|' && next == '|') ||
-                (ch == '&' && next == '&') ||
-                (ch == ':' && next == ':') ||
-                (ch == '<' && next == '<') ||
-                (ch == '>' && next == '>')) {
-                ++position_;
-                ++column_;
-            }
-        }
+        // Longest match against the dialect's generated 1/2/3-byte table
+        size_t length;
+        Operator op = Traits::operator_table.match(input_ + position_, input_size_ - position_, length);
+        position_ += length;
+        column_ += length;
         
         std::string_view value(
             reinterpret_cast<const char*>(input_ + start),
             position_ - start
         );
         
-        return {type, value, Keyword::UNKNOWN, start_line, start_column};
+        return {type, value, Keyword::UNKNOWN, TOKEN_FLAG_NONE, op, start_line, start_column};
     }
 
-void SimdTokenizer::update_position(size_t count) {
+namespace {
+
+size_t encode_utf8(uint32_t code_point, char* out) {
+    if (code_point < 0x80) {
+        out[0] = static_cast<char>(code_point);
+        return 1;
+    }
+    if (code_point < 0x800) {
+        out[0] = static_cast<char>(0xC0 | (code_point >> 6));
+        out[1] = static_cast<char>(0x80 | (code_point & 0x3F));
+        return 2;
+    }
+    if (code_point < 0x10000) {
+        out[0] = static_cast<char>(0xE0 | (code_point >> 12));
+        out[1] = static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+        out[2] = static_cast<char>(0x80 | (code_point & 0x3F));
+        return 3;
+    }
+    out[0] = static_cast<char>(0xF0 | (code_point >> 18));
+    out[1] = static_cast<char>(0x80 | ((code_point >> 12) & 0x3F));
+    out[2] = static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+    out[3] = static_cast<char>(0x80 | (code_point & 0x3F));
+    return 4;
+}
+
+// Parses up to `max_digits` digits in `base` starting at body[i]
+uint32_t parse_digits(std::string_view body, size_t& i, size_t max_digits, uint32_t base) {
+    uint32_t value = 0;
+    size_t digits = 0;
+    while (digits < max_digits && i < body.size()) {
+        char ch = body[i];
+        uint32_t digit;
+        if (ch >= '0' && ch <= '9') {
+            digit = static_cast<uint32_t>(ch - '0');
+        } else if (ch >= 'a' && ch <= 'f') {
+            digit = static_cast<uint32_t>(ch - 'a' + 10);
+        } else if (ch >= 'A' && ch <= 'F') {
+            digit = static_cast<uint32_t>(ch - 'A' + 10);
+        } else {
+            break;
+        }
+        if (digit >= base) {
+            break;
+        }
+        value = value * base + digit;
+        ++digits;
+        ++i;
+    }
+    return value;
+}
+
+// Decodes a backslash-escaped body. PostgreSQL E'' strings add octal, hex and
+// Unicode escapes; MySQL keeps \% and \_ intact for LIKE patterns. Output is
+// never longer than the input.
+size_t decode_backslash_escapes(std::string_view body, char quote, bool escape_string, char* out) {
+    size_t n = 0;
+    size_t i = 0;
+    
+    while (i < body.size()) {
+        char ch = body[i++];
+        if (ch == quote) {
+            // Unescaped quotes inside a body are always doubled
+            out[n++] = ch;
+            ++i;
+            continue;
+        }
+        if (ch != '\\' || i == body.size()) {
+            out[n++] = ch;
+            continue;
+        }
+        
+        size_t escape_start = i - 1;
+        char next = body[i++];
+        switch (next) {
+            case 'b': out[n++] = '\b'; break;
+            case 'n': out[n++] = '\n'; break;
+            case 'r': out[n++] = '\r'; break;
+            case 't': out[n++] = '\t'; break;
+            default:
+                if (escape_string) {
+                    if (next == 'f') {
+                        out[n++] = '\f';
+                    } else if (next >= '0' && next <= '7') {
+                        --i;
+                        out[n++] = static_cast<char>(parse_digits(body, i, 3, 8));
+                    } else if (next == 'x' && i < body.size() && std::isxdigit(static_cast<uint8_t>(body[i]))) {
+                        out[n++] = static_cast<char>(parse_digits(body, i, 2, 16));
+                    } else if (next == 'u' || next == 'U') {
+                        size_t digits_start = i;
+                        size_t width = next == 'u' ? 4 : 8;
+                        uint32_t code_point = parse_digits(body, i, width, 16);
+                        bool complete = i - digits_start == width;
+                        if (complete && code_point >= 0xD800 && code_point <= 0xDBFF &&
+                            i + 6 <= body.size() && body[i] == '\\' && body[i + 1] == 'u') {
+                            size_t low_start = i + 2;
+                            size_t j = low_start;
+                            uint32_t low = parse_digits(body, j, 4, 16);
+                            if (j - low_start == 4 && low >= 0xDC00 && low <= 0xDFFF) {
+                                code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00);
+                                i = j;
+                            }
+                        }
+                        bool valid = complete && code_point <= 0x10FFFF &&
+                                     (code_point < 0xD800 || code_point > 0xDFFF);
+                        if (valid) {
+                            n += encode_utf8(code_point, out + n);
+                        } else {
+                            // Malformed escapes are kept verbatim
+                            for (size_t k = escape_start; k < i; ++k) {
+                                out[n++] = body[k];
+                            }
+                        }
+                    } else {
+                        out[n++] = next;
+                    }
+                } else if (next == '0') {
+                    out[n++] = '\0';
+                } else if (next == 'Z') {
+                    out[n++] = '\x1A';
+                } else if (next == '%' || next == '_') {
+                    out[n++] = '\\';
+                    out[n++] = next;
+                } else {
+                    out[n++] = next;
+                }
+                break;
+        }
+    }
+    
+    return n;
+}
+
+}  // namespace
+
+std::string_view Token::unescaped(StringArena& arena) const {
+    return unescaped(arena, CpuDetection::configured_level());
+}
+
+std::string_view Token::unescaped(StringArena& arena, SimdLevel level) const {
+    if (!(flags & TOKEN_FLAG_QUOTED)) {
+        return value;
+    }
+    
+    if (flags & TOKEN_FLAG_DOLLAR_QUOTED) {
+        size_t tag_length = value.find('$', 1) + 1;
+        size_t closing = (flags & TOKEN_FLAG_UNTERMINATED) ? 0 : tag_length;
+        return value.substr(tag_length, value.size() - tag_length - closing);
+    }
+    
+    // E'...' literals carry a one-letter prefix before the quote
+    size_t prefix = (value.front() == 'E' || value.front() == 'e') ? 1 : 0;
+    size_t closing = (flags & TOKEN_FLAG_UNTERMINATED) ? 0 : 1;
+    std::string_view body = value.substr(prefix + 1, value.size() - prefix - 1 - closing);
+    if (!(flags & TOKEN_FLAG_ESCAPED)) {
+        return body;
+    }
+    
+    uint8_t quote = closing_quote(static_cast<uint8_t>(value[prefix]));
+    char* out = arena.allocate(body.size());
+    if (flags & TOKEN_FLAG_BACKSLASH) {
+        return {out, decode_backslash_escapes(body, static_cast<char>(quote), prefix != 0, out)};
+    }
+    
+    size_t length = SimdDispatcher(level).dispatch([&](auto processor) {
+        return processor.unescape_quotes(
+            reinterpret_cast<const std::byte*>(body.data()), body.size(), quote, out);
+    });
+    
+    return {out, length};
+}
+
+template<typename Dialect, typename Stats>
+void BasicSimdTokenizer<Dialect, Stats>::update_position(size_t count) {
         for (size_t i = 0; i < count; ++i) {
             uint8_t ch = static_cast<uint8_t>(input_[position_]);
             if (ch == '\n') {
@@ -301,4 +843,37 @@ void SimdTokenizer::update_position(size_t count) {
         }
 }
 
+// Advances over a long span, counting newlines with the vectorized kernel
+// instead of stepping byte by byte.
+template<typename Dialect, typename Stats>
+void BasicSimdTokenizer<Dialect, Stats>::skip_span(size_t count) {
+        const std::byte* span = input_ + position_;
+        size_t newlines = dispatcher_.dispatch([&](auto processor) {
+            return processor.count_byte(span, count, '\n');
+        });
+        
+        if (newlines == 0) {
+            column_ += count;
+        } else {
+            size_t last = count;
+            while (static_cast<uint8_t>(span[last - 1]) != '\n') {
+                --last;
+            }
+            line_ += newlines;
+            column_ = count - last + 1;
+        }
+        position_ += count;
+}
+
+#define DB25_INSTANTIATE_TOKENIZER(Dialect) \
+    template class BasicSimdTokenizer<Dialect, NoStats>; \
+    template class BasicSimdTokenizer<Dialect, CountStats>; \
+    template class BasicSimdTokenizer<Dialect, ProfileStats>;
+DB25_INSTANTIATE_TOKENIZER(GenericDialect)
+DB25_INSTANTIATE_TOKENIZER(PostgresDialect)
+DB25_INSTANTIATE_TOKENIZER(MySqlDialect)
+DB25_INSTANTIATE_TOKENIZER(SqlServerDialect)
+#undef DB25_INSTANTIATE_TOKENIZER
+#undef DB25_PHASE_SCOPE
+
 }  // namespace db25
\ No newline at end of file
@@ -0,0 +1,365 @@
+/*
+ * Copyright (c) 2024 Chiradip Mandal
+ * Author: Chiradip Mandal
+ * Organization: Space-RF.org
+ *
+ * This file is part of DB25 SQL Tokenizer.
+ *
+ * Licensed under the MIT License. See LICENSE file for details.
+ */
+
+#include "token_file.hpp"
+#include <bit>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define DB25_TOKEN_FILE_MMAP 1
+#endif
+
+namespace db25 {
+
+namespace {
+
+constexpr char kMagic[8] = {'D', 'B', '2', '5', 'T', 'O', 'K', '\0'};
+constexpr uint32_t kByteOrderMark = 0x01020304;
+constexpr size_t kAlignment = 64;
+
+// Bump when the header, the stream encoding or the token types change
+constexpr uint32_t kFormatVersion = 1;
+static_assert(kTokenTypeCount == 10, "Token types are part of the token file format; bump kFormatVersion");
+
+struct FileHeader {
+    char magic[8];
+    uint32_t format_version;
+    uint32_t byte_order;
+    uint64_t keyword_table;
+    uint64_t operator_table;
+    uint64_t token_count;
+    uint64_t source_size;
+    uint64_t source_hash;
+    uint64_t source_offset;   // 0 when the source is not embedded
+    uint64_t blocks_offset;
+    uint64_t block_count;
+    uint64_t bytes_offset;
+    uint64_t bytes_size;
+};
+
+static_assert(sizeof(FileHeader) == 96 && std::is_trivially_copyable_v<FileHeader>);
+static_assert(sizeof(TokenStreamBlock) == 32 && std::is_trivially_copyable_v<TokenStreamBlock>);
+
+constexpr uint64_t align_up(uint64_t value) noexcept {
+    return (value + kAlignment - 1) & ~uint64_t{kAlignment - 1};
+}
+
+// Whether [offset, offset + size) lies within a file of `file_size` bytes
+constexpr bool within(uint64_t offset, uint64_t size, uint64_t file_size) noexcept {
+    return offset <= file_size && size <= file_size - offset;
+}
+
+#ifdef DB25_TOKEN_FILE_MMAP
+// Writes all `size` bytes, retrying short and interrupted writes
+bool write_all(int fd, const char* data, size_t size) noexcept {
+    while (size > 0) {
+        ssize_t written = ::write(fd, data, size);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            return false;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+// Makes a rename in `directory` durable; best effort
+void sync_directory(const std::filesystem::path& directory) noexcept {
+    int fd = ::open(directory.empty() ? "." : directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd >= 0) {
+        ::fsync(fd);
+        ::close(fd);
+    }
+}
+#endif
+
+inline uint64_t load64(const char* data) noexcept {
+    uint64_t value;
+    std::memcpy(&value, data, sizeof(value));
+    if constexpr (std::endian::native == std::endian::big) {
+        value = std::byteswap(value);
+    }
+    return value;
+}
+
+// Rounds of the xxHash64 kind over four independent lanes, so the loop is
+// bound by loads rather than by one multiply chain
+constexpr uint64_t kPrime1 = 0x9E3779B185EBCA87ULL;
+constexpr uint64_t kPrime2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr uint64_t kPrime3 = 0x165667B19E3779F9ULL;
+
+inline uint64_t hash_round(uint64_t lane, uint64_t word) noexcept {
+    return std::rotl(lane + word * kPrime2, 31) * kPrime1;
+}
+
+}  // namespace
+
+std::string_view token_file_error_name(TokenFileError error) noexcept {
+    switch (error) {
+        case TokenFileError::Io: return "I/O error";
+        case TokenFileError::NotATokenFile: return "not a token file";
+        case TokenFileError::UnsupportedVersion: return "unsupported token file version";
+        case TokenFileError::TableMismatch: return "keyword or operator table mismatch";
+        case TokenFileError::Corrupt: return "corrupt token file";
+    }
+    return "unknown error";
+}
+
+uint64_t token_source_hash(std::string_view source) noexcept {
+    const char* data = source.data();
+    size_t size = source.size();
+    uint64_t hash = kPrime3 ^ (size * kPrime1);
+
+    size_t i = 0;
+    if (size >= 32) {
+        uint64_t lanes[4] = {kPrime1 + kPrime2, kPrime2, 0, 0 - kPrime1};
+        for (; i + 32 <= size; i += 32) {
+            for (size_t lane = 0; lane < 4; ++lane) {
+                lanes[lane] = hash_round(lanes[lane], load64(data + i + 8 * lane));
+            }
+        }
+        for (uint64_t lane : lanes) {
+            hash = (hash ^ hash_round(0, lane)) * kPrime1 + kPrime3;
+        }
+    }
+    for (; i + 8 <= size; i += 8) {
+        hash = std::rotl(hash ^ hash_round(0, load64(data + i)), 27) * kPrime1 + kPrime3;
+    }
+    for (; i < size; ++i) {
+        hash = std::rotl(hash ^ (static_cast<uint8_t>(data[i]) * kPrime1), 11) * kPrime2;
+    }
+
+    hash ^= hash >> 33;
+    hash *= kPrime2;
+    hash ^= hash >> 29;
+    hash *= kPrime3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+TokenFile::~TokenFile() {
+    release();
+}
+
+TokenFile::TokenFile(TokenFile&& other) noexcept
+    : data_(std::exchange(other.data_, nullptr))
+    , size_(std::exchange(other.size_, 0))
+    , stream_(std::exchange(other.stream_, {}))
+    , source_(std::exchange(other.source_, {}))
+    , has_source_(std::exchange(other.has_source_, false))
+    , source_hash_(std::exchange(other.source_hash_, 0)) {}
+
+TokenFile& TokenFile::operator=(TokenFile&& other) noexcept {
+    if (this != &other) {
+        release();
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+        stream_ = std::exchange(other.stream_, {});
+        source_ = std::exchange(other.source_, {});
+        has_source_ = std::exchange(other.has_source_, false);
+        source_hash_ = std::exchange(other.source_hash_, 0);
+    }
+    return *this;
+}
+
+void TokenFile::release() noexcept {
+    if (data_ != nullptr) {
+#ifdef DB25_TOKEN_FILE_MMAP
+        munmap(const_cast<std::byte*>(data_), size_);
+#else
+        delete[] data_;
+#endif
+        data_ = nullptr;
+    }
+}
+
+bool TokenFile::matches(std::string_view source) const noexcept {
+    return source.size() == stream_.source_size() && token_source_hash(source) == source_hash_;
+}
+
+bool TokenFile::verify() const noexcept {
+    return stream_.valid() && (!has_source_ || matches(source_));
+}
+
+std::expected<void, TokenFileError> write_token_file(
+    const std::filesystem::path& path, std::span<const Token> tokens, std::string_view source,
+    TokenFileOptions options) {
+    CompressedTokenStream compressed = CompressedTokenStream::encode(tokens, source);
+    TokenStreamView stream = compressed.view();
+
+    FileHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.format_version = kFormatVersion;
+    header.byte_order = kByteOrderMark;
+    header.keyword_table = kKeywordTableVersion;
+    header.operator_table = kOperatorTableVersion;
+    header.token_count = stream.size();
+    header.source_size = source.size();
+    header.source_hash = token_source_hash(source);
+    header.blocks_offset = align_up(sizeof(FileHeader));
+    header.block_count = stream.block_count();
+    header.bytes_offset = align_up(header.blocks_offset + stream.blocks().size_bytes());
+    header.bytes_size = stream.bytes().size();
+    if (options.embed_source) {
+        header.source_offset = align_up(header.bytes_offset + header.bytes_size);
+    }
+
+    std::filesystem::path temporary = path;
+#ifdef DB25_TOKEN_FILE_MMAP
+    // A unique name next to `path`: concurrent writers never share a
+    // temporary, and the rename stays within one filesystem
+    std::string name = path.string() + ".XXXXXX";
+    int fd = ::mkstemp(name.data());
+    if (fd < 0) {
+        return std::unexpected(TokenFileError::Io);
+    }
+    temporary = name;
+    auto write = [fd](const char* data, size_t size) { return write_all(fd, data, size); };
+#else
+    temporary += ".tmp";
+    std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+    auto write = [&out](const char* data, size_t size) {
+        return static_cast<bool>(out.write(data, static_cast<std::streamsize>(size)));
+    };
+#endif
+
+    bool ok = true;
+    uint64_t position = 0;
+    auto put = [&](const void* data, uint64_t offset, size_t size) {
+        static const char zeros[kAlignment] = {};
+        ok = ok && write(zeros, offset - position) && write(static_cast<const char*>(data), size);
+        position = offset + size;
+    };
+    put(&header, 0, sizeof(header));
+    put(stream.blocks().data(), header.blocks_offset, stream.blocks().size_bytes());
+    put(stream.bytes().data(), header.bytes_offset, stream.bytes().size());
+    if (options.embed_source) {
+        put(source.data(), header.source_offset, source.size());
+    }
+
+#ifdef DB25_TOKEN_FILE_MMAP
+    // mkstemp() creates the file readable by its owner only. The data must
+    // reach the disk before the rename publishes it, or a crash could leave
+    // a complete name over incomplete contents.
+    ok = ok && ::fchmod(fd, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH) == 0 && ::fsync(fd) == 0;
+    ok = ::close(fd) == 0 && ok;
+#else
+    out.close();
+    ok = ok && !out.fail();
+#endif
+    std::error_code error;
+    if (ok) {
+        std::filesystem::rename(temporary, path, error);
+    }
+    if (!ok || error) {
+        std::filesystem::remove(temporary, error);
+        return std::unexpected(TokenFileError::Io);
+    }
+#ifdef DB25_TOKEN_FILE_MMAP
+    sync_directory(path.parent_path());
+#endif
+    return {};
+}
+
+std::expected<TokenFile, TokenFileError> open_token_file(const std::filesystem::path& path) {
+    TokenFile file;
+
+#ifdef DB25_TOKEN_FILE_MMAP
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return std::unexpected(TokenFileError::Io);
+    }
+    struct stat status;
+    if (::fstat(fd, &status) != 0) {
+        ::close(fd);
+        return std::unexpected(TokenFileError::Io);
+    }
+    if (static_cast<uint64_t>(status.st_size) < sizeof(FileHeader)) {
+        ::close(fd);
+        return std::unexpected(TokenFileError::NotATokenFile);
+    }
+    size_t size = static_cast<size_t>(status.st_size);
+    void* mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        return std::unexpected(TokenFileError::Io);
+    }
+    file.data_ = static_cast<const std::byte*>(mapping);
+    file.size_ = size;
+#else
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) {
+        return std::unexpected(TokenFileError::Io);
+    }
+    size_t size = static_cast<size_t>(in.tellg());
+    if (size < sizeof(FileHeader)) {
+        return std::unexpected(TokenFileError::NotATokenFile);
+    }
+    auto* data = new std::byte[size];
+    file.data_ = data;
+    file.size_ = size;
+    in.seekg(0);
+    if (!in.read(reinterpret_cast<char*>(data), static_cast<std::streamsize>(size))) {
+        return std::unexpected(TokenFileError::Io);
+    }
+#endif
+
+    FileHeader header;
+    std::memcpy(&header, file.data_, sizeof(header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) {
+        return std::unexpected(TokenFileError::NotATokenFile);
+    }
+    if (header.format_version != kFormatVersion || header.byte_order != kByteOrderMark) {
+        return std::unexpected(TokenFileError::UnsupportedVersion);
+    }
+    if (header.keyword_table != kKeywordTableVersion || header.operator_table != kOperatorTableVersion) {
+        return std::unexpected(TokenFileError::TableMismatch);
+    }
+
+    constexpr size_t kBlockTokens = TokenStreamView::kBlockTokens;
+    bool embedded = header.source_offset != 0;
+    if (header.block_count != header.token_count / kBlockTokens + (header.token_count % kBlockTokens != 0) ||
+        header.blocks_offset % alignof(TokenStreamBlock) != 0 ||
+        header.block_count > size / sizeof(TokenStreamBlock) ||
+        !within(header.blocks_offset, header.block_count * sizeof(TokenStreamBlock), size) ||
+        !within(header.bytes_offset, header.bytes_size, size) ||
+        (embedded && !within(header.source_offset, header.source_size, size))) {
+        return std::unexpected(TokenFileError::Corrupt);
+    }
+
+    const std::byte* data = file.data_;
+    file.stream_ = TokenStreamView(
+        {reinterpret_cast<const TokenStreamBlock*>(data + header.blocks_offset), header.block_count},
+        {reinterpret_cast<const uint8_t*>(data + header.bytes_offset), header.bytes_size},
+        header.token_count, header.source_size);
+    if (!file.stream_.valid_blocks()) {
+        return std::unexpected(TokenFileError::Corrupt);
+    }
+    if (embedded) {
+        file.source_ = {reinterpret_cast<const char*>(data + header.source_offset), header.source_size};
+    }
+    file.has_source_ = embedded;
+    file.source_hash_ = header.source_hash;
+    return file;
+}
+
+}  // namespace db25
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2024 Chiradip Mandal
+ * Author: Chiradip Mandal
+ * Organization: Space-RF.org
+ *
+ * This file is part of DB25 SQL Tokenizer.
+ *
+ * Licensed under the MIT License. See LICENSE file for details.
+ */
+
+#include "token_pipeline.hpp"
+#include <algorithm>
+#include <bit>
+
+namespace db25 {
+
+TokenRing::TokenRing(size_t block_tokens, size_t blocks)
+    : block_tokens_(std::max<size_t>(block_tokens, 1)),
+      mask_(std::bit_ceil(std::max<size_t>(blocks, 1)) - 1),
+      tokens_(std::make_unique_for_overwrite<Token[]>(block_tokens_ * (mask_ + 1))),
+      slots_(std::make_unique<Slot[]>(mask_ + 1)) {}
+
+std::span<Token> TokenRing::acquire() {
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    for (;;) {
+        if (closed_.load(std::memory_order_acquire)) {
+            return {};
+        }
+        size_t head = head_.load(std::memory_order_acquire);
+        if (tail - head <= mask_) {
+            break;
+        }
+        head_.wait(head, std::memory_order_acquire);
+    }
+    return {tokens_.get() + (tail & mask_) * block_tokens_, block_tokens_};
+}
+
+void TokenRing::publish(size_t count, bool last) {
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    slots_[tail & mask_] = {count, last};
+    tail_.store(tail + 1, std::memory_order_release);
+    tail_.notify_one();
+}
+
+std::span<const Token> TokenRing::next() {
+    size_t head = head_.load(std::memory_order_relaxed);
+    if (holding_) {
+        holding_ = false;
+        head_.store(++head, std::memory_order_release);
+        head_.notify_one();
+    }
+    if (finished_) {
+        return {};
+    }
+
+    tail_.wait(head, std::memory_order_acquire);
+    const Slot& slot = slots_[head & mask_];
+    finished_ = slot.last;
+    if (slot.count == 0) {
+        // Only the last block can be empty
+        head_.store(head + 1, std::memory_order_release);
+        head_.notify_one();
+        return {};
+    }
+    holding_ = true;
+    return {tokens_.get() + (head & mask_) * block_tokens_, slot.count};
+}
+
+void TokenRing::close() {
+    closed_.store(true, std::memory_order_release);
+    holding_ = false;
+    finished_ = true;
+    // Releasing every published block wakes a producer waiting on a full ring
+    head_.store(tail_.load(std::memory_order_acquire), std::memory_order_release);
+    head_.notify_one();
+}
+
+TokenPipeline::TokenPipeline(std::string_view sql, TokenPipelineOptions options)
+    : ring_(options.block_tokens, options.ring_blocks),
+      producer_([this, sql, tokenize = options.tokenize] { tokenize(sql, ring_); }) {}
+
+TokenPipeline::~TokenPipeline() {
+    ring_.close();
+    producer_.join();
+}
+
+}  // namespace db25
@@ -0,0 +1,416 @@
+/*
+ * Copyright (c) 2024 Chiradip Mandal
+ * Author: Chiradip Mandal
+ * Organization: Space-RF.org
+ *
+ * This file is part of DB25 SQL Tokenizer.
+ *
+ * Licensed under the MIT License. See LICENSE file for details.
+ */
+
+#include "token_stream.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+
+namespace db25 {
+
+namespace {
+
+// Tag byte: bits 0-3 kind, bits 4-5 gap code, bits 6-7 length code
+constexpr unsigned kKindBits = 0x0F;
+constexpr unsigned kGapShift = 4;
+constexpr unsigned kLengthShift = 6;
+
+// What a kind's data bytes after gap and length hold
+enum class Aux : uint8_t {
+    None,
+    KeywordId,
+    OperatorId,
+    Flags,
+    Raw   // type, flags, keyword ID and operator ID, one byte each
+};
+
+// One field of the aux bytes: (aux >> shift) & mask, 0 when the kind has none
+struct Field {
+    uint8_t shift = 0;
+    uint8_t mask = 0;
+
+    [[nodiscard]] constexpr uint8_t extract(uint64_t aux) const noexcept {
+        return static_cast<uint8_t>((aux >> shift) & mask);
+    }
+};
+
+// Decoding reads every field through the table, with no branch on the kind
+struct Kind {
+    TokenType type = TokenType::Unknown;
+    Aux aux = Aux::None;
+    uint8_t aux_bytes = 0;
+    Field type_field;   // Raw only; ORed into `type`
+    Field flags;
+    Field keyword;
+    Field op;
+};
+
+// Kinds 0-9 are the token types with no flags set; keywords and operators
+// carry their ID. Flagged identifiers and strings (quoted, escaped, ...)
+// carry the flags; anything else is stored raw.
+constexpr uint8_t kFlaggedIdentifier = 10;
+constexpr uint8_t kFlaggedString = 11;
+constexpr uint8_t kRaw = 15;
+
+static_assert(kTokenTypeCount <= kFlaggedIdentifier, "Token types must fit below the flagged kinds");
+static_assert(KEYWORDS.size() < 256 && OPERATORS.size() < 256, "Keyword and operator IDs are stored in one byte");
+
+constexpr Aux plain_aux(TokenType type) noexcept {
+    switch (type) {
+        case TokenType::Keyword: return Aux::KeywordId;
+        case TokenType::Operator:
+        case TokenType::Delimiter: return Aux::OperatorId;
+        default: return Aux::None;
+    }
+}
+
+constexpr std::array<Kind, 16> kKinds = [] {
+    constexpr Field kByte0{0, 0xFF};
+    std::array<Kind, 16> kinds{};
+    for (size_t i = 0; i < kTokenTypeCount; ++i) {
+        Kind& kind = kinds[i];
+        kind.type = static_cast<TokenType>(i);
+        kind.aux = plain_aux(kind.type);
+        kind.aux_bytes = kind.aux == Aux::None ? 0 : 1;
+        if (kind.aux == Aux::KeywordId) kind.keyword = kByte0;
+        if (kind.aux == Aux::OperatorId) kind.op = kByte0;
+    }
+    kinds[kFlaggedIdentifier] = {TokenType::Identifier, Aux::Flags, 1, {}, kByte0, {}, {}};
+    kinds[kFlaggedString] = {TokenType::String, Aux::Flags, 1, {}, kByte0, {}, {}};
+    kinds[kRaw] = {TokenType::Unknown, Aux::Raw, 4, kByte0, {8, 0xFF}, {16, 0xFF}, {24, 0xFF}};
+    return kinds;
+}();
+
+// Gap codes: 0 and 1 are the gap itself, 2 and 3 read it from 1 or 8 bytes
+constexpr std::array<uint8_t, 4> kGapBytes = {0, 0, 1, 8};
+constexpr std::array<uint64_t, 4> kGapMask = {0, 0, 0xFF, ~uint64_t{0}};
+
+// Length codes: 0 means the kind and ID imply it, else 1, 2 or 8 bytes
+constexpr std::array<uint8_t, 4> kLengthBytes = {0, 1, 2, 8};
+constexpr std::array<uint64_t, 4> kLengthMask = {0, 0xFF, 0xFFFF, ~uint64_t{0}};
+
+// Length implied by kind and first aux byte: the spelling of the keyword or
+// operator ID, 0 for UNKNOWN and for kinds without an ID
+constexpr std::array<std::array<uint8_t, 256>, 16> kImpliedLength = [] {
+    std::array<std::array<uint8_t, 256>, 16> lengths{};
+    for (size_t kind = 0; kind < kKinds.size(); ++kind) {
+        if (kKinds[kind].aux == Aux::KeywordId) {
+            for (const auto& entry : KEYWORDS) {
+                lengths[kind][static_cast<size_t>(entry.id)] = entry.length;
+            }
+        } else if (kKinds[kind].aux == Aux::OperatorId) {
+            for (const auto& entry : OPERATORS) {
+                lengths[kind][static_cast<size_t>(entry.id)] = static_cast<uint8_t>(entry.text.size());
+            }
+        }
+    }
+    return lengths;
+}();
+
+// Where a token's fields sit in its data bytes, per tag. As in streamvbyte,
+// the layout comes from the tag alone, so finding the next token's data is
+// one add instead of a chain of loads through the field widths.
+struct Layout {
+    uint8_t length_at;   // The gap starts at 0
+    uint8_t aux_at;
+    uint8_t size;
+};
+
+constexpr std::array<Layout, 256> kLayouts = [] {
+    std::array<Layout, 256> layouts{};
+    for (unsigned tag = 0; tag < 256; ++tag) {
+        unsigned length_at = kGapBytes[(tag >> kGapShift) & 3];
+        unsigned aux_at = length_at + kLengthBytes[tag >> kLengthShift];
+        unsigned size = aux_at + kKinds[tag & kKindBits].aux_bytes;
+        layouts[tag] = {static_cast<uint8_t>(length_at), static_cast<uint8_t>(aux_at), static_cast<uint8_t>(size)};
+    }
+    return layouts;
+}();
+
+// Longest data of one token, whatever its tag
+constexpr size_t kMaxTokenBytes = [] {
+    size_t longest = 0;
+    for (const Layout& layout : kLayouts) {
+        longest = std::max<size_t>(longest, layout.size);
+    }
+    return longest;
+}();
+
+// Trailing zero bytes so every field can be read with one 8-byte load
+constexpr size_t kPadding = 8;
+
+inline uint64_t load64(const uint8_t* data) noexcept {
+    uint64_t value;
+    std::memcpy(&value, data, sizeof(value));
+    if constexpr (std::endian::native == std::endian::big) {
+        value = std::byteswap(value);
+    }
+    return value;
+}
+
+// Tags plus data of `count` tokens whose tags start at `tags`
+inline uint64_t block_bytes(const uint8_t* tags, size_t count) noexcept {
+    uint64_t size = count;
+    for (size_t i = 0; i < count; ++i) {
+        size += kLayouts[tags[i]].size;
+    }
+    return size;
+}
+
+inline void store(std::vector<uint8_t>& bytes, uint64_t value, size_t width) {
+    for (size_t i = 0; i < width; ++i) {
+        bytes.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+struct Extent {
+    uint64_t offset;
+    uint64_t length;
+    TokenType type;
+    Keyword keyword;
+    Operator op;
+    uint8_t flags;
+};
+
+}  // namespace
+
+CompressedTokenStream CompressedTokenStream::encode(std::span<const Token> tokens, std::string_view source) {
+    CompressedTokenStream stream;
+    stream.token_count_ = tokens.size();
+    stream.source_size_ = source.size();
+    stream.blocks_.reserve((tokens.size() + kBlockTokens - 1) / kBlockTokens);
+    stream.bytes_.reserve(tokens.size() * 3 + kPadding);
+
+    std::vector<uint8_t>& bytes = stream.bytes_;
+    for (size_t first = 0; first < tokens.size(); first += kBlockTokens) {
+        size_t count = std::min(kBlockTokens, tokens.size() - first);
+        const Token& head = tokens[first];
+        uint64_t end = static_cast<uint64_t>(head.value.data() - source.data());
+        stream.blocks_.push_back({end, head.line, head.column, bytes.size()});
+
+        size_t tags = bytes.size();
+        bytes.resize(tags + count);
+        for (size_t i = 0; i < count; ++i) {
+            const Token& token = tokens[first + i];
+            uint64_t offset = static_cast<uint64_t>(token.value.data() - source.data());
+            uint64_t gap = offset - end;
+            uint64_t length = token.value.size();
+            end = offset + length;
+
+            uint8_t kind;
+            uint64_t aux;
+            Aux plain = plain_aux(token.type);
+            if (token.flags == TOKEN_FLAG_NONE &&
+                (plain == Aux::KeywordId || token.keyword_id == Keyword::UNKNOWN) &&
+                (plain == Aux::OperatorId || token.operator_id == Operator::UNKNOWN)) {
+                kind = static_cast<uint8_t>(token.type);
+                aux = plain == Aux::KeywordId ? static_cast<uint64_t>(token.keyword_id)
+                                              : static_cast<uint64_t>(token.operator_id);
+            } else if ((token.type == TokenType::Identifier || token.type == TokenType::String) &&
+                       token.keyword_id == Keyword::UNKNOWN && token.operator_id == Operator::UNKNOWN) {
+                kind = token.type == TokenType::Identifier ? kFlaggedIdentifier : kFlaggedString;
+                aux = token.flags;
+            } else {
+                kind = kRaw;
+                aux = static_cast<uint64_t>(token.type) | static_cast<uint64_t>(token.flags) << 8 |
+                      static_cast<uint64_t>(token.keyword_id) << 16 |
+                      static_cast<uint64_t>(token.operator_id) << 24;
+            }
+            const Kind& info = kKinds[kind];
+
+            unsigned gap_code = gap <= 1 ? static_cast<unsigned>(gap) : gap <= 0xFF ? 2 : 3;
+            unsigned length_code = length == kImpliedLength[kind][aux & 0xFF] ? 0
+                                 : length <= 0xFF ? 1 : length <= 0xFFFF ? 2 : 3;
+
+            bytes[tags + i] = static_cast<uint8_t>(kind | gap_code << kGapShift | length_code << kLengthShift);
+            store(bytes, gap, kGapBytes[gap_code]);
+            store(bytes, length, kLengthBytes[length_code]);
+            store(bytes, aux, info.aux_bytes);
+        }
+    }
+
+    bytes.resize(bytes.size() + kPadding);
+    bytes.shrink_to_fit();
+    return stream;
+}
+
+// Calls `sink` with the extent and IDs of each token in `block`, in order
+template<typename Sink>
+void TokenStreamView::decode_extents(size_t block, Sink&& sink) const {
+    const TokenStreamBlock& header = blocks_[block];
+    size_t count = std::min(kBlockTokens, token_count_ - block * kBlockTokens);
+    const uint8_t* tags = bytes_.data() + header.data;
+    const uint8_t* data = tags + count;
+    uint64_t end = header.offset;
+
+    for (size_t i = 0; i < count; ++i) {
+        unsigned tag = tags[i];
+        const Kind& kind = kKinds[tag & kKindBits];
+        unsigned gap_code = (tag >> kGapShift) & 3;
+        unsigned length_code = tag >> kLengthShift;
+
+        const Layout& layout = kLayouts[tag];
+
+        uint64_t gap = (load64(data) & kGapMask[gap_code]) + (gap_code == 1);
+        uint64_t length = load64(data + layout.length_at) & kLengthMask[length_code];
+        uint64_t aux = load64(data + layout.aux_at);
+        data += layout.size;
+
+        if (length_code == 0) {
+            length = kImpliedLength[tag & kKindBits][aux & 0xFF];
+        }
+
+        Extent extent{end + gap, length,
+                      static_cast<TokenType>(static_cast<uint8_t>(kind.type) | kind.type_field.extract(aux)),
+                      static_cast<Keyword>(kind.keyword.extract(aux)),
+                      static_cast<Operator>(kind.op.extract(aux)),
+                      kind.flags.extract(aux)};
+        end = extent.offset + extent.length;
+        sink(extent);
+    }
+}
+
+size_t TokenStreamView::decode_block(size_t block, std::string_view source, std::span<Token> out) const {
+    const TokenStreamBlock& header = blocks_[block];
+    const char* text = source.data();
+
+    // Line and column are recounted like the tokenizer counts them: a newline
+    // starts the next line at column 1. Every token of the block starts
+    // before the next block, so the newlines are found with one pass of
+    // memchr over the block's text, not a scan per token.
+    // Bounded by the text passed in as well: a shorter one than was encoded
+    // yields truncated values, never reads past its end
+    uint64_t size = std::min<uint64_t>(source_size_, source.size());
+    uint64_t limit = std::min(block + 1 < blocks_.size() ? blocks_[block + 1].offset : size, size);
+    auto find_newline = [&](uint64_t from) -> uint64_t {
+        const void* found = from < limit ? std::memchr(text + from, '\n', limit - from) : nullptr;
+        return found ? static_cast<uint64_t>(static_cast<const char*>(found) - text) : limit;
+    };
+    uint64_t line = header.line;
+    uint64_t line_start = header.offset - (header.column - 1);
+    uint64_t newline = find_newline(header.offset);
+    size_t written = 0;
+
+    decode_extents(block, [&](const Extent& extent) {
+        // Clamped so damaged data never views outside the text; valid()
+        // rejects such streams, the clamp only keeps unchecked ones safe
+        uint64_t offset = std::min(extent.offset, limit);
+        uint64_t length = std::min(extent.length, size - offset);
+        while (newline < offset) {
+            ++line;
+            line_start = newline + 1;
+            newline = find_newline(newline + 1);
+        }
+        out[written++] = Token{extent.type, std::string_view(text + offset, length),
+                               extent.keyword, extent.flags, extent.op, line, offset - line_start + 1};
+    });
+    return written;
+}
+
+std::vector<Token> TokenStreamView::decode(std::string_view source) const {
+    std::vector<Token> tokens(token_count_);
+    for (size_t block = 0; block < blocks_.size(); ++block) {
+        size_t first = block * kBlockTokens;
+        decode_block(block, source, std::span<Token>(tokens).subspan(first));
+    }
+    return tokens;
+}
+
+Token TokenStreamView::token(size_t index, std::string_view source) const {
+    Token tokens[kBlockTokens];
+    decode_block(index / kBlockTokens, source, tokens);
+    return tokens[index % kBlockTokens];
+}
+
+bool TokenStreamView::valid_blocks() const noexcept {
+    if (blocks_.size() != (token_count_ + kBlockTokens - 1) / kBlockTokens || bytes_.size() < kPadding) {
+        return false;
+    }
+
+    size_t limit = bytes_.size() - kPadding;
+    uint64_t offset = 0;
+    uint64_t data = 0;
+    for (size_t block = 0; block < blocks_.size(); ++block) {
+        const TokenStreamBlock& header = blocks_[block];
+        size_t count = std::min(kBlockTokens, token_count_ - block * kBlockTokens);
+        // Blocks are stored in order, so each starts after the previous tags
+        if (header.data < data || header.data > limit || count > limit - header.data || header.offset < offset ||
+            header.offset > source_size_ || header.line == 0 || header.column == 0 ||
+            header.column - 1 > header.offset) {
+            return false;
+        }
+        offset = header.offset;
+        data = header.data + count;
+
+        // Whatever its tags say, a block's data fits unless it starts within
+        // kMaxTokenBytes per token of the end; only those blocks are summed
+        uint64_t room = limit - header.data;
+        if (count * (1 + kMaxTokenBytes) > room && block_bytes(bytes_.data() + header.data, count) > room) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool TokenStreamView::valid() const noexcept {
+    if (!valid_blocks()) {
+        return false;
+    }
+
+    uint64_t end = 0;
+    for (size_t block = 0; block < blocks_.size(); ++block) {
+        if (blocks_[block].offset < end) {
+            return false;
+        }
+
+        // Tokens in order, within the source and before the next block
+        uint64_t next = block + 1 < blocks_.size() ? blocks_[block + 1].offset : source_size_;
+        bool inside = true;
+        decode_extents(block, [&](const Extent& extent) {
+            inside = inside && extent.offset >= end && extent.offset <= next && extent.offset <= source_size_ &&
+                     extent.length <= source_size_ - extent.offset &&
+                     static_cast<size_t>(extent.type) < kTokenTypeCount &&
+                     static_cast<size_t>(extent.keyword) <= KEYWORDS.size() &&
+                     static_cast<size_t>(extent.op) <= OPERATORS.size();
+            end = extent.offset + extent.length;
+        });
+        if (!inside) {
+            return false;
+        }
+    }
+    return true;
+}
+
+TokenColumns TokenStreamView::decode_columns() const {
+    TokenColumns columns;
+    columns.types.resize(token_count_);
+    columns.offsets.resize(token_count_);
+    columns.lengths.resize(token_count_);
+    columns.keywords.resize(token_count_);
+    columns.operators.resize(token_count_);
+    columns.flags.resize(token_count_);
+
+    size_t index = 0;
+    for (size_t block = 0; block < blocks_.size(); ++block) {
+        decode_extents(block, [&](const Extent& extent) {
+            columns.types[index] = extent.type;
+            columns.offsets[index] = extent.offset;
+            columns.lengths[index] = extent.length;
+            columns.keywords[index] = extent.keyword;
+            columns.operators[index] = extent.op;
+            columns.flags[index] = extent.flags;
+            ++index;
+        });
+    }
+    return columns;
+}
+
+}  // namespace db25
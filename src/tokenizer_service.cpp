@@ -0,0 +1,886 @@
+/*
+ * Copyright (c) 2024 Chiradip Mandal
+ * Author: Chiradip Mandal
+ * Organization: Space-RF.org
+ *
+ * This file is part of DB25 SQL Tokenizer.
+ *
+ * Licensed under the MIT License. See LICENSE file for details.
+ */
+
+#include "tokenizer_service.hpp"
+#include "token_file.hpp"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <climits>
+#include <cstring>
+#include <deque>
+#include <new>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define DB25_TOKENIZER_SERVICE 1
+#endif
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <ctime>
+#define DB25_HAS_FUTEX 1
+#endif
+
+namespace db25 {
+
+std::string_view tokenizer_service_error_name(TokenizerServiceError error) noexcept {
+    switch (error) {
+        case TokenizerServiceError::Unsupported: return "unsupported";
+        case TokenizerServiceError::Io: return "i/o error";
+        case TokenizerServiceError::NotRunning: return "daemon not running";
+        case TokenizerServiceError::AlreadyRunning: return "daemon already running";
+        case TokenizerServiceError::VersionMismatch: return "version mismatch";
+        case TokenizerServiceError::RequestTooLarge: return "request too large";
+        case TokenizerServiceError::ResponseTooLarge: return "response too large";
+        case TokenizerServiceError::Timeout: return "timeout";
+    }
+    return "unknown";
+}
+
+namespace {
+
+constexpr char kMagic[8] = {'D', 'B', '2', '5', 'S', 'H', 'M', '\0'};
+constexpr uint32_t kLayoutVersion = 1;
+constexpr size_t kAlignment = 64;
+
+// Waits are bounded so that stops, timeouts and exited peers are noticed
+constexpr auto kPollInterval = std::chrono::milliseconds(100);
+constexpr auto kReclaimInterval = std::chrono::seconds(1);
+constexpr auto kStartupGrace = std::chrono::seconds(1);
+constexpr auto kStartupPoll = std::chrono::milliseconds(1);
+constexpr int kReplySpins = 64;
+
+enum DaemonState : uint32_t { kStarting, kRunning, kStopping, kStopped };
+
+// A slot moves Free -> Writing -> Submitted -> Done -> Free. The client
+// marks Submitted as SubmittedWaiting before sleeping, so the daemon wakes
+// only clients that sleep, and as Abandoned when it gives up, so the daemon
+// frees the slot after answering.
+enum SlotState : uint32_t { kFree, kWriting, kSubmitted, kSubmittedWaiting, kDone, kAbandoned };
+
+enum SlotStatus : uint32_t { kOk, kResponseTooLarge };
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free && std::atomic<uint64_t>::is_always_lock_free &&
+                  std::atomic<int64_t>::is_always_lock_free,
+              "atomics in shared memory must be lock-free to be address-free");
+
+struct QueueCell {
+    std::atomic<uint64_t> sequence;
+    uint64_t value;
+};
+
+// Bounded multi-producer, multi-consumer queue of slot indices (Vyukov);
+// the cells follow the header in the segment
+struct QueueControl {
+    alignas(64) std::atomic<uint64_t> enqueue;
+    alignas(64) std::atomic<uint64_t> dequeue;
+};
+
+struct SegmentHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t slot_count;
+    uint64_t queue_capacity;   // Power of two, at least slot_count
+    uint64_t request_bytes;
+    uint64_t response_bytes;
+    uint64_t slot_stride;
+    uint64_t slots_offset;
+    uint64_t submitted_cells_offset;
+    uint64_t free_cells_offset;
+    uint64_t segment_size;
+    uint64_t keyword_table;
+    uint64_t operator_table;
+    int64_t daemon_pid;
+
+    alignas(64) std::atomic<uint32_t> state;
+    std::atomic<uint32_t> daemon_waiting;
+    std::atomic<uint32_t> doorbell;        // Bumped on every submission
+    alignas(64) std::atomic<uint32_t> free_doorbell;   // Bumped on every freed slot
+    std::atomic<uint32_t> free_waiters;
+    alignas(64) std::atomic<uint64_t> requests;
+    std::atomic<uint64_t> cache_hits;
+    std::atomic<uint64_t> errors;
+    std::atomic<uint64_t> reclaimed;
+    QueueControl submitted;
+    QueueControl free;
+};
+
+// Followed by the request text and the response (block headers, then the
+// tags and data of the compressed stream)
+struct SlotHeader {
+    std::atomic<uint32_t> state;
+    uint32_t status;
+    std::atomic<int64_t> owner;   // Client process, 0 when free
+    uint64_t request_size;
+    uint64_t token_count;
+    uint64_t block_count;
+    uint64_t bytes_size;
+    uint32_t cached;
+};
+
+constexpr size_t align_up(size_t value) {
+    return (value + kAlignment - 1) & ~(kAlignment - 1);
+}
+
+constexpr size_t kSlotHeaderSize = align_up(sizeof(SlotHeader));
+
+struct Layout {
+    uint32_t slot_count;
+    size_t queue_capacity;
+    size_t request_bytes;
+    size_t response_bytes;
+    size_t slot_stride;
+    size_t submitted_cells_offset;
+    size_t free_cells_offset;
+    size_t slots_offset;
+    size_t size;
+};
+
+Layout plan(const TokenizerDaemonOptions& options) {
+    Layout layout;
+    layout.slot_count = static_cast<uint32_t>(std::clamp<size_t>(options.slots, 1, size_t{1} << 16));
+    layout.queue_capacity = std::bit_ceil(size_t{layout.slot_count});
+    layout.request_bytes = std::max<size_t>(options.request_bytes, 1);
+    layout.response_bytes = std::max<size_t>(options.response_bytes, kAlignment);
+    layout.slot_stride = kSlotHeaderSize + align_up(layout.request_bytes) + align_up(layout.response_bytes);
+    layout.submitted_cells_offset = align_up(sizeof(SegmentHeader));
+    layout.free_cells_offset = layout.submitted_cells_offset + align_up(layout.queue_capacity * sizeof(QueueCell));
+    layout.slots_offset = layout.free_cells_offset + align_up(layout.queue_capacity * sizeof(QueueCell));
+    layout.size = layout.slots_offset + layout.slot_count * layout.slot_stride;
+    return layout;
+}
+
+// Waits while `word` holds `expected`, for at most `timeout`
+void wait_on(std::atomic<uint32_t>& word, uint32_t expected, std::chrono::nanoseconds timeout) {
+#ifdef DB25_HAS_FUTEX
+    // Not FUTEX_PRIVATE_FLAG: the waker is another process
+    timespec relative{static_cast<time_t>(timeout.count() / 1'000'000'000),
+                      static_cast<long>(timeout.count() % 1'000'000'000)};
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT, expected, &relative, nullptr, 0);
+#else
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (word.load(std::memory_order_acquire) == expected && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+#endif
+}
+
+void wake(std::atomic<uint32_t>& word, int count) {
+#ifdef DB25_HAS_FUTEX
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE, count, nullptr, nullptr, 0);
+#else
+    (void)word;
+    (void)count;
+#endif
+}
+
+#ifdef DB25_TOKENIZER_SERVICE
+
+bool process_alive(int64_t pid) {
+    return pid > 0 && (::kill(static_cast<pid_t>(pid), 0) == 0 || errno == EPERM);
+}
+
+// Accessors for a mapped segment
+class Segment {
+public:
+    explicit Segment(std::byte* base) noexcept : base_(base) {}
+
+    [[nodiscard]] SegmentHeader& header() const noexcept { return *reinterpret_cast<SegmentHeader*>(base_); }
+
+    [[nodiscard]] SlotHeader& slot(size_t index) const noexcept {
+        return *reinterpret_cast<SlotHeader*>(slot_base(index));
+    }
+    [[nodiscard]] char* request(size_t index) const noexcept {
+        return reinterpret_cast<char*>(slot_base(index) + kSlotHeaderSize);
+    }
+    [[nodiscard]] std::byte* response(size_t index) const noexcept {
+        return slot_base(index) + kSlotHeaderSize + align_up(header().request_bytes);
+    }
+
+    bool push_submitted(uint64_t slot) const noexcept {
+        return push(header().submitted, header().submitted_cells_offset, slot);
+    }
+    std::optional<uint64_t> pop_submitted() const noexcept {
+        return pop(header().submitted, header().submitted_cells_offset);
+    }
+    std::optional<uint64_t> pop_free() const noexcept { return pop(header().free, header().free_cells_offset); }
+
+    // Returns a slot to the free queue and wakes one client waiting for it
+    void free_slot(uint64_t index) const noexcept {
+        SlotHeader& slot_header = slot(index);
+        slot_header.owner.store(0, std::memory_order_relaxed);
+        slot_header.state.store(kFree, std::memory_order_release);
+        push(header().free, header().free_cells_offset, index);
+        header().free_doorbell.fetch_add(1, std::memory_order_seq_cst);
+        if (header().free_waiters.load(std::memory_order_seq_cst) > 0) {
+            wake(header().free_doorbell, 1);
+        }
+    }
+
+    void init_queue(QueueControl& queue, uint64_t cells_offset) const noexcept {
+        QueueCell* cells = queue_cells(cells_offset);
+        for (uint64_t i = 0; i < header().queue_capacity; ++i) {
+            new (&cells[i]) QueueCell{{i}, 0};
+        }
+        queue.enqueue.store(0, std::memory_order_relaxed);
+        queue.dequeue.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    std::byte* base_;
+
+    [[nodiscard]] std::byte* slot_base(size_t index) const noexcept {
+        return base_ + header().slots_offset + index * header().slot_stride;
+    }
+    [[nodiscard]] QueueCell* queue_cells(uint64_t offset) const noexcept {
+        return reinterpret_cast<QueueCell*>(base_ + offset);
+    }
+
+    bool push(QueueControl& queue, uint64_t cells_offset, uint64_t value) const noexcept {
+        QueueCell* cells = queue_cells(cells_offset);
+        uint64_t mask = header().queue_capacity - 1;
+        uint64_t position = queue.enqueue.load(std::memory_order_relaxed);
+        for (;;) {
+            QueueCell& cell = cells[position & mask];
+            uint64_t sequence = cell.sequence.load(std::memory_order_acquire);
+            auto difference = static_cast<int64_t>(sequence - position);
+            if (difference == 0) {
+                if (queue.enqueue.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    cell.value = value;
+                    cell.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (difference < 0) {
+                return false;
+            } else {
+                position = queue.enqueue.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    std::optional<uint64_t> pop(QueueControl& queue, uint64_t cells_offset) const noexcept {
+        QueueCell* cells = queue_cells(cells_offset);
+        uint64_t mask = header().queue_capacity - 1;
+        uint64_t position = queue.dequeue.load(std::memory_order_relaxed);
+        for (;;) {
+            QueueCell& cell = cells[position & mask];
+            uint64_t sequence = cell.sequence.load(std::memory_order_acquire);
+            auto difference = static_cast<int64_t>(sequence - (position + 1));
+            if (difference == 0) {
+                if (queue.dequeue.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    uint64_t value = cell.value;
+                    cell.sequence.store(position + mask + 1, std::memory_order_release);
+                    return value;
+                }
+            } else if (difference < 0) {
+                return std::nullopt;
+            } else {
+                position = queue.dequeue.load(std::memory_order_relaxed);
+            }
+        }
+    }
+};
+
+std::string object_name(std::string_view name) {
+    std::string path;
+    if (!name.starts_with('/')) {
+        path += '/';
+    }
+    path += name;
+    return path;
+}
+
+enum class Occupant { None, Starting, Live };
+
+// Who holds `name`: nobody (no segment, or one left by a daemon that died), a
+// daemon that has created the segment but not yet sized or initialized it, or
+// a running daemon
+Occupant segment_occupant(const std::string& name) {
+    int fd = ::shm_open(name.c_str(), O_RDONLY | O_CLOEXEC, 0);
+    if (fd < 0) {
+        return Occupant::None;
+    }
+    struct stat status;
+    Occupant occupant = Occupant::None;
+    if (::fstat(fd, &status) == 0) {
+        if (static_cast<size_t>(status.st_size) < sizeof(SegmentHeader)) {
+            occupant = Occupant::Starting;   // Created, not yet sized
+        } else if (void* data = ::mmap(nullptr, sizeof(SegmentHeader), PROT_READ, MAP_SHARED, fd, 0);
+                   data != MAP_FAILED) {
+            const auto& header = *static_cast<const SegmentHeader*>(data);
+            uint32_t state = header.state.load(std::memory_order_acquire);
+            // While starting, the rest of the header may still be zero: the
+            // pid alone tells (0 until written right after ftruncate())
+            if (state == kStarting) {
+                if (header.daemon_pid == 0 || process_alive(header.daemon_pid)) {
+                    occupant = Occupant::Starting;
+                }
+            } else if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) == 0 && state != kStopped &&
+                       process_alive(header.daemon_pid)) {
+                occupant = Occupant::Live;
+            }
+            ::munmap(data, sizeof(SegmentHeader));
+        }
+    }
+    ::close(fd);
+    return occupant;
+}
+
+#endif
+
+}  // namespace
+
+// Daemon state; the cache is touched only by the thread in run()
+struct TokenizerDaemon::State {
+    struct CacheEntry {
+        std::string sql;
+        CompressedTokenStream stream;
+        size_t bytes = 0;
+        uint64_t sequence = 0;
+    };
+
+    std::string name;
+    TokenizerDaemonOptions options;
+    std::byte* base = nullptr;
+    size_t size = 0;
+    bool unlinked = false;
+
+    std::unordered_map<uint64_t, CacheEntry> cache;      // By token_source_hash()
+    std::deque<std::pair<uint64_t, uint64_t>> cache_order;   // (hash, sequence), oldest first
+    size_t cache_used = 0;
+    uint64_t cache_sequence = 0;
+
+    ~State();
+
+    void unlink_name() noexcept;
+    const CompressedTokenStream* lookup(std::string_view sql) const;
+    void remember(std::string sql, CompressedTokenStream stream);
+    void serve(size_t slot);
+    void reclaim();
+};
+
+TokenizerDaemon::State::~State() {
+#ifdef DB25_TOKENIZER_SERVICE
+    if (base != nullptr) {
+        SegmentHeader& header = Segment(base).header();
+        unlink_name();
+        header.state.store(kStopped, std::memory_order_release);
+        wake(header.free_doorbell, INT_MAX);
+        ::munmap(base, size);
+    }
+#endif
+}
+
+// Removes the name once, before kStopped is published: a daemon started
+// afterwards either finds no segment or this one still live, so it never
+// replaces this segment only to have its own name removed here later
+void TokenizerDaemon::State::unlink_name() noexcept {
+#ifdef DB25_TOKENIZER_SERVICE
+    if (!unlinked) {
+        ::shm_unlink(name.c_str());
+        unlinked = true;
+    }
+#endif
+}
+
+const CompressedTokenStream* TokenizerDaemon::State::lookup(std::string_view sql) const {
+    auto entry = cache.find(token_source_hash(sql));
+    return entry != cache.end() && entry->second.sql == sql ? &entry->second.stream : nullptr;
+}
+
+// Oldest results are evicted first once cache_bytes is exceeded
+void TokenizerDaemon::State::remember(std::string sql, CompressedTokenStream stream) {
+    size_t bytes = sizeof(CacheEntry) + sql.size() + stream.memory_bytes();
+    if (bytes > options.cache_bytes) {
+        return;
+    }
+    uint64_t hash = token_source_hash(sql);
+    auto [entry, inserted] = cache.try_emplace(hash);
+    if (!inserted) {
+        cache_used -= entry->second.bytes;   // Hash collision: the newer text wins
+    }
+    entry->second = {std::move(sql), std::move(stream), bytes, ++cache_sequence};
+    cache_used += bytes;
+    cache_order.emplace_back(hash, cache_sequence);
+
+    while (cache_used > options.cache_bytes) {
+        auto [oldest, sequence] = cache_order.front();
+        cache_order.pop_front();
+        auto evicted = cache.find(oldest);
+        if (evicted != cache.end() && evicted->second.sequence == sequence) {
+            cache_used -= evicted->second.bytes;
+            cache.erase(evicted);
+        }
+    }
+}
+
+void TokenizerDaemon::State::serve(size_t index) {
+#ifdef DB25_TOKENIZER_SERVICE
+    Segment segment(base);
+    SegmentHeader& header = segment.header();
+    SlotHeader& slot = segment.slot(index);
+    std::string_view sql(segment.request(index), std::min<uint64_t>(slot.request_size, header.request_bytes));
+
+    const CompressedTokenStream* stream = options.cache_bytes > 0 ? lookup(sql) : nullptr;
+    bool cached = stream != nullptr;
+    // Tokenized from a private copy: the client's process can still write
+    // to the slot, and cache entries must not depend on it
+    TokenBuffer buffer;
+    CompressedTokenStream fresh;
+    if (!cached) {
+        buffer = options.tokenize(sql);
+        fresh = CompressedTokenStream::encode(buffer.tokens(), buffer.input());
+        stream = &fresh;
+    }
+
+    TokenStreamView view = stream->view();
+    size_t block_bytes = view.blocks().size_bytes();
+    if (block_bytes + view.bytes().size() > header.response_bytes) {
+        slot.status = kResponseTooLarge;
+        slot.token_count = slot.block_count = slot.bytes_size = 0;
+        header.errors.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        std::byte* response = segment.response(index);
+        if (!view.blocks().empty()) {   // An empty stream may have no storage at all
+            std::memcpy(response, view.blocks().data(), block_bytes);
+        }
+        if (!view.bytes().empty()) {
+            std::memcpy(response + block_bytes, view.bytes().data(), view.bytes().size());
+        }
+        slot.status = kOk;
+        slot.token_count = view.size();
+        slot.block_count = view.blocks().size();
+        slot.bytes_size = view.bytes().size();
+    }
+    slot.cached = cached;
+    header.requests.fetch_add(1, std::memory_order_relaxed);
+    if (cached) {
+        header.cache_hits.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    uint32_t previous = slot.state.exchange(kDone, std::memory_order_acq_rel);
+    if (previous == kSubmittedWaiting) {
+        wake(slot.state, 1);
+    } else if (previous == kAbandoned) {
+        segment.free_slot(index);
+    }
+
+    if (!cached && options.cache_bytes > 0) {
+        remember(std::string(buffer.input()), std::move(fresh));
+    }
+#else
+    (void)index;
+#endif
+}
+
+// Frees slots held by clients that exited without freeing them
+void TokenizerDaemon::State::reclaim() {
+#ifdef DB25_TOKENIZER_SERVICE
+    Segment segment(base);
+    SegmentHeader& header = segment.header();
+    for (size_t index = 0; index < header.slot_count; ++index) {
+        SlotHeader& slot = segment.slot(index);
+        uint32_t state = slot.state.load(std::memory_order_acquire);
+        if ((state == kWriting || state == kDone) && !process_alive(slot.owner.load(std::memory_order_relaxed)) &&
+            slot.state.compare_exchange_strong(state, kFree, std::memory_order_acq_rel)) {
+            segment.free_slot(index);
+            header.reclaimed.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+#endif
+}
+
+TokenizerDaemon::TokenizerDaemon(std::unique_ptr<State> state) noexcept : state_(std::move(state)) {}
+TokenizerDaemon::TokenizerDaemon(TokenizerDaemon&&) noexcept = default;
+TokenizerDaemon& TokenizerDaemon::operator=(TokenizerDaemon&&) noexcept = default;
+TokenizerDaemon::~TokenizerDaemon() = default;
+
+std::expected<TokenizerDaemon, TokenizerServiceError> TokenizerDaemon::create(std::string_view name,
+                                                                              TokenizerDaemonOptions options) {
+#ifdef DB25_TOKENIZER_SERVICE
+    auto state = std::make_unique<State>();
+    state->name = object_name(name);
+    state->options = options;
+    Layout layout = plan(options);
+
+    // A segment another daemon is still setting up looks dead for a moment;
+    // it is waited for, and removed only if it stays unfinished past the
+    // grace period (its daemon died while starting)
+    int fd = -1;
+    auto grace_end = std::chrono::steady_clock::now() + kStartupGrace;
+    for (int removed = 0; removed < 2;) {
+        fd = ::shm_open(state->name.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC,
+                        static_cast<mode_t>(options.permissions));
+        if (fd >= 0 || errno != EEXIST) {
+            break;
+        }
+        Occupant occupant = segment_occupant(state->name);
+        if (occupant == Occupant::Live) {
+            return std::unexpected(TokenizerServiceError::AlreadyRunning);
+        }
+        if (occupant == Occupant::Starting && std::chrono::steady_clock::now() < grace_end) {
+            std::this_thread::sleep_for(kStartupPoll);
+            continue;
+        }
+        ::shm_unlink(state->name.c_str());   // Left behind by a daemon that died
+        ++removed;
+    }
+    if (fd < 0) {
+        return std::unexpected(TokenizerServiceError::Io);
+    }
+
+    // fchmod() so the umask does not narrow `permissions`
+    bool ok = ::fchmod(fd, static_cast<mode_t>(options.permissions)) == 0 &&
+              ::ftruncate(fd, static_cast<off_t>(layout.size)) == 0;
+    void* data = ok ? ::mmap(nullptr, layout.size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        ::shm_unlink(state->name.c_str());
+        return std::unexpected(TokenizerServiceError::Io);
+    }
+    state->base = static_cast<std::byte*>(data);
+    state->size = layout.size;
+
+    // The pid first: from here on segment_occupant() can tell a starting
+    // daemon that is alive from one that died
+    auto* header = new (state->base) SegmentHeader{};
+    header->daemon_pid = ::getpid();
+    std::memcpy(header->magic, kMagic, sizeof(kMagic));
+    header->version = kLayoutVersion;
+    header->slot_count = layout.slot_count;
+    header->queue_capacity = layout.queue_capacity;
+    header->request_bytes = layout.request_bytes;
+    header->response_bytes = layout.response_bytes;
+    header->slot_stride = layout.slot_stride;
+    header->slots_offset = layout.slots_offset;
+    header->submitted_cells_offset = layout.submitted_cells_offset;
+    header->free_cells_offset = layout.free_cells_offset;
+    header->segment_size = layout.size;
+    header->keyword_table = kKeywordTableVersion;
+    header->operator_table = kOperatorTableVersion;
+
+    Segment segment(state->base);
+    segment.init_queue(header->submitted, header->submitted_cells_offset);
+    segment.init_queue(header->free, header->free_cells_offset);
+    for (size_t index = 0; index < layout.slot_count; ++index) {
+        new (&segment.slot(index)) SlotHeader{};
+        segment.free_slot(index);
+    }
+    header->state.store(kRunning, std::memory_order_release);
+    return TokenizerDaemon(std::move(state));
+#else
+    (void)name;
+    (void)options;
+    return std::unexpected(TokenizerServiceError::Unsupported);
+#endif
+}
+
+void TokenizerDaemon::run() {
+#ifdef DB25_TOKENIZER_SERVICE
+    Segment segment(state_->base);
+    SegmentHeader& header = segment.header();
+    auto next_reclaim = std::chrono::steady_clock::now() + kReclaimInterval;
+
+    for (;;) {
+        std::optional<uint64_t> slot = segment.pop_submitted();
+        if (!slot) {
+            if (header.state.load(std::memory_order_acquire) != kRunning) {
+                break;
+            }
+            // Clients wake the daemon only while daemon_waiting is set
+            header.daemon_waiting.store(1, std::memory_order_seq_cst);
+            uint32_t seen = header.doorbell.load(std::memory_order_seq_cst);
+            slot = segment.pop_submitted();
+            if (!slot) {
+                wait_on(header.doorbell, seen, kReclaimInterval);
+            }
+            header.daemon_waiting.store(0, std::memory_order_relaxed);
+        }
+        if (slot) {
+            state_->serve(*slot);
+        }
+        if (auto now = std::chrono::steady_clock::now(); now >= next_reclaim) {
+            state_->reclaim();
+            next_reclaim = now + kReclaimInterval;
+        }
+    }
+    state_->unlink_name();
+    header.state.store(kStopped, std::memory_order_release);
+#endif
+}
+
+void TokenizerDaemon::stop() noexcept {
+#ifdef DB25_TOKENIZER_SERVICE
+    if (!state_ || state_->base == nullptr) {
+        return;
+    }
+    SegmentHeader& header = Segment(state_->base).header();
+    uint32_t running = kRunning;
+    header.state.compare_exchange_strong(running, kStopping, std::memory_order_acq_rel);
+    header.doorbell.fetch_add(1, std::memory_order_seq_cst);
+    wake(header.doorbell, 1);
+#endif
+}
+
+namespace {
+
+TokenizerServiceStats read_stats([[maybe_unused]] std::byte* base) noexcept {
+    TokenizerServiceStats stats;
+#ifdef DB25_TOKENIZER_SERVICE
+    if (base != nullptr) {
+        const SegmentHeader& header = Segment(base).header();
+        stats.requests = header.requests.load(std::memory_order_relaxed);
+        stats.cache_hits = header.cache_hits.load(std::memory_order_relaxed);
+        stats.errors = header.errors.load(std::memory_order_relaxed);
+        stats.reclaimed = header.reclaimed.load(std::memory_order_relaxed);
+    }
+#endif
+    return stats;
+}
+
+}  // namespace
+
+TokenizerServiceStats TokenizerDaemon::stats() const noexcept {
+    return read_stats(state_ ? state_->base : nullptr);
+}
+
+const std::string& TokenizerDaemon::name() const noexcept {
+    return state_->name;
+}
+
+TokenizedQuery::~TokenizedQuery() {
+    release();
+}
+
+TokenizedQuery::TokenizedQuery(TokenizedQuery&& other) noexcept
+    : segment_(std::exchange(other.segment_, nullptr)),
+      slot_(other.slot_),
+      sql_(std::exchange(other.sql_, {})),
+      stream_(std::exchange(other.stream_, {})),
+      cached_(other.cached_) {}
+
+TokenizedQuery& TokenizedQuery::operator=(TokenizedQuery&& other) noexcept {
+    if (this != &other) {
+        release();
+        segment_ = std::exchange(other.segment_, nullptr);
+        slot_ = other.slot_;
+        sql_ = std::exchange(other.sql_, {});
+        stream_ = std::exchange(other.stream_, {});
+        cached_ = other.cached_;
+    }
+    return *this;
+}
+
+void TokenizedQuery::release() noexcept {
+#ifdef DB25_TOKENIZER_SERVICE
+    if (segment_ != nullptr) {
+        Segment(segment_).free_slot(slot_);
+        segment_ = nullptr;
+        sql_ = {};
+        stream_ = {};
+    }
+#endif
+}
+
+TokenizerClient::TokenizerClient(TokenizerClient&& other) noexcept
+    : segment_(std::exchange(other.segment_, nullptr)), size_(std::exchange(other.size_, 0)),
+      options_(other.options_) {}
+
+TokenizerClient& TokenizerClient::operator=(TokenizerClient&& other) noexcept {
+    if (this != &other) {
+        release();
+        segment_ = std::exchange(other.segment_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+        options_ = other.options_;
+    }
+    return *this;
+}
+
+TokenizerClient::~TokenizerClient() {
+    release();
+}
+
+void TokenizerClient::release() noexcept {
+#ifdef DB25_TOKENIZER_SERVICE
+    if (segment_ != nullptr) {
+        ::munmap(segment_, size_);
+        segment_ = nullptr;
+        size_ = 0;
+    }
+#endif
+}
+
+std::expected<TokenizerClient, TokenizerServiceError> TokenizerClient::connect(std::string_view name,
+                                                                               TokenizerClientOptions options) {
+#ifdef DB25_TOKENIZER_SERVICE
+    std::string path = object_name(name);
+    int fd = ::shm_open(path.c_str(), O_RDWR | O_CLOEXEC, 0);
+    if (fd < 0) {
+        return std::unexpected(errno == ENOENT ? TokenizerServiceError::NotRunning : TokenizerServiceError::Io);
+    }
+    struct stat status;
+    if (::fstat(fd, &status) != 0) {
+        ::close(fd);
+        return std::unexpected(TokenizerServiceError::Io);
+    }
+    auto size = static_cast<size_t>(status.st_size);
+    if (size < sizeof(SegmentHeader)) {
+        ::close(fd);
+        return std::unexpected(TokenizerServiceError::NotRunning);   // Still being created
+    }
+    void* data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        return std::unexpected(TokenizerServiceError::Io);
+    }
+
+    TokenizerClient client;
+    client.segment_ = static_cast<std::byte*>(data);
+    client.size_ = size;
+    client.options_ = options;
+
+    const SegmentHeader& header = Segment(client.segment_).header();
+    uint32_t state = header.state.load(std::memory_order_acquire);
+    if (state == kStarting) {
+        return std::unexpected(TokenizerServiceError::NotRunning);
+    }
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kLayoutVersion ||
+        header.segment_size != size || header.keyword_table != kKeywordTableVersion ||
+        header.operator_table != kOperatorTableVersion) {
+        return std::unexpected(TokenizerServiceError::VersionMismatch);
+    }
+    if (state != kRunning || !process_alive(header.daemon_pid)) {
+        return std::unexpected(TokenizerServiceError::NotRunning);
+    }
+    return client;
+#else
+    (void)name;
+    (void)options;
+    return std::unexpected(TokenizerServiceError::Unsupported);
+#endif
+}
+
+std::expected<TokenizedQuery, TokenizerServiceError> TokenizerClient::tokenize(std::string_view sql) const {
+#ifdef DB25_TOKENIZER_SERVICE
+    Segment segment(segment_);
+    SegmentHeader& header = segment.header();
+    auto running = [&] {
+        return header.state.load(std::memory_order_acquire) == kRunning && process_alive(header.daemon_pid);
+    };
+    if (!running()) {
+        return std::unexpected(TokenizerServiceError::NotRunning);
+    }
+    if (sql.size() > header.request_bytes) {
+        return std::unexpected(TokenizerServiceError::RequestTooLarge);
+    }
+    auto deadline = std::chrono::steady_clock::now() + options_.timeout;
+
+    // A free slot, waiting for one if every slot is in use
+    std::optional<uint64_t> index = segment.pop_free();
+    while (!index) {
+        auto now = std::chrono::steady_clock::now();
+        if (now >= deadline) {
+            return std::unexpected(TokenizerServiceError::Timeout);
+        }
+        if (!running()) {
+            return std::unexpected(TokenizerServiceError::NotRunning);
+        }
+        header.free_waiters.fetch_add(1, std::memory_order_seq_cst);
+        uint32_t seen = header.free_doorbell.load(std::memory_order_seq_cst);
+        index = segment.pop_free();
+        if (!index) {
+            wait_on(header.free_doorbell, seen, std::min<std::chrono::nanoseconds>(deadline - now, kPollInterval));
+        }
+        header.free_waiters.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    SlotHeader& slot = segment.slot(*index);
+    slot.owner.store(::getpid(), std::memory_order_relaxed);
+    slot.state.store(kWriting, std::memory_order_release);
+    std::memcpy(segment.request(*index), sql.data(), sql.size());
+    slot.request_size = sql.size();
+    slot.state.store(kSubmitted, std::memory_order_release);
+    segment.push_submitted(*index);   // Never full: it has room for every slot
+    header.doorbell.fetch_add(1, std::memory_order_seq_cst);
+    if (header.daemon_waiting.load(std::memory_order_seq_cst) != 0) {
+        wake(header.doorbell, 1);
+    }
+
+    // The reply: a few yields for short texts, then sleep on the slot state
+    for (int spin = 0; spin < kReplySpins && slot.state.load(std::memory_order_acquire) != kDone; ++spin) {
+        std::this_thread::yield();
+    }
+    for (;;) {
+        uint32_t state = slot.state.load(std::memory_order_acquire);
+        if (state == kDone) {
+            break;
+        }
+        if (state == kSubmitted &&
+            !slot.state.compare_exchange_strong(state, kSubmittedWaiting, std::memory_order_acq_rel)) {
+            continue;
+        }
+        auto now = std::chrono::steady_clock::now();
+        bool alive = header.state.load(std::memory_order_acquire) != kStopped && process_alive(header.daemon_pid);
+        if (now >= deadline || !alive) {
+            // Leave the slot to the daemon, which frees it after answering
+            uint32_t waiting = kSubmittedWaiting;
+            if (slot.state.compare_exchange_strong(waiting, kAbandoned, std::memory_order_acq_rel)) {
+                return std::unexpected(alive ? TokenizerServiceError::Timeout : TokenizerServiceError::NotRunning);
+            }
+            continue;
+        }
+        wait_on(slot.state, kSubmittedWaiting, std::min<std::chrono::nanoseconds>(deadline - now, kPollInterval));
+    }
+
+    if (slot.status != kOk) {
+        segment.free_slot(*index);
+        return std::unexpected(TokenizerServiceError::ResponseTooLarge);
+    }
+    TokenizedQuery query;
+    query.segment_ = segment_;
+    query.slot_ = *index;
+    query.sql_ = {segment.request(*index), slot.request_size};
+    const std::byte* response = segment.response(*index);
+    query.stream_ = TokenStreamView(
+        {reinterpret_cast<const TokenStreamBlock*>(response), slot.block_count},
+        {reinterpret_cast<const uint8_t*>(response + slot.block_count * sizeof(TokenStreamBlock)), slot.bytes_size},
+        slot.token_count, slot.request_size);
+    query.cached_ = slot.cached != 0;
+    return query;
+#else
+    (void)sql;
+    return std::unexpected(TokenizerServiceError::Unsupported);
+#endif
+}
+
+TokenizerServiceStats TokenizerClient::stats() const noexcept {
+    return read_stats(segment_);
+}
+
+size_t TokenizerClient::max_request_bytes() const noexcept {
+#ifdef DB25_TOKENIZER_SERVICE
+    return segment_ != nullptr ? Segment(segment_).header().request_bytes : 0;
+#else
+    return 0;
+#endif
+}
+
+}  // namespace db25
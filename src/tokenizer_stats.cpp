@@ -0,0 +1,213 @@
+/*
+ * Copyright (c) 2024 Chiradip Mandal
+ * Author: Chiradip Mandal
+ * Organization: Space-RF.org
+ *
+ * This file is part of DB25 SQL Tokenizer.
+ *
+ * Licensed under the MIT License. See LICENSE file for details.
+ */
+
+#include "tokenizer_stats.hpp"
+#include "simd_tokenizer.hpp"
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+namespace db25 {
+
+namespace {
+
+constexpr std::string_view kTokenTypeNames[kTokenTypeCount] = {
+    "unknown", "keyword", "identifier", "number", "string",
+    "operator", "delimiter", "whitespace", "comment", "eof"
+};
+
+constexpr std::string_view kPhaseNames[kStatsPhaseCount] = {
+    "tokenize", "whitespace", "identifier", "keyword_lookup",
+    "number", "string", "comment", "operator"
+};
+
+// Blocks of live threads plus the totals of threads that have exited.
+// Intentionally leaked so thread_local destructors running during process
+// exit can still retire into it.
+struct Registry {
+    std::mutex mutex;
+    std::vector<StatsBlock*> blocks;
+    StatsSnapshot retired;
+};
+
+Registry& registry() {
+    static Registry* instance = new Registry;
+    return *instance;
+}
+
+// Owns the calling thread's block for the lifetime of the thread
+struct ThreadBlock {
+    StatsBlock block;
+
+    ThreadBlock() {
+        Registry& r = registry();
+        std::lock_guard lock(r.mutex);
+        r.blocks.push_back(&block);
+    }
+
+    ~ThreadBlock() {
+        Registry& r = registry();
+        std::lock_guard lock(r.mutex);
+        r.retired.merge(block.load());
+        r.blocks.erase(std::remove(r.blocks.begin(), r.blocks.end(), &block), r.blocks.end());
+    }
+};
+
+uint64_t* slots(StatsSnapshot& snapshot) {
+    return reinterpret_cast<uint64_t*>(&snapshot);
+}
+
+const uint64_t* slots(const StatsSnapshot& snapshot) {
+    return reinterpret_cast<const uint64_t*>(&snapshot);
+}
+
+constexpr size_t kSnapshotSlots = sizeof(StatsSnapshot) / sizeof(uint64_t);
+
+}  // namespace
+
+std::string_view stats_phase_name(StatsPhase phase) noexcept {
+    size_t index = static_cast<size_t>(phase);
+    return index < kStatsPhaseCount ? kPhaseNames[index] : "invalid";
+}
+
+StatsSnapshot& StatsSnapshot::merge(const StatsSnapshot& other) noexcept {
+    uint64_t* mine = slots(*this);
+    const uint64_t* theirs = slots(other);
+    for (size_t i = 0; i < kSnapshotSlots; ++i) {
+        mine[i] += theirs[i];
+    }
+    return *this;
+}
+
+uint64_t StatsSnapshot::total_tokens() const noexcept {
+    uint64_t total = 0;
+    for (uint64_t count : tokens) {
+        total += count;
+    }
+    return total;
+}
+
+double StatsSnapshot::keyword_hit_rate() const noexcept {
+    return keyword_lookups == 0 ? 0.0
+                                : static_cast<double>(keyword_hits) / static_cast<double>(keyword_lookups);
+}
+
+double StatsSnapshot::phase_seconds(StatsPhase phase) const noexcept {
+    return CycleClock::to_seconds(phase_ticks[static_cast<size_t>(phase)]);
+}
+
+std::string StatsSnapshot::to_prometheus(std::string_view prefix) const {
+    std::ostringstream out;
+    auto header = [&](std::string_view name, std::string_view help) {
+        out << "# HELP " << prefix << "_" << name << " " << help << "\n"
+            << "# TYPE " << prefix << "_" << name << " counter\n";
+    };
+
+    header("calls_total", "tokenize() calls.");
+    out << prefix << "_calls_total " << calls << "\n";
+
+    header("input_bytes_total", "Bytes passed to tokenize().");
+    out << prefix << "_input_bytes_total " << input_bytes << "\n";
+
+    header("tokens_total", "Tokens produced, by token type.");
+    for (size_t i = 0; i < kTokenTypeCount; ++i) {
+        if (tokens[i] > 0) {
+            out << prefix << "_tokens_total{type=\"" << kTokenTypeNames[i] << "\"} " << tokens[i] << "\n";
+        }
+    }
+
+    header("bytes_total", "Input bytes covered, by token type (whitespace: skipped bytes).");
+    for (size_t i = 0; i < kTokenTypeCount; ++i) {
+        if (bytes[i] > 0) {
+            out << prefix << "_bytes_total{type=\"" << kTokenTypeNames[i] << "\"} " << bytes[i] << "\n";
+        }
+    }
+
+    header("keyword_lookups_total", "Identifier-like words looked up in the keyword table.");
+    out << prefix << "_keyword_lookups_total " << keyword_lookups << "\n";
+
+    header("keyword_hits_total", "Keyword lookups that found a keyword.");
+    out << prefix << "_keyword_hits_total " << keyword_hits << "\n";
+
+    bool timed = std::any_of(phase_calls.begin(), phase_calls.end(), [](uint64_t n) { return n > 0; });
+    if (timed) {
+        header("phase_seconds_total", "Time spent per tokenizer phase (phases nest).");
+        for (size_t i = 0; i < kStatsPhaseCount; ++i) {
+            out << prefix << "_phase_seconds_total{phase=\"" << kPhaseNames[i] << "\"} "
+                << phase_seconds(static_cast<StatsPhase>(i)) << "\n";
+        }
+
+        header("phase_calls_total", "Entries into each tokenizer phase.");
+        for (size_t i = 0; i < kStatsPhaseCount; ++i) {
+            out << prefix << "_phase_calls_total{phase=\"" << kPhaseNames[i] << "\"} "
+                << phase_calls[i] << "\n";
+        }
+    }
+
+    return out.str();
+}
+
+void StatsBlock::add(const StatsSnapshot& delta) noexcept {
+    const uint64_t* values = slots(delta);
+    for (size_t i = 0; i < kSlots; ++i) {
+        if (values[i] != 0) {
+            // Single writer: a load/store pair needs no locked instruction
+            slots_[i].store(slots_[i].load(std::memory_order_relaxed) + values[i],
+                            std::memory_order_relaxed);
+        }
+    }
+}
+
+StatsSnapshot StatsBlock::load() const noexcept {
+    StatsSnapshot snapshot;
+    uint64_t* values = slots(snapshot);
+    for (size_t i = 0; i < kSlots; ++i) {
+        values[i] = slots_[i].load(std::memory_order_relaxed);
+    }
+    return snapshot;
+}
+
+void StatsBlock::clear() noexcept {
+    for (auto& slot : slots_) {
+        slot.store(0, std::memory_order_relaxed);
+    }
+}
+
+StatsBlock& StatsRegistry::local() {
+    thread_local ThreadBlock thread_block;
+    return thread_block.block;
+}
+
+StatsSnapshot StatsRegistry::snapshot() {
+    Registry& r = registry();
+    std::lock_guard lock(r.mutex);
+    StatsSnapshot total = r.retired;
+    for (const StatsBlock* block : r.blocks) {
+        total.merge(block->load());
+    }
+    return total;
+}
+
+StatsSnapshot StatsRegistry::thread_snapshot() {
+    return local().load();
+}
+
+void StatsRegistry::reset() {
+    Registry& r = registry();
+    std::lock_guard lock(r.mutex);
+    r.retired = {};
+    for (StatsBlock* block : r.blocks) {
+        block->clear();
+    }
+}
+
+}  // namespace db25
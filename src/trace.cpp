@@ -0,0 +1,201 @@
+/*
+ * Copyright (c) 2024 Chiradip Mandal
+ * Author: Chiradip Mandal
+ * Organization: Space-RF.org
+ *
+ * This file is part of DB25 SQL Tokenizer.
+ *
+ * Licensed under the MIT License. See LICENSE file for details.
+ */
+
+#include "trace.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <vector>
+
+namespace db25 {
+
+namespace {
+
+// Rings of every thread that has traced. Intentionally leaked so
+// thread_local destructors running during process exit can still use it.
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::shared_ptr<TraceRing>> rings;
+    size_t capacity = TraceRing::kDefaultCapacity;
+    uint32_t next_thread_id = 1;
+};
+
+Registry& registry() {
+    static Registry* instance = new Registry;
+    return *instance;
+}
+
+void append_escaped(std::string& out, std::string_view text) {
+    for (char c : text) {
+        switch (c) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buffer[8];
+                    std::snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+                    out += buffer;
+                } else {
+                    out += c;
+                }
+        }
+    }
+}
+
+void append_microseconds(std::string& out, double us) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.3f", us);
+    out += buffer;
+}
+
+}  // namespace
+
+TraceRing::TraceRing(uint32_t thread_id, size_t capacity)
+    : events_(std::make_unique<Event[]>(std::bit_ceil(std::max<size_t>(capacity, 2)))),
+      mask_(std::bit_ceil(std::max<size_t>(capacity, 2)) - 1),
+      thread_id_(thread_id),
+      thread_name_("thread " + std::to_string(thread_id)) {}
+
+size_t TraceRing::copy(Copy* out) const noexcept {
+    uint64_t head = head_.load(std::memory_order_acquire);
+    uint64_t first = head > capacity() ? head - capacity() : 0;
+    for (uint64_t i = first; i < head; ++i) {
+        const Event& event = events_[i & mask_];
+        out[i - first] = {event.name.load(std::memory_order_relaxed),
+                          event.begin.load(std::memory_order_relaxed),
+                          event.end.load(std::memory_order_relaxed),
+                          event.arg.load(std::memory_order_relaxed)};
+    }
+
+    // The owner may have started overwriting the oldest slots while they
+    // were copied (seqlock-style: the fence pairs with the one in record()).
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint64_t begun = begun_.load(std::memory_order_relaxed);
+    uint64_t intact = begun > capacity() ? begun - capacity() : 0;
+    if (intact > first) {
+        uint64_t dropped = std::min(intact, head) - first;
+        std::copy(out + dropped, out + (head - first), out);
+        return static_cast<size_t>(head - first - dropped);
+    }
+    return static_cast<size_t>(head - first);
+}
+
+TraceRing& Tracer::local() {
+    // Registers on first use; the registry keeps the ring after exit
+    thread_local std::shared_ptr<TraceRing> ring = [] {
+        Registry& r = registry();
+        std::lock_guard lock(r.mutex);
+        auto created = std::make_shared<TraceRing>(r.next_thread_id++, r.capacity);
+        r.rings.push_back(created);
+        return created;
+    }();
+    return *ring;
+}
+
+void Tracer::set_thread_name(std::string name) {
+    TraceRing& ring = local();
+    Registry& r = registry();
+    std::lock_guard lock(r.mutex);
+    ring.set_thread_name(std::move(name));
+}
+
+void Tracer::set_ring_capacity(size_t events) {
+    Registry& r = registry();
+    std::lock_guard lock(r.mutex);
+    r.capacity = std::max<size_t>(events, 2);
+}
+
+std::string Tracer::chrome_json() {
+    struct Thread {
+        std::shared_ptr<TraceRing> ring;
+        std::string name;
+        std::vector<TraceRing::Copy> events;
+    };
+    std::vector<Thread> threads;
+    {
+        Registry& r = registry();
+        std::lock_guard lock(r.mutex);
+        for (const auto& ring : r.rings) {
+            threads.push_back({ring, ring->thread_name(), {}});
+        }
+    }
+
+    uint64_t origin = std::numeric_limits<uint64_t>::max();
+    for (auto& thread : threads) {
+        thread.events.resize(thread.ring->capacity());
+        thread.events.resize(thread.ring->copy(thread.events.data()));
+        for (const auto& event : thread.events) {
+            origin = std::min(origin, event.begin);
+        }
+    }
+
+    // Timestamps in microseconds since the earliest event
+    const double us_per_tick = 1e6 / static_cast<double>(CycleClock::frequency());
+    std::string out = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first = true;
+    auto separator = [&] {
+        if (!first) {
+            out += ",";
+        }
+        first = false;
+        out += "\n";
+    };
+
+    for (const auto& thread : threads) {
+        std::string tid = std::to_string(thread.ring->thread_id());
+        separator();
+        out += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + tid + ",\"args\":{\"name\":\"";
+        append_escaped(out, thread.name);
+        out += "\"}}";
+
+        for (const auto& event : thread.events) {
+            separator();
+            out += "{\"name\":\"";
+            append_escaped(out, event.name ? event.name : "?");
+            out += "\",\"cat\":\"db25\",\"ph\":\"X\",\"ts\":";
+            append_microseconds(out, static_cast<double>(event.begin - origin) * us_per_tick);
+            out += ",\"dur\":";
+            append_microseconds(out, static_cast<double>(event.end - event.begin) * us_per_tick);
+            out += ",\"pid\":1,\"tid\":" + tid;
+            if (event.arg != 0) {
+                out += ",\"args\":{\"bytes\":" + std::to_string(event.arg) + "}";
+            }
+            out += "}";
+        }
+    }
+    out += "\n]}\n";
+    return out;
+}
+
+bool Tracer::write_chrome_json(const std::string& path) {
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    file << chrome_json();
+    return static_cast<bool>(file);
+}
+
+void Tracer::clear() {
+    Registry& r = registry();
+    std::lock_guard lock(r.mutex);
+    // A ring only the registry holds belongs to a thread that has exited
+    std::erase_if(r.rings, [](const auto& ring) { return ring.use_count() == 1; });
+    for (const auto& ring : r.rings) {
+        ring->clear();
+    }
+}
+
+}  // namespace db25
@@ -0,0 +1,184 @@
+/*
+ * Dialect test for DB25 SQL Tokenizer
+ * Verifies that compile-time dialect policies enable only their own features
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <iomanip>
+#include "simd_tokenizer.hpp"
+
+using namespace db25;
+
+struct DialectTestCase {
+    std::string sql;
+    std::vector<std::string> expected_tokens;
+    std::string description;
+};
+
+template<typename Tokenizer>
+bool test_dialect(const DialectTestCase& test, std::string_view dialect) {
+    Tokenizer tokenizer(
+        reinterpret_cast<const std::byte*>(test.sql.data()),
+        test.sql.size()
+    );
+
+    auto tokens = tokenizer.tokenize();
+
+    std::vector<std::string> actual_tokens;
+    for (const auto& token : tokens) {
+        actual_tokens.push_back(std::string(token.value));
+    }
+
+    if (actual_tokens != test.expected_tokens) {
+        std::cout << "✗ FAIL: [" << dialect << "] " << test.description << "\n";
+        std::cout << "  SQL: \"" << test.sql << "\"\n";
+        std::cout << "  Expected: ";
+        for (const auto& t : test.expected_tokens) std::cout << "[" << t << "] ";
+        std::cout << "\n  Got:      ";
+        for (const auto& t : actual_tokens) std::cout << "[" << t << "] ";
+        std::cout << "\n";
+        return false;
+    }
+
+    std::cout << "✓ PASS: [" << dialect << "] " << test.description << "\n";
+    return true;
+}
+
+template<typename Tokenizer>
+bool test_quoted_identifier(const std::string& sql, const std::string& expected_text,
+                            const std::string& description, std::string_view dialect) {
+    Tokenizer tokenizer(reinterpret_cast<const std::byte*>(sql.data()), sql.size());
+    auto tokens = tokenizer.tokenize();
+    StringArena arena;
+
+    if (tokens.size() != 1 || tokens[0].type != TokenType::Identifier ||
+        !(tokens[0].flags & TOKEN_FLAG_QUOTED) || tokens[0].unescaped(arena) != expected_text) {
+        std::cout << "✗ FAIL: [" << dialect << "] " << description << "\n";
+        return false;
+    }
+
+    std::cout << "✓ PASS: [" << dialect << "] " << description << "\n";
+    return true;
+}
+
+// Dollar-quoted body: one String token, tags stripped by unescaped(), and
+// line tracking resumes correctly after the body
+bool test_dollar_quoted(const std::string& sql, const std::string& expected_body, uint8_t expected_flags,
+                        size_t next_line, size_t next_column, const std::string& description) {
+    PostgresTokenizer tokenizer(reinterpret_cast<const std::byte*>(sql.data()), sql.size());
+    auto tokens = tokenizer.tokenize();
+    StringArena arena;
+
+    bool ok = !tokens.empty() && tokens[0].type == TokenType::String &&
+              tokens[0].flags == expected_flags && tokens[0].unescaped(arena) == expected_body;
+    if (ok && next_line != 0) {
+        ok = tokens.size() == 2 && tokens[1].line == next_line && tokens[1].column == next_column;
+    }
+
+    if (!ok) {
+        std::cout << "✗ FAIL: [" << PostgresDialect::name << "] " << description << "\n";
+        return false;
+    }
+
+    std::cout << "✓ PASS: [" << PostgresDialect::name << "] " << description << "\n";
+    return true;
+}
+
+int main() {
+    std::cout << "DB25 Tokenizer - Dialect Test\n";
+    std::cout << "=============================\n\n";
+
+    int passed = 0;
+    int failed = 0;
+    auto record = [&](bool ok) { ok ? passed++ : failed++; };
+
+    // Generic dialect keeps the original lexical rules
+    std::vector<DialectTestCase> generic_cases = {
+        {"`a`", {"`", "a", "`"}, "Backtick is not a quote"},
+        {"# x", {"#", "x"}, "Hash is not a comment"},
+        {"a[1]", {"a", "[", "1", "]"}, "Brackets are delimiters"},
+        {"a == b", {"a", "==", "b"}, "Double equals"},
+        {"$$x$$", {"$", "$", "x", "$", "$"}, "No dollar quoting"},
+    };
+    for (const auto& test : generic_cases) {
+        record(test_dialect<SimdTokenizer>(test, GenericDialect::name));
+    }
+
+    std::vector<DialectTestCase> mysql_cases = {
+        {"SELECT `my col` FROM t", {"SELECT", "`my col`", "FROM", "t"}, "Backtick identifier"},
+        {"# comment\nSELECT 1", {"# comment\n", "SELECT", "1"}, "Hash comment"},
+        {"SET @x := 1", {"SET", "@", "x", ":=", "1"}, "Assignment operator"},
+        {"a == b", {"a", "=", "=", "b"}, "No double-equals operator"},
+    };
+    for (const auto& test : mysql_cases) {
+        record(test_dialect<MySqlTokenizer>(test, MySqlDialect::name));
+    }
+    record(test_quoted_identifier<MySqlTokenizer>("`a``b`", "a`b", "Escaped backtick", MySqlDialect::name));
+
+    std::vector<DialectTestCase> sqlserver_cases = {
+        {"SELECT [order id] FROM [dbo].[t]",
+         {"SELECT", "[order id]", "FROM", "[dbo]", ".", "[t]"}, "Bracket identifiers"},
+        {"a !< b", {"a", "!<", "b"}, "Not-less-than operator"},
+        {"x += 1", {"x", "+=", "1"}, "Compound assignment"},
+        {"`a`", {"`", "a", "`"}, "Backtick is not a quote"},
+    };
+    for (const auto& test : sqlserver_cases) {
+        record(test_dialect<SqlServerTokenizer>(test, SqlServerDialect::name));
+    }
+    record(test_quoted_identifier<SqlServerTokenizer>("[a]]b]", "a]b", "Escaped closing bracket",
+                                                      SqlServerDialect::name));
+
+    std::vector<DialectTestCase> postgres_cases = {
+        {"data->'k'", {"data", "->", "'k'"}, "JSON arrow"},
+        {"tags @> ARRAY", {"tags", "@>", "ARRAY"}, "Contains operator"},
+        {"a::int", {"a", "::", "int"}, "Cast"},
+        {"arr[1]", {"arr", "[", "1", "]"}, "Array subscript"},
+        {"AS $$ SELECT 1; $$ LANGUAGE sql", {"AS", "$$ SELECT 1; $$", "LANGUAGE", "sql"},
+         "Dollar-quoted function body"},
+        {"$fn$ a $$ b $fn$", {"$fn$ a $$ b $fn$"}, "Other tags inside body"},
+        {"$1 + $2", {"$", "1", "+", "$", "2"}, "Positional parameters are not tags"},
+        {"$a b $", {"$", "a", "b", "$"}, "Space ends tag"},
+        {"SELECT a$b$c FROM t", {"SELECT", "a$b$c", "FROM", "t"}, "Dollar inside identifier is not a tag"},
+        {"x$$y$$", {"x$$y$$"}, "Identifier ending in dollars"},
+        {"f($1, b$)", {"f", "(", "$", "1", ",", "b$", ")"}, "Parameter and trailing dollar"},
+    };
+    for (const auto& test : postgres_cases) {
+        record(test_dialect<PostgresTokenizer>(test, PostgresDialect::name));
+    }
+
+    const uint8_t DOLLAR = TOKEN_FLAG_QUOTED | TOKEN_FLAG_DOLLAR_QUOTED;
+    record(test_dollar_quoted("$$it's$$", "it's", DOLLAR, 0, 0, "Quotes need no escaping"));
+    record(test_dollar_quoted("$$$$", "", DOLLAR, 0, 0, "Empty body"));
+    record(test_dollar_quoted("$body$\nBEGIN\n  x := 1;\nEND$body$ ;", "\nBEGIN\n  x := 1;\nEND",
+                              DOLLAR, 4, 11, "Multi-line body keeps positions"));
+    record(test_dollar_quoted("$f$ open", " open", DOLLAR | TOKEN_FLAG_UNTERMINATED, 0, 0,
+                              "Unterminated body"));
+
+    // Large body with many near-miss '$' bytes across vector boundaries
+    std::string body;
+    for (int i = 0; i < 20000; ++i) {
+        body += (i % 7 == 0) ? "$bod$ x\n" : "SELECT $1;\n";
+    }
+    record(test_dollar_quoted("$body$" + body + "$body$ ;", body, DOLLAR, 20001, 8,
+                              "Large body with near-miss tags"));
+
+    int total = passed + failed;
+    std::cout << "\n" << std::string(50, '=') << "\n";
+    std::cout << "Test Summary\n";
+    std::cout << std::string(50, '=') << "\n";
+    std::cout << "Total Tests: " << total << "\n";
+    std::cout << "Passed:      " << passed << "\n";
+    std::cout << "Failed:      " << failed << "\n";
+    std::cout << "Success Rate: " << std::fixed << std::setprecision(1)
+              << (passed * 100.0 / total) << "%\n";
+
+    if (failed > 0) {
+        std::cout << "\n⚠️  Some tests failed! Please review the failures above.\n";
+        return 1;
+    } else {
+        std::cout << "\n✅ All dialect tests passed.\n";
+        return 0;
+    }
+}
@@ -0,0 +1,108 @@
+/*
+ * Exact-size tokenization test for DB25 SQL Tokenizer
+ * Verifies count_tokens(), tokenize_exact() and tokenize_into() against
+ * tokenize() for every dialect and SIMD level
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "simd_tokenizer.hpp"
+#include "test_support.hpp"
+
+using namespace db25;
+
+// Every exact-size entry point agrees with tokenize() on `sql`
+template<typename Tokenizer>
+bool exact_modes_agree(const std::string& sql, SimdLevel level, const std::string& description) {
+    Tokenizer tokenizer(reinterpret_cast<const std::byte*>(sql.data()), sql.size(), level);
+    std::vector<Token> expected = tokenizer.tokenize();
+
+    size_t count = tokenizer.count_tokens();
+    std::vector<Token> exact = tokenizer.tokenize_exact();
+    std::vector<Token> into(expected.size() + 1);
+    size_t written = tokenizer.tokenize_into(into);
+
+    bool ok = count == expected.size() &&
+              same_tokens(expected, exact) &&
+              exact.capacity() == exact.size() &&
+              written == expected.size() &&
+              same_tokens(expected, std::span(into).first(written));
+
+    std::string label = std::string("[") + CpuDetection::level_name(level) + "] " + description;
+    return check(ok, label);
+}
+
+int main() {
+    std::cout << "DB25 Tokenizer - Exact-Size Tokenization Test\n";
+    std::cout << "=============================================\n\n";
+
+    TestResults results;
+
+    // Operator-dense input outgrows the input_size / 8 reservation;
+    // literal-heavy input is a few tokens for many bytes
+    std::string dense;
+    std::string literals;
+    for (int i = 0; i < 500; ++i) {
+        dense += "a+b*c-d/";
+        literals += "'" + std::string(200, 'x') + "', ";
+    }
+    dense += "e";
+    literals += "'unterminated";
+
+    std::string corpus = read_file("test/sql_test.sqls");
+    results.record(check(!corpus.empty(), "Corpus loaded"));
+
+    const std::string mysql = "SELECT `a b`, 'it\\'s' # comment\nFROM t WHERE x <=> y";
+    const std::string postgres = "SELECT $fn$ body; 'x' $fn$, E'a\\'b', data->>'k' FROM t";
+
+    for (SimdLevel level : CpuDetection::supported_levels()) {
+        results.record(exact_modes_agree<SimdTokenizer>(corpus, level, "sql_test.sqls corpus"));
+        results.record(exact_modes_agree<SimdTokenizer>(dense, level, "Operator-dense input"));
+        results.record(exact_modes_agree<SimdTokenizer>(literals, level, "Literal-heavy input"));
+        results.record(exact_modes_agree<MySqlTokenizer>(mysql, level, "MySQL quoting and comments"));
+        results.record(exact_modes_agree<PostgresTokenizer>(postgres, level, "PostgreSQL dollar quoting"));
+    }
+
+    // Edge cases
+    {
+        std::string empty;
+        SimdTokenizer tokenizer(reinterpret_cast<const std::byte*>(empty.data()), 0);
+        results.record(check(tokenizer.count_tokens() == 0 && tokenizer.tokenize_exact().empty() &&
+                             tokenizer.tokenize_into({}) == 0, "Empty input has no tokens"));
+
+        std::string blank = "  \n\t ";
+        SimdTokenizer spaces(reinterpret_cast<const std::byte*>(blank.data()), blank.size());
+        results.record(check(spaces.count_tokens() == 0 && spaces.tokenize().empty(),
+                             "Whitespace-only input has no tokens"));
+    }
+
+    {
+        std::string sql = "SELECT a, b FROM t WHERE c = 1";
+        SimdTokenizer tokenizer(reinterpret_cast<const std::byte*>(sql.data()), sql.size());
+        std::vector<Token> all = tokenizer.tokenize();
+
+        Token prefix[3];
+        size_t total = tokenizer.tokenize_into(prefix);
+        results.record(check(total == all.size() && same_tokens(std::span(all).first(3), prefix),
+                             "Truncated output keeps the first tokens and reports the total"));
+        results.record(check(tokenizer.tokenize_into({}) == all.size(), "Empty span counts without writing"));
+        results.record(check(tokenizer.tokenize().size() == all.size(), "Repeated calls start from the beginning"));
+        results.record(check(tokenizer.count_tokens() == all.size() && tokenizer.tokenize_exact()[0].keyword_id ==
+                             Keyword::SELECT, "Counting pass leaves keyword lookup on for the next call"));
+    }
+
+    // Statistics count the stored tokens once, not the counting pass
+    {
+        std::string sql = "SELECT name FROM users WHERE id = 42";
+        StatsRegistry::reset();
+        BasicSimdTokenizer<GenericDialect, CountStats> tokenizer(
+            reinterpret_cast<const std::byte*>(sql.data()), sql.size());
+        std::vector<Token> tokens = tokenizer.tokenize_exact();
+        StatsSnapshot stats = StatsRegistry::thread_snapshot();
+        results.record(check(stats.calls == 1 && stats.total_tokens() == tokens.size() &&
+                             stats.keyword_lookups == 6, "Statistics see one call and its tokens"));
+    }
+
+    return results.summary("All exact-size tests passed.");
+}
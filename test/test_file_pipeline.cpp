@@ -0,0 +1,190 @@
+/*
+ * File pipeline test for DB25 SQL Tokenizer
+ * Verifies that FilePipeline returns every file exactly once, tokenized as
+ * TokenBuffer::tokenize() would, with each I/O backend, through next() and
+ * co_await, and with the smallest buffer pool and result queue
+ */
+
+#include <chrono>
+#include <coroutine>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "file_pipeline.hpp"
+#include "test_support.hpp"
+
+using namespace db25;
+
+void write_file(const std::filesystem::path& path, const std::string& contents) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file << contents;
+}
+
+// A coroutine that starts eagerly and frees itself when it returns
+struct Detached {
+    struct promise_type {
+        Detached get_return_object() noexcept { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+    };
+};
+
+Detached consume(FilePipeline& pipeline, std::promise<std::vector<FileTokens>>& done) {
+    std::vector<FileTokens> files;
+    while (auto file = co_await pipeline.next_async()) {
+        files.push_back(std::move(*file));
+    }
+    done.set_value(std::move(files));
+}
+
+std::vector<FileTokens> drain(FilePipeline& pipeline) {
+    std::vector<FileTokens> files;
+    while (auto file = pipeline.next()) {
+        files.push_back(std::move(*file));
+    }
+    return files;
+}
+
+// Every file exactly once; readable files tokenized like `tokenize`, the
+// missing one reported as an error
+bool complete(const std::vector<FileTokens>& results, const std::vector<std::filesystem::path>& files,
+              const std::vector<std::string>& contents, TokenBuffer (*tokenize)(std::string_view)) {
+    if (results.size() != files.size()) {
+        return false;
+    }
+    std::vector<bool> seen(files.size(), false);
+    for (const FileTokens& result : results) {
+        if (result.index >= files.size() || seen[result.index] || result.path != files[result.index]) {
+            return false;
+        }
+        seen[result.index] = true;
+        if (result.index >= contents.size()) {
+            if (!result.error || !result.tokens.empty()) {
+                return false;
+            }
+        } else if (result.error || result.tokens.input() != contents[result.index] ||
+                   !equal_tokens(result.tokens.tokens(), tokenize(contents[result.index]).tokens())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main() {
+    std::cout << "DB25 Tokenizer - File Pipeline Test\n";
+    std::cout << "===================================\n\n";
+
+    TestResults results;
+
+    auto stamp = std::chrono::steady_clock::now().time_since_epoch().count();
+    std::filesystem::path directory =
+        std::filesystem::temp_directory_path() / ("db25_file_pipeline_test_" + std::to_string(stamp));
+    std::filesystem::create_directories(directory);
+
+    std::string corpus = read_file("test/sql_test.sqls");
+    results.record(check(!corpus.empty(), "Corpus loaded"));
+
+    // Statements of the corpus in files of varying size, an empty file, the
+    // whole corpus, and a path that does not exist (always last)
+    std::vector<std::string> contents;
+    for (size_t begin = 0, size = 1; begin < corpus.size(); begin += size, size = size * 3 + 17) {
+        contents.push_back(corpus.substr(begin, size));
+    }
+    contents.push_back("");
+    contents.push_back(corpus);
+    std::vector<std::filesystem::path> files;
+    for (size_t i = 0; i < contents.size(); ++i) {
+        files.push_back(directory / ("file" + std::to_string(i) + ".sql"));
+        write_file(files.back(), contents[i]);
+    }
+    files.push_back(directory / "missing.sql");
+    std::cout << "  " << files.size() << " files\n";
+
+    auto simd = static_cast<TokenBuffer (*)(std::string_view)>(&TokenBuffer::tokenize<SimdTokenizer>);
+
+    // Each backend
+    for (IoBackend backend : {IoBackend::Auto, IoBackend::IoUring, IoBackend::Threads}) {
+        FilePipelineOptions options;
+        options.backend = backend;
+        options.reads_in_flight = 4;
+        options.workers = 2;
+        FilePipeline pipeline(files, options);
+        std::cout << "  requested " << io_backend_name(backend) << ", using "
+                  << io_backend_name(pipeline.backend()) << "\n";
+        bool resolved = backend == IoBackend::Threads ? pipeline.backend() == IoBackend::Threads
+                                                      : pipeline.backend() != IoBackend::Auto;
+        std::vector<FileTokens> delivered = drain(pipeline);
+        results.record(check(resolved && complete(delivered, files, contents, simd) && !pipeline.next(),
+                             std::string("Every file tokenized (") + std::string(io_backend_name(backend)) + ")"));
+    }
+
+    // co_await, resumed on pipeline threads
+    {
+        FilePipeline pipeline(files);
+        std::promise<std::vector<FileTokens>> done;
+        std::future<std::vector<FileTokens>> delivered = done.get_future();
+        consume(pipeline, done);
+        results.record(check(complete(delivered.get(), files, contents, simd), "Every file delivered to a coroutine"));
+    }
+
+    // One buffer per stage, and a consumer slower than the workers
+    {
+        bool ok = true;
+        for (IoBackend backend : {IoBackend::IoUring, IoBackend::Threads}) {
+            FilePipelineOptions options;
+            options.backend = backend;
+            options.reads_in_flight = 1;
+            options.workers = 1;
+            options.max_results = 1;
+            FilePipeline pipeline(files, options);
+            std::vector<FileTokens> delivered;
+            while (auto file = pipeline.next()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                delivered.push_back(std::move(*file));
+            }
+            ok = ok && complete(delivered, files, contents, simd);
+        }
+        results.record(check(ok, "Smallest buffer pool and result queue"));
+    }
+
+    // Other dialects
+    {
+        FilePipelineOptions options;
+        options.tokenize = &TokenBuffer::tokenize<MySqlTokenizer>;
+        FilePipeline pipeline(files, options);
+        auto mysql = static_cast<TokenBuffer (*)(std::string_view)>(&TokenBuffer::tokenize<MySqlTokenizer>);
+        results.record(check(complete(drain(pipeline), files, contents, mysql), "MySQL tokenizer option"));
+    }
+
+    // Edge cases
+    {
+        FilePipeline empty(std::vector<std::filesystem::path>{});
+        results.record(check(empty.size() == 0 && !empty.next(), "Empty file list"));
+
+        // Destroyed with reads and results outstanding; must not hang
+        bool stopped = true;
+        for (IoBackend backend : {IoBackend::IoUring, IoBackend::Threads}) {
+            std::vector<std::filesystem::path> many;
+            for (int i = 0; i < 200; ++i) {
+                many.push_back(files[i % contents.size()]);
+            }
+            FilePipelineOptions options;
+            options.backend = backend;
+            options.max_results = 2;
+            FilePipeline pipeline(many, options);
+            auto first = pipeline.next();
+            stopped = stopped && first.has_value() && !first->error;
+        }
+        results.record(check(stopped, "Destroyed before every file is consumed"));
+    }
+
+    std::filesystem::remove_all(directory);
+
+    return results.summary("All file pipeline tests passed.");
+}
@@ -79,6 +79,32 @@ bool test_operator(const TestCase& test) {
     return true;
 }
 
+struct OperatorIdCase {
+    std::string sql;
+    Operator expected;
+    TokenType type;
+};
+
+// The operator ID must agree with the token text
+bool test_operator_id(const OperatorIdCase& test) {
+    SimdTokenizer tokenizer(
+        reinterpret_cast<const std::byte*>(test.sql.data()),
+        test.sql.size()
+    );
+
+    auto tokens = tokenizer.tokenize();
+
+    if (tokens.size() != 1 || tokens[0].operator_id != test.expected ||
+        tokens[0].type != test.type || operator_name(tokens[0].operator_id) != tokens[0].value) {
+        std::cout << "✗ FAIL: Operator ID for \"" << test.sql << "\"\n";
+        return false;
+    }
+
+    std::cout << "✓ PASS: Operator ID for \"" << test.sql << "\" ("
+              << token_type_to_string(test.type) << ")\n";
+    return true;
+}
+
 int main() {
     std::cout << "DB25 Tokenizer - Comprehensive Operator Test\n";
     std::cout << "============================================\n\n";
@@ -119,8 +145,16 @@ int main() {
         // Special operators
         {"a::text", {"a", "::", "text"}, "PostgreSQL cast"},
         {"a.b", {"a", ".", "b"}, "Dot notation"},
-        {"a->b", {"a", "-", ">", "b"}, "Arrow (tokenized as separate)"},
-        {"a->>b", {"a", "-", ">>", "b"}, "JSON arrow (tokenized as separate)"},
+        {"a->b", {"a", "->", "b"}, "JSON arrow"},
+        {"a->>b", {"a", "->>", "b"}, "JSON text arrow"},
+        {"a#>b", {"a", "#>", "b"}, "JSON path"},
+        {"a#>>b", {"a", "#>>", "b"}, "JSON text path"},
+        {"a<=>b", {"a", "<=>", "b"}, "Null-safe equals"},
+        {"a!~*b", {"a", "!~*", "b"}, "Case-insensitive regex non-match"},
+        {"a @> b <@ c", {"a", "@>", "b", "<@", "c"}, "Containment operators"},
+        {"||/ 27", {"||/", "27"}, "Cube root"},
+        {"a||/*c*/b", {"a", "||", "/*c*/", "b"}, "Operator stops before a block comment"},
+        {"a->>>b", {"a", "->>", ">", "b"}, "Longest match then remainder"},
         
         // Invalid operators that should be tokenized as separate tokens
         {"a === b", {"a", "==", "=", "b"}, "Triple equals (invalid, tokenized as ==, =)"},
@@ -140,6 +174,26 @@ int main() {
          "SELECT with !="},
     };
     
+    const TokenType OP = TokenType::Operator;
+    const TokenType DELIM = TokenType::Delimiter;
+    std::vector<OperatorIdCase> id_cases = {
+        {"+", Operator::PLUS, OP},
+        {"=", Operator::EQUAL, OP},
+        {"(", Operator::LEFT_PAREN, DELIM},
+        {";", Operator::SEMICOLON, DELIM},
+        {".", Operator::DOT, OP},
+        {"<=", Operator::LESS_EQUAL, OP},
+        {"<>", Operator::NOT_EQUAL, OP},
+        {"::", Operator::CAST, DELIM},
+        {"||", Operator::CONCAT, OP},
+        {"->", Operator::ARROW, OP},
+        {"->>", Operator::ARROW_TEXT, OP},
+        {"#>>", Operator::HASH_ARROW_TEXT, OP},
+        {"<=>", Operator::NULL_SAFE_EQUAL, OP},
+        {"!~*", Operator::REGEX_NOT_IMATCH, OP},
+        {"||/", Operator::CUBE_ROOT, OP},
+    };
+    
     int passed = 0;
     int failed = 0;
     
@@ -150,15 +204,23 @@ int main() {
             failed++;
         }
     }
+    for (const auto& test : id_cases) {
+        if (test_operator_id(test)) {
+            passed++;
+        } else {
+            failed++;
+        }
+    }
+    size_t total = test_cases.size() + id_cases.size();
     
     std::cout << "\n" << std::string(50, '=') << "\n";
     std::cout << "Test Summary\n";
     std::cout << std::string(50, '=') << "\n";
-    std::cout << "Total Tests: " << test_cases.size() << "\n";
+    std::cout << "Total Tests: " << total << "\n";
     std::cout << "Passed:      " << passed << "\n";
     std::cout << "Failed:      " << failed << "\n";
     std::cout << "Success Rate: " << std::fixed << std::setprecision(1) 
-              << (passed * 100.0 / test_cases.size()) << "%\n";
+              << (passed * 100.0 / total) << "%\n";
     
     if (failed > 0) {
         std::cout << "\n⚠️  Some tests failed! Please review the failures above.\n";
@@ -0,0 +1,206 @@
+/*
+ * SIMD level test for DB25 SQL Tokenizer
+ * Verifies level selection, that every supported level produces exactly
+ * the same tokens as the scalar path, and that the classification kernels
+ * agree with the scalar reference
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <random>
+#include <vector>
+#include "simd_tokenizer.hpp"
+#include "test_support.hpp"
+
+#if defined(__linux__)
+    #include <sys/mman.h>
+    #include <unistd.h>
+#endif
+
+using namespace db25;
+
+template<typename Tokenizer>
+bool same_tokens(const std::string& sql, SimdLevel level, const std::string& description) {
+    auto data = reinterpret_cast<const std::byte*>(sql.data());
+    auto expected = Tokenizer(data, sql.size(), SimdLevel::None).tokenize();
+    auto actual = Tokenizer(data, sql.size(), level).tokenize();
+
+    StringArena arena;
+    bool ok = expected.size() == actual.size();
+    for (size_t i = 0; ok && i < expected.size(); ++i) {
+        const Token& a = expected[i];
+        const Token& b = actual[i];
+        ok = a.type == b.type && a.value == b.value && a.keyword_id == b.keyword_id &&
+             a.flags == b.flags && a.operator_id == b.operator_id &&
+             a.line == b.line && a.column == b.column &&
+             a.unescaped(arena, SimdLevel::None) == b.unescaped(arena, level);
+    }
+
+    std::string label = std::string("[") + CpuDetection::level_name(level) + "] " + description;
+    if (!ok) {
+        std::cout << "✗ FAIL: " << label << "\n";
+        return false;
+    }
+    std::cout << "✓ PASS: " << label << "\n";
+    return true;
+}
+
+// Compares the classification kernels of `level` with ScalarProcessor on
+// every length and start offset of `text`
+bool same_kernels(const std::string& text, SimdLevel level, const std::string& description) {
+    ScalarProcessor scalar;
+    auto data = reinterpret_cast<const std::byte*>(text.data());
+    bool ok = true;
+    for (size_t start = 0; ok && start < 64 && start < text.size(); ++start) {
+        for (size_t size = 0; ok && start + size <= text.size(); size += (size < 130 ? 1 : 61)) {
+            const std::byte* p = data + start;
+            ok = SimdDispatcher(level).dispatch([&](auto processor) {
+                uint8_t expected_seen = 0, actual_seen = 0;
+                return scalar.identifier_length(p, size, expected_seen) ==
+                           processor.identifier_length(p, size, actual_seen) &&
+                       expected_seen == actual_seen &&
+                       scalar.skip_whitespace(p, size) == processor.skip_whitespace(p, size) &&
+                       scalar.find_whitespace(p, size) == processor.find_whitespace(p, size);
+            });
+        }
+    }
+
+    std::string label = std::string("[") + CpuDetection::level_name(level) + "] " + description;
+    return check(ok, label);
+}
+
+// Keyword matching on words of every length up to 70, in both cases, with
+// and without a following identifier byte
+bool same_keyword_matches(SimdLevel level) {
+    ScalarProcessor scalar;
+    bool ok = true;
+    for (size_t length = 1; ok && length <= 70; ++length) {
+        std::string keyword(length, 'K');
+        keyword[length / 2] = 'E';
+        for (const std::string& text : {std::string(length, 'k') + " ", keyword + "x",
+                                        keyword, keyword.substr(0, length - 1)}) {
+            auto data = reinterpret_cast<const std::byte*>(text.data());
+            ok = ok && scalar.matches_keyword(data, text.size(), keyword.data(), length) ==
+                SimdDispatcher(level).dispatch([&](auto processor) {
+                    return processor.matches_keyword(data, text.size(), keyword.data(), length);
+                });
+        }
+    }
+    return check(ok, std::string("[") + CpuDetection::level_name(level) + "] Keyword matching, lengths 1-70");
+}
+
+#if defined(__linux__)
+// Runs the kernels on inputs that end exactly at an inaccessible page, so
+// any read past the end faults
+bool kernels_stay_in_bounds(SimdLevel level) {
+    const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    void* mapping = mmap(nullptr, 2 * page, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapping == MAP_FAILED) {
+        return check(false, "Map guard page");
+    }
+    auto* guard = static_cast<std::byte*>(mapping) + page;
+    mprotect(guard, page, PROT_NONE);
+    std::memset(mapping, 'a', page);
+
+    size_t total = 0;
+    for (size_t size = 0; size < 100; ++size) {
+        const std::byte* p = guard - size;
+        total += SimdDispatcher(level).dispatch([&](auto processor) {
+            uint8_t seen = 0;
+            return processor.identifier_length(p, size, seen) + processor.skip_whitespace(p, size) +
+                   processor.find_whitespace(p, size) + processor.matches_keyword(p, size, "aaaa", 4);
+        });
+    }
+    munmap(mapping, 2 * page);
+    return check(total > 0, std::string("[") + CpuDetection::level_name(level) +
+                 "] Kernels never read past the end of the input");
+}
+#endif
+
+int main() {
+    std::cout << "DB25 Tokenizer - SIMD Level Test\n";
+    std::cout << "================================\n\n";
+
+    TestResults results;
+
+    // Level selection API
+    results.record(check(CpuDetection::parse_level("AVX2") == SimdLevel::AVX2, "Parse level names case-insensitively"));
+    results.record(check(CpuDetection::parse_level("sse4.2") == SimdLevel::SSE42, "Parse dotted SSE4.2 name"));
+    results.record(check(CpuDetection::parse_level("scalar") == SimdLevel::None, "Parse scalar level"));
+    results.record(check(CpuDetection::parse_level("AVX512VBMI") == SimdLevel::AVX512_VBMI,
+                         "Parse AVX-512 VBMI level"));
+    results.record(check(CpuDetection::tier(SimdLevel::AVX512_VBMI) > CpuDetection::tier(SimdLevel::AVX512) &&
+                         CpuDetection::tier(SimdLevel::NEON) < 0,
+                         "AVX-512 VBMI ranks above AVX-512, NEON off the x86 order"));
+    results.record(check(CpuDetection::supports_avx512_vbmi() == CpuDetection::is_supported(SimdLevel::AVX512_VBMI) &&
+                         (!CpuDetection::supports_avx512_vbmi() || CpuDetection::supports_avx512()),
+                         "AVX-512 VBMI implies AVX-512"));
+    results.record(check(!CpuDetection::supports_avx512_vbmi() || CpuDetection::features().avx512_vbmi(),
+                         "AVX-512 VBMI selected only with VBMI, VBMI2 and BMI2"));
+    results.record(check(!CpuDetection::parse_level("avx3").has_value(), "Reject unknown level names"));
+    results.record(check(SimdDispatcher(SimdLevel::None).level() == SimdLevel::None, "Scalar can always be pinned"));
+    results.record(check(CpuDetection::is_supported(SimdDispatcher(SimdLevel::AVX512).level()),
+                         "Requested level is capped to a supported one"));
+
+    const char* env = std::getenv("DB25_SIMD_LEVEL");
+    SimdLevel expected_default = CpuDetection::detect();
+    if (env != nullptr && CpuDetection::parse_level(env)) {
+        expected_default = CpuDetection::clamp(*CpuDetection::parse_level(env));
+    }
+    results.record(check(SimdDispatcher().level() == expected_default,
+                         std::string("Default level honours DB25_SIMD_LEVEL (") +
+                         SimdDispatcher().level_name() + ")"));
+
+    // Inputs that exercise every vectorized kernel, including block tails
+    std::string escapes = "SELECT '";
+    std::string utf8 = "SELECT ";
+    std::string backslashes = "SELECT '";
+    for (int i = 0; i < 300; ++i) {
+        escapes += (i % 13 == 0) ? "''" : std::string(1, static_cast<char>('a' + i % 26));
+        utf8 += (i % 5 == 0) ? "gr\xC3\xB6\xC3\x9F" "e_" : "x";
+        utf8 += std::to_string(i);
+        utf8 += ", ";
+        backslashes += (i % 7 == 0) ? "\\\\\\'" : ((i % 11 == 0) ? "\\\\" : "j");
+    }
+    escapes += "' FROM t";
+    utf8 += "'caf\xC3\xA9' FROM t WHERE bad = '\xE5\x88' OR x\xC0\x80y";
+    backslashes += "' AND \"x\\\"y\" = 1";
+
+    std::string dollar = "CREATE FUNCTION f() RETURNS int AS $body$\n";
+    for (int i = 0; i < 200; ++i) {
+        dollar += "  IF x$1 > " + std::to_string(i) + " THEN RETURN $bod$; END IF;\n";
+    }
+    dollar += "$body$ LANGUAGE plpgsql; SELECT E'\\x41\\n' || data->>'k'";
+
+    std::string whitespace = "SELECT" + std::string(200, ' ') + "a" + std::string(77, '\n') + "FROM\tt";
+
+    // Every byte value, in runs that cross 64-byte blocks
+    std::mt19937 rng(42);
+    std::string mixed;
+    const char* pieces[] = {"SELECT", " ", "\t\n", "col_1", "(", "'", "+=", "\xC3\xA9", "42", "#$@"};
+    while (mixed.size() < 600) {
+        mixed += (rng() % 4 == 0) ? std::string(rng() % 70, ' ') : pieces[rng() % 10];
+        mixed += static_cast<char>(rng() % 256);
+    }
+
+    std::string corpus = read_file("test/sql_test.sqls");
+    results.record(check(!corpus.empty(), "Corpus loaded"));
+
+    for (SimdLevel level : CpuDetection::supported_levels()) {
+        results.record(same_tokens<SimdTokenizer>(corpus, level, "sql_test.sqls corpus"));
+        results.record(same_tokens<SimdTokenizer>(escapes, level, "Doubled-quote escapes"));
+        results.record(same_tokens<SimdTokenizer>(utf8, level, "UTF-8 identifiers and literals"));
+        results.record(same_tokens<SimdTokenizer>(whitespace, level, "Whitespace runs"));
+        results.record(same_tokens<MySqlTokenizer>(backslashes, level, "Backslash escapes (MySQL)"));
+        results.record(same_tokens<PostgresTokenizer>(dollar, level, "Dollar quoting (PostgreSQL)"));
+        results.record(same_kernels(mixed, level, "Classification kernels match scalar"));
+        results.record(same_keyword_matches(level));
+        #if defined(__linux__)
+        results.record(kernels_stay_in_bounds(level));
+        #endif
+    }
+
+    return results.summary("All SIMD level tests passed.");
+}
@@ -0,0 +1,248 @@
+/*
+ * String literal test for DB25 SQL Tokenizer
+ * Verifies escape flags and lazy unescaping of quoted literals, including
+ * backslash-escaped MySQL and PostgreSQL E'' literals
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <iomanip>
+#include <random>
+#include "simd_tokenizer.hpp"
+
+using namespace db25;
+
+struct LiteralTestCase {
+    std::string sql;
+    std::string expected_text;
+    uint8_t expected_flags;
+    std::string description;
+};
+
+template<typename Tokenizer = SimdTokenizer>
+bool test_literal(const LiteralTestCase& test) {
+    Tokenizer tokenizer(
+        reinterpret_cast<const std::byte*>(test.sql.data()),
+        test.sql.size()
+    );
+
+    auto tokens = tokenizer.tokenize();
+
+    if (tokens.size() != 1) {
+        std::cout << "✗ FAIL: " << test.description << "\n";
+        std::cout << "  Expected 1 token, got " << tokens.size() << "\n";
+        return false;
+    }
+
+    const Token& token = tokens.front();
+    StringArena arena;
+    std::string_view text = token.unescaped(arena);
+
+    if (token.flags != test.expected_flags) {
+        std::cout << "✗ FAIL: " << test.description << "\n";
+        std::cout << "  Flags: expected 0x" << std::hex << int(test.expected_flags)
+                  << ", got 0x" << int(token.flags) << std::dec << "\n";
+        return false;
+    }
+
+    if (text != test.expected_text) {
+        std::cout << "✗ FAIL: " << test.description << "\n";
+        std::cout << "  Expected [" << test.expected_text << "], got [" << text << "]\n";
+        return false;
+    }
+
+    // Literals without escapes must be served straight from the input buffer
+    bool zero_copy = !(token.flags & TOKEN_FLAG_ESCAPED);
+    if (zero_copy && (arena.bytes_used() != 0 ||
+                      text.data() < test.sql.data() ||
+                      text.data() > test.sql.data() + test.sql.size())) {
+        std::cout << "✗ FAIL: " << test.description << "\n";
+        std::cout << "  Unescaped literal was copied\n";
+        return false;
+    }
+
+    std::cout << "✓ PASS: " << test.description << "\n";
+    return true;
+}
+
+// Builds a long literal with escapes straddling every vector boundary
+LiteralTestCase make_long_literal(size_t length, size_t escape_every) {
+    std::string sql = "'";
+    std::string expected;
+    for (size_t i = 0; i < length; ++i) {
+        if (i % escape_every == escape_every - 1) {
+            sql += "''";
+            expected += "'";
+        } else {
+            char ch = static_cast<char>('a' + (i % 26));
+            sql += ch;
+            expected += ch;
+        }
+    }
+    sql += "'";
+    return {sql, expected, TOKEN_FLAG_QUOTED | TOKEN_FLAG_ESCAPED,
+            "Long literal, escape every " + std::to_string(escape_every) +
+            " bytes (" + std::to_string(length) + " chars)"};
+}
+
+// Reference end of a backslash-escaped literal starting at sql[0]
+size_t reference_literal_end(const std::string& sql) {
+    for (size_t i = 1; i < sql.size(); ++i) {
+        if (sql[i] == '\\') {
+            ++i;
+        } else if (sql[i] == '\'') {
+            if (i + 1 < sql.size() && sql[i + 1] == '\'') {
+                ++i;
+            } else {
+                return i + 1;
+            }
+        }
+    }
+    return sql.size();
+}
+
+// Random backslash runs and quotes around 64-byte block boundaries, checked
+// against a byte-at-a-time reference
+bool test_backslash_fuzz() {
+    std::mt19937 rng(30);
+    int mismatches = 0;
+
+    for (int iteration = 0; iteration < 20000; ++iteration) {
+        std::string sql = "'";
+        size_t length = rng() % 200;
+        for (size_t i = 0; i < length; ++i) {
+            unsigned pick = rng() % 10;
+            sql += pick < 3 ? '\\' : (pick == 3 ? '\'' : 'x');
+        }
+
+        MySqlTokenizer tokenizer(reinterpret_cast<const std::byte*>(sql.data()), sql.size());
+        auto tokens = tokenizer.tokenize();
+        if (tokens.empty() || tokens[0].value.size() != reference_literal_end(sql)) {
+            ++mismatches;
+        }
+    }
+
+    if (mismatches != 0) {
+        std::cout << "✗ FAIL: Backslash literal ends disagree with reference ("
+                  << mismatches << " inputs)\n";
+        return false;
+    }
+    std::cout << "✓ PASS: Backslash literal ends match reference\n";
+    return true;
+}
+
+// An unescaped literal followed within the same 64-byte block by an escaped
+// one: only the second may be flagged, and the first unescapes zero-copy
+template<typename Tokenizer>
+bool test_flags_stay_local(const std::string& first, const std::string& second, const std::string& description) {
+    std::string sql = first + ", " + second + std::string(100, ' ');
+    Tokenizer tokenizer(reinterpret_cast<const std::byte*>(sql.data()), sql.size());
+    auto tokens = tokenizer.tokenize();
+    StringArena arena;
+    const uint8_t BACKSLASH = TOKEN_FLAG_QUOTED | TOKEN_FLAG_ESCAPED | TOKEN_FLAG_BACKSLASH;
+
+    bool ok = tokens.size() >= 3 && tokens[0].value == first && tokens[0].flags == TOKEN_FLAG_QUOTED &&
+              tokens[0].unescaped(arena) == "abc" && arena.bytes_used() == 0 &&
+              tokens.back().value == second && tokens.back().flags == BACKSLASH;
+    std::cout << (ok ? "✓ PASS: " : "✗ FAIL: ") << description << "\n";
+    return ok;
+}
+
+int main() {
+    std::cout << "DB25 Tokenizer - String Literal Test\n";
+    std::cout << "====================================\n\n";
+
+    std::vector<LiteralTestCase> test_cases = {
+        {"'hello'", "hello", TOKEN_FLAG_QUOTED, "Plain literal"},
+        {"''", "", TOKEN_FLAG_QUOTED, "Empty literal"},
+        {"'it''s'", "it's", TOKEN_FLAG_QUOTED | TOKEN_FLAG_ESCAPED, "Doubled quote"},
+        {"''''", "'", TOKEN_FLAG_QUOTED | TOKEN_FLAG_ESCAPED, "Only an escaped quote"},
+        {"'a''''b'", "a''b", TOKEN_FLAG_QUOTED | TOKEN_FLAG_ESCAPED, "Adjacent escapes"},
+        {"\"col\"\"name\"", "col\"name", TOKEN_FLAG_QUOTED | TOKEN_FLAG_ESCAPED,
+         "Double-quoted identifier with escape"},
+        {"'line1\nline2'", "line1\nline2", TOKEN_FLAG_QUOTED, "Multi-line literal"},
+        {"'open", "open", TOKEN_FLAG_QUOTED | TOKEN_FLAG_UNTERMINATED, "Unterminated literal"},
+        {"'open''", "open'", TOKEN_FLAG_QUOTED | TOKEN_FLAG_ESCAPED | TOKEN_FLAG_UNTERMINATED,
+         "Unterminated literal ending in escape"},
+        {"12345", "12345", TOKEN_FLAG_NONE, "Non-literal token returned as-is"},
+    };
+
+    for (size_t every : {1, 2, 3, 7, 15, 16, 17, 31, 32, 33, 64}) {
+        test_cases.push_back(make_long_literal(300, every));
+    }
+    test_cases.push_back(make_long_literal(4096, 1000));
+
+    const uint8_t BACKSLASH = TOKEN_FLAG_QUOTED | TOKEN_FLAG_ESCAPED | TOKEN_FLAG_BACKSLASH;
+    std::vector<LiteralTestCase> mysql_cases = {
+        {"'it\\'s'", "it's", BACKSLASH, "Backslash-escaped quote"},
+        {"'a\\\\'", "a\\", BACKSLASH, "Even backslash run ends literal"},
+        {"'a\\\\\\'b'", "a\\'b", BACKSLASH, "Odd backslash run escapes quote"},
+        {"'\\n\\t\\r\\0\\Z'", std::string("\n\t\r\0\x1A", 5), BACKSLASH, "Control escapes"},
+        {"'100\\%'", "100\\%", BACKSLASH, "LIKE wildcard escape kept"},
+        {"\"say \\\"hi\\\"\"", "say \"hi\"", BACKSLASH, "Double-quoted string"},
+        {"'it''s'", "it's", TOKEN_FLAG_QUOTED | TOKEN_FLAG_ESCAPED, "Doubled quote still escapes"},
+        {"'open\\'", "open'", BACKSLASH | TOKEN_FLAG_UNTERMINATED, "Escaped quote leaves literal open"},
+    };
+
+    // Escaped JSON payload spanning several 64-byte blocks
+    std::string json_sql = "'";
+    std::string json_text;
+    for (int i = 0; i < 20; ++i) {
+        json_sql += "{\\\"key\\\": \\\"va\\\\lue\\\"}, ";
+        json_text += "{\"key\": \"va\\lue\"}, ";
+    }
+    json_sql += "'";
+    mysql_cases.push_back({json_sql, json_text, BACKSLASH, "Escaped JSON payload"});
+
+    std::vector<LiteralTestCase> postgres_cases = {
+        {"E'it\\'s'", "it's", BACKSLASH, "E-string escaped quote"},
+        {"e'\\x41\\102\\f'", "AB\f", BACKSLASH, "Hex, octal and form feed"},
+        {"E'\\u00e9\\U0001F600'", "\xC3\xA9\xF0\x9F\x98\x80", BACKSLASH, "Unicode escapes"},
+        {"E'\\uD83D\\uDE00'", "\xF0\x9F\x98\x80", BACKSLASH, "Surrogate pair"},
+        {"'a\\'", "a\\", TOKEN_FLAG_QUOTED, "Standard string keeps backslash"},
+    };
+
+    // Generic dialect treats backslash as an ordinary character
+    test_cases.push_back({"'a\\'", "a\\", TOKEN_FLAG_QUOTED, "Backslash is literal by default"});
+
+    int passed = 0;
+    int failed = 0;
+
+    for (const auto& test : test_cases) {
+        if (test_literal(test)) {
+            passed++;
+        } else {
+            failed++;
+        }
+    }
+    for (const auto& test : mysql_cases) {
+        test_literal<MySqlTokenizer>(test) ? passed++ : failed++;
+    }
+    for (const auto& test : postgres_cases) {
+        test_literal<PostgresTokenizer>(test) ? passed++ : failed++;
+    }
+    test_flags_stay_local<MySqlTokenizer>("'abc'", "'x\\n'", "Escapes after the closing quote not flagged")
+        ? passed++ : failed++;
+    test_flags_stay_local<PostgresTokenizer>("E'abc'", "E'x\\n'", "E-string escapes stay with their literal")
+        ? passed++ : failed++;
+    test_backslash_fuzz() ? passed++ : failed++;
+    size_t total = passed + failed;
+
+    std::cout << "\n" << std::string(50, '=') << "\n";
+    std::cout << "Test Summary\n";
+    std::cout << std::string(50, '=') << "\n";
+    std::cout << "Total Tests: " << total << "\n";
+    std::cout << "Passed:      " << passed << "\n";
+    std::cout << "Failed:      " << failed << "\n";
+    std::cout << "Success Rate: " << std::fixed << std::setprecision(1)
+              << (passed * 100.0 / total) << "%\n";
+
+    if (failed > 0) {
+        std::cout << "\n⚠️  Some tests failed! Please review the failures above.\n";
+        return 1;
+    } else {
+        std::cout << "\n✅ All string literal tests passed.\n";
+        return 0;
+    }
+}
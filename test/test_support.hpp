@@ -0,0 +1,96 @@
+/*
+ * Helpers shared by the tokenizer tests: PASS/FAIL lines and the closing
+ * summary, token comparison and reading test files
+ */
+
+#pragma once
+
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <span>
+#include <sstream>
+#include <string>
+#include "simd_tokenizer.hpp"
+
+inline bool check(bool condition, const std::string& description) {
+    std::cout << (condition ? "✓ PASS: " : "✗ FAIL: ") << description << "\n";
+    return condition;
+}
+
+// Counts the checks of one test program and prints its summary
+class TestResults {
+private:
+    int passed_ = 0;
+    int failed_ = 0;
+
+public:
+    void record(bool ok) { ok ? ++passed_ : ++failed_; }
+
+    // Prints the summary, ending with `success` if nothing failed (ctest
+    // matches it); returns the exit code for main()
+    int summary(const std::string& success) const {
+        int total = passed_ + failed_;
+        std::cout << "\n" << std::string(50, '=') << "\n";
+        std::cout << "Test Summary\n";
+        std::cout << std::string(50, '=') << "\n";
+        std::cout << "Total Tests: " << total << "\n";
+        std::cout << "Passed:      " << passed_ << "\n";
+        std::cout << "Failed:      " << failed_ << "\n";
+        std::cout << "Success Rate: " << std::fixed << std::setprecision(1)
+                  << (total > 0 ? passed_ * 100.0 / total : 0.0) << "%\n";
+
+        if (failed_ > 0) {
+            std::cout << "\n⚠️  Some tests failed! Please review the failures above.\n";
+            return 1;
+        }
+        std::cout << "\n✅ " << success << "\n";
+        return 0;
+    }
+};
+
+// Same fields, and values viewing the same bytes of the same text
+inline bool same_token(const db25::Token& a, const db25::Token& b) {
+    return a.type == b.type && a.value.data() == b.value.data() && a.value.size() == b.value.size() &&
+           a.keyword_id == b.keyword_id && a.flags == b.flags && a.operator_id == b.operator_id &&
+           a.line == b.line && a.column == b.column;
+}
+
+// Same fields, values compared by content: for tokens that view different
+// copies of the text
+inline bool equal_token(const db25::Token& a, const db25::Token& b) {
+    return a.type == b.type && a.value == b.value && a.keyword_id == b.keyword_id && a.flags == b.flags &&
+           a.operator_id == b.operator_id && a.line == b.line && a.column == b.column;
+}
+
+inline bool same_tokens(std::span<const db25::Token> a, std::span<const db25::Token> b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (!same_token(a[i], b[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+inline bool equal_tokens(std::span<const db25::Token> a, std::span<const db25::Token> b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (!equal_token(a[i], b[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+inline std::string read_file(const std::filesystem::path& path) {
+    std::ifstream file(path, std::ios::binary);
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    return buffer.str();
+}
@@ -0,0 +1,161 @@
+/*
+ * TokenBuffer test for DB25 SQL Tokenizer
+ * Verifies that a TokenBuffer owns the text its tokens view, survives moves
+ * and the release of the caller's input, and can be handed between threads
+ */
+
+#include <condition_variable>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "token_buffer.hpp"
+#include "test_support.hpp"
+
+using namespace db25;
+
+// Same tokens as tokenize() on the original text, all viewing buffer.input()
+bool matches_tokenize(const TokenBuffer& buffer, const std::string& sql) {
+    SimdTokenizer tokenizer(reinterpret_cast<const std::byte*>(sql.data()), sql.size());
+    std::vector<Token> expected = tokenizer.tokenize();
+    if (expected.size() != buffer.size() || buffer.input() != sql) {
+        return false;
+    }
+
+    const char* first = buffer.input().data();
+    const char* last = first + buffer.input().size();
+    for (size_t i = 0; i < expected.size(); ++i) {
+        const Token& token = buffer[i];
+        if (token.type != expected[i].type || token.value != expected[i].value ||
+            token.keyword_id != expected[i].keyword_id || token.line != expected[i].line ||
+            token.column != expected[i].column ||
+            token.value.data() < first || token.value.data() + token.value.size() > last) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main() {
+    std::cout << "DB25 Tokenizer - TokenBuffer Test\n";
+    std::cout << "=================================\n\n";
+
+    TestResults results;
+
+    static_assert(!std::is_copy_constructible_v<TokenBuffer> && !std::is_copy_assignable_v<TokenBuffer>);
+    static_assert(std::is_nothrow_move_constructible_v<TokenBuffer> &&
+                  std::is_nothrow_move_assignable_v<TokenBuffer>);
+
+    const std::string query = "SELECT name, 'it''s' FROM users -- note\nWHERE id = $1 AND x <> 42";
+
+    // Ownership
+    {
+        TokenBuffer buffer = TokenBuffer::tokenize(query);
+        results.record(check(matches_tokenize(buffer, query), "Same tokens as tokenize(), viewing the owned input"));
+        results.record(check(buffer.input().data() != query.data(), "Input is copied into the buffer"));
+        results.record(check(buffer.memory_bytes() >= buffer.size() * sizeof(Token) + query.size(),
+                             "Memory covers tokens and input"));
+
+        StringArena arena;
+        results.record(check(buffer[3].unescaped(arena) == "it's", "Literals decode from the owned input"));
+    }
+
+    {
+        TokenBuffer buffer;
+        {
+            std::string temporary = query;
+            buffer = TokenBuffer::tokenize(temporary);
+            temporary.assign(temporary.size(), '#');
+        }
+        results.record(check(matches_tokenize(buffer, query), "Tokens survive the release of the caller's input"));
+
+        std::string small = "SELECT 1";  // Short enough for the small-string buffer
+        TokenBuffer from_small = TokenBuffer::tokenize(small);
+        small.clear();
+        results.record(check(from_small.size() == 2 && from_small[1].value == "1",
+                             "Tokens of a small-string input stay valid"));
+    }
+
+    // Moves transfer the block without touching the tokens
+    {
+        TokenBuffer original = TokenBuffer::tokenize(query);
+        const Token* tokens = original.begin();
+        const char* text = original.input().data();
+
+        TokenBuffer moved(std::move(original));
+        TokenBuffer assigned;
+        assigned = std::move(moved);
+        results.record(check(assigned.begin() == tokens && assigned.input().data() == text &&
+                             matches_tokenize(assigned, query), "Moves keep tokens and views in place"));
+        results.record(check(original.empty() && moved.empty() && original.input().empty(),
+                             "Moved-from buffers are empty"));
+
+        std::vector<TokenBuffer> queue;
+        for (int i = 0; i < 100; ++i) {
+            queue.push_back(TokenBuffer::tokenize(query + " -- " + std::to_string(i)));
+        }
+        bool all = true;
+        for (int i = 0; i < 100; ++i) {
+            all = all && matches_tokenize(queue[i], query + " -- " + std::to_string(i));
+        }
+        results.record(check(all, "Buffers survive vector reallocation"));
+    }
+
+    // Dialects, levels and empty input
+    {
+        std::string mysql = "SELECT `a b` FROM t # comment";
+        TokenBuffer buffer = TokenBuffer::tokenize<MySqlTokenizer>(mysql);
+        results.record(check(buffer.size() == 5 && buffer[1].value == "`a b`" && buffer[4].type == TokenType::Comment,
+                             "Dialect tokenizer selectable"));
+
+        TokenBuffer scalar = TokenBuffer::tokenize(query, SimdLevel::None);
+        results.record(check(matches_tokenize(scalar, query), "SIMD level selectable"));
+
+        TokenBuffer empty = TokenBuffer::tokenize("");
+        TokenBuffer blank = TokenBuffer::tokenize("  \n ");
+        results.record(check(empty.empty() && empty.input().empty() && blank.empty() && blank.input() == "  \n ",
+                             "Empty and whitespace-only input"));
+    }
+
+    // Hand-off through a queue to another thread
+    {
+        std::mutex mutex;
+        std::condition_variable ready;
+        std::deque<TokenBuffer> queue;
+        constexpr int kQueries = 1000;
+
+        std::thread producer([&] {
+            for (int i = 0; i < kQueries; ++i) {
+                std::string sql = "SELECT c" + std::to_string(i) + " FROM t WHERE id = " + std::to_string(i);
+                TokenBuffer buffer = TokenBuffer::tokenize(sql);
+                sql.assign(sql.size(), '!');  // The producer reuses its text
+                {
+                    std::lock_guard lock(mutex);
+                    queue.push_back(std::move(buffer));
+                }
+                ready.notify_one();
+            }
+        });
+
+        bool all = true;
+        for (int i = 0; i < kQueries; ++i) {
+            TokenBuffer buffer;
+            {
+                std::unique_lock lock(mutex);
+                ready.wait(lock, [&] { return !queue.empty(); });
+                buffer = std::move(queue.front());
+                queue.pop_front();
+            }
+            std::string number = std::to_string(i);
+            all = all && buffer.size() == 8 && buffer[1].value.starts_with('c') &&
+                  buffer[1].value.substr(1) == number && buffer[7].value == number;
+        }
+        producer.join();
+        results.record(check(all, "Buffers handed between threads keep their text"));
+    }
+
+    return results.summary("All TokenBuffer tests passed.");
+}
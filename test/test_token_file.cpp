@@ -0,0 +1,194 @@
+/*
+ * Token file test for DB25 SQL Tokenizer
+ * Verifies that .db25tok files reopen to the tokens they were written from,
+ * with and without the embedded source, and that damaged or foreign files
+ * are rejected
+ */
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "token_file.hpp"
+#include "test_support.hpp"
+
+using namespace db25;
+
+std::vector<Token> tokenize(const std::string& sql) {
+    SimdTokenizer tokenizer(reinterpret_cast<const std::byte*>(sql.data()), sql.size());
+    return tokenizer.tokenize();
+}
+
+void write_file(const std::filesystem::path& path, const std::string& contents) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file << contents;
+}
+
+// Rewrites `path` with the 8 bytes at `offset` replaced by `value`
+void patch(const std::filesystem::path& path, size_t offset, uint64_t value) {
+    std::string contents = read_file(path);
+    std::memcpy(contents.data() + offset, &value, sizeof(value));
+    write_file(path, contents);
+}
+
+template<typename T>
+bool fails_with(const std::expected<T, TokenFileError>& result, TokenFileError error) {
+    return !result.has_value() && result.error() == error;
+}
+
+int main() {
+    std::cout << "DB25 Tokenizer - Token File Test\n";
+    std::cout << "================================\n\n";
+
+    TestResults results;
+
+    auto stamp = std::chrono::steady_clock::now().time_since_epoch().count();
+    std::filesystem::path directory =
+        std::filesystem::temp_directory_path() / ("db25_token_file_test_" + std::to_string(stamp));
+    std::filesystem::create_directories(directory);
+    std::filesystem::path path = directory / "corpus.db25tok";
+
+    std::string corpus = read_file("test/sql_test.sqls");
+    results.record(check(!corpus.empty(), "Corpus loaded"));
+    std::vector<Token> expected = tokenize(corpus);
+
+    // Round trip with the source embedded
+    {
+        results.record(check(write_token_file(path, expected, corpus).has_value(), "Token file written"));
+        bool leftovers = false;
+        for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+            leftovers = leftovers || entry.path().filename() != "corpus.db25tok";
+        }
+        results.record(check(!leftovers, "Temporary file renamed into place"));
+
+        auto file = open_token_file(path);
+        results.record(check(file.has_value() && file->has_source() && file->source() == corpus &&
+                             equal_tokens(file->tokens(), expected), "Reopened tokens match tokenize()"));
+        results.record(check(file.has_value() && file->verify() && file->matches(corpus) &&
+                             !file->matches(corpus + " ") && file->source_hash() == token_source_hash(corpus),
+                             "Integrity check and source matching"));
+        results.record(check(file.has_value() && file->token(1234).value == expected[1234].value &&
+                             file->token(1234).line == expected[1234].line, "Random access to one token"));
+
+        std::cout << "  " << expected.size() << " tokens, " << corpus.size() << " source bytes, "
+                  << (file.has_value() ? file->file_size() : 0) << " file bytes\n";
+
+        TokenFile moved = std::move(*file);
+        TokenFile assigned;
+        assigned = std::move(moved);
+        results.record(check(equal_tokens(assigned.tokens(), expected) && moved.size() == 0 && moved.source().empty(),
+                             "Moves transfer the mapping"));
+    }
+
+    // Source kept by the caller
+    {
+        std::filesystem::path hashed = directory / "hashed.db25tok";
+        TokenFileOptions options;
+        options.embed_source = false;
+        results.record(check(write_token_file(hashed, expected, corpus, options).has_value(),
+                             "Token file written without source"));
+
+        auto file = open_token_file(hashed);
+        bool ok = file.has_value() && !file->has_source() && file->source().empty() &&
+                  file->matches(corpus) && file->verify() &&
+                  file->file_size() < std::filesystem::file_size(path) - corpus.size() + 64;
+        std::vector<Token> tokens = ok ? file->stream().decode(corpus) : std::vector<Token>{};
+        results.record(check(ok && equal_tokens(tokens, expected) && tokens[0].value.data() == corpus.data(),
+                             "Tokens decode against the caller's text"));
+    }
+
+    // Edge cases
+    {
+        std::filesystem::path empty = directory / "empty.db25tok";
+        auto written = write_token_file(empty, {}, "");
+        auto file = open_token_file(empty);
+        results.record(check(written.has_value() && file.has_value() && file->size() == 0 && file->tokens().empty() &&
+                             file->verify(), "Empty input"));
+
+        std::string hash_input(100, 'x');
+        bool distinct = true;
+        for (size_t length = 1; length < hash_input.size(); ++length) {
+            distinct = distinct && token_source_hash(std::string_view(hash_input).substr(0, length)) !=
+                                   token_source_hash(std::string_view(hash_input).substr(0, length - 1));
+        }
+        hash_input[77] = 'y';
+        results.record(check(distinct && token_source_hash(hash_input) != token_source_hash(std::string(100, 'x')),
+                             "Source hash covers length and every byte"));
+    }
+
+    // Rejected files
+    {
+        std::filesystem::path bad = directory / "bad.db25tok";
+        std::string original = read_file(path);
+
+        results.record(check(fails_with(open_token_file(directory / "missing.db25tok"), TokenFileError::Io),
+                             "Missing file"));
+
+        write_file(bad, "SELECT 1;");
+        bool short_file = fails_with(open_token_file(bad), TokenFileError::NotATokenFile);
+        write_file(bad, std::string(200, 'x'));
+        results.record(check(short_file && fails_with(open_token_file(bad), TokenFileError::NotATokenFile),
+                             "Short or foreign file"));
+
+        write_file(bad, original);
+        patch(bad, 8, 99);  // Format version and byte order mark
+        results.record(check(fails_with(open_token_file(bad), TokenFileError::UnsupportedVersion),
+                             "Other format version"));
+
+        write_file(bad, original);
+        patch(bad, 16, kKeywordTableVersion + 1);
+        bool keywords = fails_with(open_token_file(bad), TokenFileError::TableMismatch);
+        write_file(bad, original);
+        patch(bad, 24, kOperatorTableVersion ^ 1);
+        results.record(check(keywords && fails_with(open_token_file(bad), TokenFileError::TableMismatch),
+                             "Other keyword or operator table"));
+
+        write_file(bad, original.substr(0, original.size() - 1));
+        results.record(check(fails_with(open_token_file(bad), TokenFileError::Corrupt), "Truncated file"));
+
+        // Block index: checked when opening, since decoding trusts it
+        const size_t first_block = 128;
+        write_file(bad, original);
+        patch(bad, first_block + 3 * sizeof(uint64_t), uint64_t{1} << 40);  // Data index
+        bool data_index = fails_with(open_token_file(bad), TokenFileError::Corrupt);
+        write_file(bad, original);
+        patch(bad, first_block + 32, uint64_t{1} << 40);  // Second block's source offset
+        bool source_offset = fails_with(open_token_file(bad), TokenFileError::Corrupt);
+        write_file(bad, original);
+        patch(bad, first_block + 32 + 3 * sizeof(uint64_t), 0);  // Second block's data index
+        results.record(check(data_index && source_offset && fails_with(open_token_file(bad), TokenFileError::Corrupt),
+                             "Damaged block index rejected when opening"));
+
+        // Token data: found by verify(); decoding stays inside the source
+        uint64_t bytes_offset = 0;
+        std::memcpy(&bytes_offset, original.data() + 80, sizeof(bytes_offset));
+        std::string scrambled = original;
+        for (size_t i = 0; i < 64; ++i) {
+            scrambled[bytes_offset + TokenStreamView::kBlockTokens + i] = '\xFF';  // After the first tags
+        }
+        write_file(bad, scrambled);
+        auto damaged = open_token_file(bad);
+        bool contained = damaged.has_value();
+        if (damaged) {
+            const char* begin = damaged->source().data();
+            const char* end = begin + damaged->source().size();
+            for (const Token& token : damaged->tokens()) {
+                contained = contained && token.value.data() >= begin && token.value.data() + token.value.size() <= end;
+            }
+        }
+        results.record(check(contained && !damaged->verify(), "Damaged token data stays inside the source"));
+
+        std::string flipped = original;
+        flipped[flipped.size() - 10] ^= 0x20;  // Inside the embedded source
+        write_file(bad, flipped);
+        auto edited = open_token_file(bad);
+        results.record(check(edited.has_value() && !edited->verify(), "Integrity check catches a damaged source"));
+    }
+
+    std::filesystem::remove_all(directory);
+
+    return results.summary("All token file tests passed.");
+}
@@ -0,0 +1,123 @@
+/*
+ * Token pipeline test for DB25 SQL Tokenizer
+ * Verifies that TokenPipeline delivers exactly the tokens of tokenize(), in
+ * order, for any block and ring size, and that the ring applies
+ * back-pressure and stops cleanly when the consumer leaves early
+ */
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "token_pipeline.hpp"
+#include "test_support.hpp"
+
+using namespace db25;
+
+template<typename Tokenizer>
+std::vector<Token> tokenize(const std::string& sql) {
+    Tokenizer tokenizer(reinterpret_cast<const std::byte*>(sql.data()), sql.size());
+    return tokenizer.tokenize();
+}
+
+// Every block, concatenated; false if a block is empty or oversized
+bool drain(TokenPipeline& pipeline, size_t block_tokens, std::vector<Token>& tokens) {
+    bool sizes_ok = true;
+    for (auto block = pipeline.next(); !block.empty(); block = pipeline.next()) {
+        sizes_ok = sizes_ok && block.size() <= block_tokens;
+        tokens.insert(tokens.end(), block.begin(), block.end());
+    }
+    return sizes_ok && pipeline.next().empty();
+}
+
+int main() {
+    std::cout << "DB25 Tokenizer - Token Pipeline Test\n";
+    std::cout << "====================================\n\n";
+
+    TestResults results;
+
+    std::string corpus = read_file("test/sql_test.sqls");
+    results.record(check(!corpus.empty(), "Corpus loaded"));
+    std::vector<Token> expected = tokenize<SimdTokenizer>(corpus);
+
+    // Block and ring sizes, including blocks that divide the token count
+    {
+        bool ok = true;
+        const size_t shapes[][2] = {{512, 8}, {1, 1}, {7, 3}, {64, 2}, {expected.size(), 1},
+                                    {expected.size() / 4, 4}, {1 << 20, 2}};
+        for (const auto& shape : shapes) {
+            TokenPipelineOptions options;
+            options.block_tokens = shape[0];
+            options.ring_blocks = shape[1];
+            TokenPipeline pipeline(corpus, options);
+            std::vector<Token> tokens;
+            ok = ok && drain(pipeline, shape[0], tokens) && same_tokens(tokens, expected);
+        }
+        results.record(check(ok, "Tokens match tokenize() for every block and ring size"));
+    }
+
+    // A consumer slower than the tokenizer: the producer waits on the full ring
+    {
+        TokenPipelineOptions options;
+        options.block_tokens = 256;
+        options.ring_blocks = 2;
+        TokenPipeline pipeline(corpus, options);
+        std::vector<Token> tokens;
+        for (auto block = pipeline.next(); !block.empty(); block = pipeline.next()) {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+            tokens.insert(tokens.end(), block.begin(), block.end());
+        }
+        results.record(check(same_tokens(tokens, expected), "Slow consumer with a two-block ring"));
+    }
+
+    // Dialects
+    {
+        const std::string postgres = "SELECT $fn$ body;\n 'x' $fn$, E'a\\'b', data->>'k'\r\nFROM t";
+        TokenPipelineOptions options;
+        options.block_tokens = 3;
+        options.tokenize = &tokenize_blocks<PostgresTokenizer>;
+        TokenPipeline pipeline(postgres, options);
+        std::vector<Token> tokens;
+        results.record(check(drain(pipeline, 3, tokens) && same_tokens(tokens, tokenize<PostgresTokenizer>(postgres)),
+                             "PostgreSQL tokenizer option"));
+    }
+
+    // Edge cases
+    {
+        TokenPipeline empty("");
+        bool empty_ok = empty.next().empty() && empty.next().empty();
+        std::string blank = "   \n\t ";
+        TokenPipeline whitespace(blank);
+        std::vector<Token> tokens;
+        results.record(check(empty_ok && drain(whitespace, 512, tokens) &&
+                             same_tokens(tokens, tokenize<SimdTokenizer>(blank)), "Empty and whitespace-only input"));
+
+        // Consumer leaves while the producer waits on a full ring; must not hang
+        bool stopped = true;
+        for (int consumed = 0; consumed < 3; ++consumed) {
+            TokenPipelineOptions options;
+            options.block_tokens = 16;
+            options.ring_blocks = 1;
+            TokenPipeline pipeline(corpus, options);
+            for (int i = 0; i < consumed; ++i) {
+                stopped = stopped && pipeline.next().size() == 16;
+            }
+        }
+        results.record(check(stopped, "Destroyed before the last block"));
+
+        // The ring on its own, driven by tokenize_blocks() on this thread;
+        // sized to hold every token, since nothing drains it meanwhile
+        TokenRing ring(expected.size() / 7 + 1, 8);
+        size_t count = tokenize_blocks(corpus, ring);
+        std::vector<Token> ring_tokens;
+        for (auto block = ring.next(); !block.empty(); block = ring.next()) {
+            ring_tokens.insert(ring_tokens.end(), block.begin(), block.end());
+        }
+        ring.close();
+        results.record(check(ring.capacity() == 8 && count == expected.size() && same_tokens(ring_tokens, expected) &&
+                             ring.acquire().empty(), "TokenRing used directly, then closed"));
+    }
+
+    return results.summary("All token pipeline tests passed.");
+}
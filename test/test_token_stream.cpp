@@ -0,0 +1,147 @@
+/*
+ * Compressed token stream test for DB25 SQL Tokenizer
+ * Verifies that CompressedTokenStream decodes every token field exactly,
+ * block by block and in columns, and stays within the size budget
+ */
+
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "token_stream.hpp"
+#include "test_support.hpp"
+
+using namespace db25;
+
+// Whole, per-block, per-token and column decoding all reproduce `tokens`
+bool round_trips(const std::vector<Token>& tokens, const std::string& sql) {
+    CompressedTokenStream stream = CompressedTokenStream::encode(tokens, sql);
+    if (stream.size() != tokens.size() || stream.source_size() != sql.size() || !stream.view().valid() ||
+        !same_tokens(stream.decode(sql), tokens)) {
+        return false;
+    }
+
+    std::vector<Token> blocks;
+    Token block[CompressedTokenStream::kBlockTokens];
+    for (size_t b = 0; b < stream.block_count(); ++b) {
+        size_t count = stream.decode_block(b, sql, block);
+        blocks.insert(blocks.end(), block, block + count);
+    }
+    if (!same_tokens(blocks, tokens)) {
+        return false;
+    }
+
+    for (size_t i = 0; i < tokens.size(); i += 37) {
+        if (!same_token(stream.token(i, sql), tokens[i])) {
+            return false;
+        }
+    }
+
+    TokenColumns columns = stream.decode_columns();
+    if (columns.size() != tokens.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        if (columns.types[i] != tokens[i].type ||
+            columns.offsets[i] != static_cast<uint64_t>(tokens[i].value.data() - sql.data()) ||
+            columns.lengths[i] != tokens[i].value.size() || columns.keywords[i] != tokens[i].keyword_id ||
+            columns.operators[i] != tokens[i].operator_id || columns.flags[i] != tokens[i].flags) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template<typename Tokenizer>
+std::vector<Token> tokenize(const std::string& sql) {
+    Tokenizer tokenizer(reinterpret_cast<const std::byte*>(sql.data()), sql.size());
+    return tokenizer.tokenize();
+}
+
+int main() {
+    std::cout << "DB25 Tokenizer - Compressed Token Stream Test\n";
+    std::cout << "=============================================\n\n";
+
+    TestResults results;
+
+    std::string corpus = read_file("test/sql_test.sqls");
+    results.record(check(!corpus.empty(), "Corpus loaded"));
+
+    // Round trips
+    {
+        std::vector<Token> tokens = tokenize<SimdTokenizer>(corpus);
+        results.record(check(round_trips(tokens, corpus), "sql_test.sqls corpus round-trips"));
+
+        CompressedTokenStream stream = CompressedTokenStream::encode(tokens, corpus);
+        double per_token = static_cast<double>(stream.memory_bytes()) / tokens.size();
+        std::cout << "  " << tokens.size() << " tokens, " << stream.memory_bytes() << " bytes ("
+                  << std::fixed << std::setprecision(2) << per_token << " bytes/token, "
+                  << sizeof(Token) << " uncompressed)\n";
+        results.record(check(per_token <= 4.0, "Corpus compresses to at most 4 bytes per token"));
+    }
+
+    {
+        const std::string mysql = "SELECT `a b`, 'it\\'s' # comment\nFROM t WHERE x <=> y";
+        const std::string postgres = "SELECT $fn$ body;\n 'x' $fn$, E'a\\'b', data->>'k'\r\nFROM t";
+        results.record(check(round_trips(tokenize<MySqlTokenizer>(mysql), mysql), "MySQL quoting and comments"));
+        results.record(check(round_trips(tokenize<PostgresTokenizer>(postgres), postgres),
+                             "PostgreSQL dollar quoting across lines"));
+    }
+
+    // Wide fields: long gaps, long literals, multi-line comments, odd bytes
+    {
+        std::string sql = "SELECT" + std::string(300, ' ') + "'" + std::string(70000, 'x') + "'" +
+                          std::string(70000, '\n') + "/* a\nb\nc */ \"quoted id\" \xff\xfe x" +
+                          " 'unterminated";
+        results.record(check(round_trips(tokenize<SimdTokenizer>(sql), sql), "Wide gaps, lengths and lines"));
+    }
+
+    {
+        std::string sql;
+        for (int i = 0; i < 1000; ++i) {
+            sql += "a+b*c-d/(e) ";
+        }
+        results.record(check(round_trips(tokenize<SimdTokenizer>(sql), sql), "Operator-dense input across blocks"));
+    }
+
+    // Flags and IDs outside the usual combinations are stored raw
+    {
+        std::string sql = "SELECT name FROM users WHERE id = 42";
+        std::vector<Token> tokens = tokenize<SimdTokenizer>(sql);
+        tokens[0].flags = TOKEN_FLAG_INVALID_UTF8;
+        tokens[1].keyword_id = Keyword::FROM;
+        tokens[2].operator_id = Operator::PLUS;
+        tokens[6].flags = TOKEN_FLAG_ESCAPED;
+        results.record(check(round_trips(tokens, sql), "Unusual flag and ID combinations"));
+    }
+
+    // A shorter text than was encoded: values stay within it
+    {
+        auto tokens = tokenize<SimdTokenizer>(corpus);
+        CompressedTokenStream stream = CompressedTokenStream::encode(tokens, corpus);
+        const std::string shorter = corpus.substr(0, corpus.size() / 3 + 5);
+        const char* begin = shorter.data();
+        const char* end = begin + shorter.size();
+        auto inside = [&](const Token& token) {
+            return token.value.data() >= begin && token.value.data() + token.value.size() <= end;
+        };
+        bool contained = true;
+        for (const Token& token : stream.decode(shorter)) {
+            contained = contained && inside(token);
+        }
+        contained = contained && inside(stream.token(tokens.size() - 1, shorter)) &&
+                    stream.token(tokens.size() / 2, "").value.empty();
+        results.record(check(contained, "Decoding a shorter text never views past its end"));
+    }
+
+    // Empty input and stream
+    {
+        std::string empty;
+        CompressedTokenStream stream = CompressedTokenStream::encode({}, empty);
+        CompressedTokenStream blank;
+        results.record(check(stream.empty() && stream.block_count() == 0 && stream.decode(empty).empty() &&
+                             stream.decode_columns().size() == 0 && blank.decode("").empty(), "Empty stream"));
+    }
+
+    return results.summary("All compressed token stream tests passed.");
+}
@@ -0,0 +1,299 @@
+/*
+ * Tokenizer service test for DB25 SQL Tokenizer
+ * Runs a daemon on a thread and checks that clients in this process and in
+ * forked processes get exactly the tokens of local tokenization, that
+ * repeated texts are served from the cache, that slots of exited clients are
+ * reclaimed, and that every error is reported where it should be
+ */
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "tokenizer_service.hpp"
+#include "test_support.hpp"
+
+using namespace db25;
+
+// The statements of the corpus (lines that are neither comments nor blank)
+std::vector<std::string> load_statements(const std::string& path) {
+    std::ifstream file(path);
+    std::vector<std::string> statements;
+    std::string line;
+    while (std::getline(file, line)) {
+        if (!line.empty() && !line.starts_with("--")) {
+            statements.push_back(line);
+        }
+    }
+    return statements;
+}
+
+// Tokenizes every statement through `client`; false on any difference
+bool round_trip(const TokenizerClient& client, const std::vector<std::string>& statements) {
+    for (const auto& sql : statements) {
+        auto query = client.tokenize(sql);
+        if (!query) {
+            return false;
+        }
+        TokenBuffer expected = TokenBuffer::tokenize(sql);
+        std::vector<Token> tokens = query->tokens();
+        bool views_request = tokens.empty() || (tokens.front().value.data() >= query->sql().data() &&
+                                                tokens.front().value.data() < query->sql().data() + sql.size());
+        if (query->sql() != sql || !equal_tokens(tokens, expected.tokens()) || !views_request) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Connects, retrying while the daemon starts
+std::expected<TokenizerClient, TokenizerServiceError> connect_when_ready(const std::string& name) {
+    auto client = TokenizerClient::connect(name);
+    for (int attempt = 0; attempt < 500 && !client; ++attempt) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        client = TokenizerClient::connect(name);
+    }
+    return client;
+}
+
+int main() {
+    std::cout << "DB25 Tokenizer - Tokenizer Service Test\n";
+    std::cout << "=======================================\n\n";
+
+    TestResults results;
+
+    std::vector<std::string> statements = load_statements("test/sql_test.sqls");
+    results.record(check(statements.size() > 10, "Corpus loaded"));
+    const std::string name = "/db25-test-service-" + std::to_string(::getpid());
+
+    // Forked before the daemon exists, so each child starts single-threaded;
+    // children exit while holding a slot, which the daemon must reclaim
+    const int children = 3;
+    std::vector<pid_t> pids;
+    for (int c = 0; c < children; ++c) {
+        pid_t pid = ::fork();
+        if (pid == 0) {
+            auto client = connect_when_ready(name);
+            bool ok = client && round_trip(*client, statements);
+            auto held = client ? client->tokenize(statements.front()) : std::unexpected(TokenizerServiceError::Io);
+            ::_exit(ok && held ? 0 : 1);
+        }
+        pids.push_back(pid);
+    }
+
+    TokenizerDaemonOptions options;
+    options.slots = 4;
+    auto daemon = TokenizerDaemon::create(name, options);
+    results.record(check(daemon.has_value(), "Daemon created"));
+    if (!daemon) {
+        for (pid_t pid : pids) ::kill(pid, SIGKILL);
+        return 1;
+    }
+    std::thread server([&] { daemon->run(); });
+
+    {
+        bool children_ok = true;
+        for (pid_t pid : pids) {
+            int status = 0;
+            children_ok = children_ok && ::waitpid(pid, &status, 0) == pid && WIFEXITED(status) &&
+                          WEXITSTATUS(status) == 0;
+        }
+        results.record(check(children_ok, "Clients in other processes get the tokens of local tokenization"));
+    }
+
+    auto client = TokenizerClient::connect(name);
+    results.record(check(client && round_trip(*client, statements), "Client in this process"));
+    if (!client) {
+        daemon->stop();
+        server.join();
+        return 1;
+    }
+
+    // Four slots, three taken by the children: without reclaiming, a fifth
+    // held query would time out
+    {
+        std::vector<TokenizedQuery> held;
+        for (int i = 0; i < 4; ++i) {
+            if (auto query = client->tokenize(statements[static_cast<size_t>(i)])) {
+                held.push_back(std::move(*query));
+            }
+        }
+        results.record(check(held.size() == 4 && daemon->stats().reclaimed == children,
+                             "Slots of exited clients reclaimed"));
+    }
+
+    // Many threads sharing one client, more of them than slots
+    {
+        std::vector<std::thread> threads;
+        std::vector<int> round_trips(8, 0);
+        for (size_t t = 0; t < round_trips.size(); ++t) {
+            threads.emplace_back([&, t] { round_trips[t] = round_trip(*client, statements); });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        bool ok = true;
+        for (int result : round_trips) {
+            ok = ok && result;
+        }
+        results.record(check(ok, "Eight threads sharing one client over four slots"));
+    }
+
+    // Repeated texts come from the cache
+    {
+        std::string sql = "SELECT cached FROM repeated WHERE x = 42";
+        auto first = client->tokenize(sql);
+        bool first_fresh = first && !first->cached();
+        first = std::unexpected(TokenizerServiceError::Io);   // Frees the slot
+        uint64_t hits = client->stats().cache_hits;
+        auto second = client->tokenize(sql);
+        results.record(check(first_fresh && second && second->cached() && client->stats().cache_hits == hits + 1 &&
+                             equal_tokens(second->tokens(), TokenBuffer::tokenize(sql).tokens()),
+                             "Repeated text served from the cache"));
+    }
+
+    // Whole script in one request: tokens decoded in place, block by block
+    {
+        std::string script = read_file("test/sql_test.sqls");
+        auto query = client->tokenize(script);
+        TokenBuffer expected = TokenBuffer::tokenize(script);
+        bool ok = query && query->size() == expected.size() && equal_tokens(query->tokens(), expected.tokens());
+        for (size_t i = 0; ok && i < expected.size(); i += 97) {
+            ok = query->token(i).value == expected.tokens()[i].value;
+        }
+        results.record(check(ok, "Whole corpus in one request, with random access"));
+    }
+
+    // Errors
+    {
+        std::string huge(client->max_request_bytes() + 1, ' ');
+        auto too_large = client->tokenize(huge);
+        results.record(check(!too_large && too_large.error() == TokenizerServiceError::RequestTooLarge,
+                             "Request larger than request_bytes"));
+
+        auto again = TokenizerDaemon::create(name);
+        auto missing = TokenizerClient::connect(name + "-missing");
+        results.record(check(!again && again.error() == TokenizerServiceError::AlreadyRunning && !missing &&
+                             missing.error() == TokenizerServiceError::NotRunning,
+                             "Second daemon refused, missing daemon reported"));
+
+        TokenizerDaemonOptions small;
+        small.response_bytes = 64;
+        small.cache_bytes = 0;
+        auto tiny = TokenizerDaemon::create(name + "-tiny", small);
+        bool ok = false;
+        if (tiny) {
+            std::thread tiny_server([&] { tiny->run(); });
+            if (auto tiny_client = TokenizerClient::connect(name + "-tiny")) {
+                std::string longer;
+                for (size_t i = 0; i < 20; ++i) {
+                    longer += statements[i] + "\n";
+                }
+                auto fits = tiny_client->tokenize("SELECT 1");
+                auto overflow = tiny_client->tokenize(longer);
+                ok = fits && equal_tokens(fits->tokens(), TokenBuffer::tokenize("SELECT 1").tokens()) && !overflow &&
+                     overflow.error() == TokenizerServiceError::ResponseTooLarge && tiny->stats().errors == 1;
+            }
+            tiny->stop();
+            tiny_server.join();
+        }
+        results.record(check(ok, "Response larger than response_bytes"));
+    }
+
+    // Stopped daemons: queued requests are answered, later ones refused
+    {
+        daemon->stop();
+        server.join();
+        auto after = client->tokenize("SELECT 1");
+        bool refused = !after && after.error() == TokenizerServiceError::NotRunning;
+        daemon = std::unexpected(TokenizerServiceError::NotRunning);   // Destroys the daemon
+        auto reconnect = TokenizerClient::connect(name);
+        results.record(check(refused && !reconnect && reconnect.error() == TokenizerServiceError::NotRunning,
+                             "Stopped daemon refuses requests and removes its segment"));
+    }
+
+    // A daemon that died without cleaning up leaves its segment behind; the
+    // next daemon replaces it
+    {
+        const std::string stale = name + "-stale";
+        pid_t pid = ::fork();
+        if (pid == 0) {
+            auto dead = TokenizerDaemon::create(stale);
+            ::_exit(dead ? 0 : 1);   // No destructor: the segment stays
+        }
+        int status = 0;
+        bool died = ::waitpid(pid, &status, 0) == pid && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+        auto orphaned = TokenizerClient::connect(stale);
+        auto replacement = TokenizerDaemon::create(stale);
+        results.record(check(died && !orphaned && orphaned.error() == TokenizerServiceError::NotRunning &&
+                             replacement.has_value(), "Segment of a dead daemon replaced"));
+    }
+
+    // A daemon started right after another stopped serves the name, also
+    // once the stopped one is destroyed
+    {
+        const std::string handover = name + "-handover";
+        auto old_daemon = TokenizerDaemon::create(handover);
+        bool ok = false;
+        if (old_daemon) {
+            old_daemon->stop();
+            old_daemon->run();
+            auto successor = TokenizerDaemon::create(handover);
+            old_daemon = std::unexpected(TokenizerServiceError::NotRunning);   // Destroys the old daemon
+            if (successor) {
+                std::thread successor_server([&] { successor->run(); });
+                auto client = TokenizerClient::connect(handover);
+                auto result = client ? client->tokenize("SELECT 1") : std::unexpected(TokenizerServiceError::Io);
+                ok = result && equal_tokens(result->tokens(), TokenBuffer::tokenize("SELECT 1").tokens());
+                successor->stop();
+                successor_server.join();
+            }
+        }
+        results.record(check(ok, "Daemon started after a stopped one stays reachable"));
+    }
+
+    // Daemons starting together: the one that loses the race waits for the
+    // winner's segment instead of removing it, so exactly one serves the name
+    {
+        const std::string racing = name + "-race";
+        bool one_each_time = true;
+        for (int round = 0; round < 500; ++round) {
+            std::expected<TokenizerDaemon, TokenizerServiceError> first = std::unexpected(TokenizerServiceError::Io);
+            std::expected<TokenizerDaemon, TokenizerServiceError> second = std::unexpected(TokenizerServiceError::Io);
+            std::atomic<bool> go{false};
+            std::thread other([&] {
+                while (!go.load()) {}
+                second = TokenizerDaemon::create(racing);
+            });
+            go.store(true);
+            first = TokenizerDaemon::create(racing);
+            other.join();
+            auto& loser = first ? second : first;
+            one_each_time = one_each_time && first.has_value() != second.has_value() &&
+                            loser.error() == TokenizerServiceError::AlreadyRunning;
+        }
+        results.record(check(one_each_time, "Concurrently starting daemons: exactly one runs"));
+    }
+
+    // A segment whose daemon died before sizing it is replaced once the
+    // startup grace period has passed
+    {
+        const std::string unsized = name + "-unsized";
+        int fd = ::shm_open(unsized.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        auto replacement = TokenizerDaemon::create(unsized);
+        results.record(check(fd >= 0 && replacement.has_value(),
+                             "Segment left unsized replaced after the grace period"));
+    }
+
+    return results.summary("All tokenizer service tests passed.");
+}
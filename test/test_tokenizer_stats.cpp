@@ -0,0 +1,137 @@
+/*
+ * Tokenizer statistics test for DB25 SQL Tokenizer
+ * Verifies the counters of CountStats/ProfileStats, per-thread aggregation,
+ * snapshot merging and the Prometheus export
+ */
+
+#include <iostream>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "simd_tokenizer.hpp"
+#include "test_support.hpp"
+
+using namespace db25;
+
+template<typename Stats>
+std::vector<Token> run(const std::string& sql) {
+    BasicSimdTokenizer<GenericDialect, Stats> tokenizer(
+        reinterpret_cast<const std::byte*>(sql.data()), sql.size());
+    return tokenizer.tokenize();
+}
+
+size_t count(const StatsSnapshot& stats, TokenType type) {
+    return stats.tokens[static_cast<size_t>(type)];
+}
+
+size_t bytes(const StatsSnapshot& stats, TokenType type) {
+    return stats.bytes[static_cast<size_t>(type)];
+}
+
+int main() {
+    std::cout << "DB25 Tokenizer - Statistics Test\n";
+    std::cout << "================================\n\n";
+
+    TestResults results;
+
+    // Zero cost when off
+    results.record(check(std::is_empty_v<NoStats>, "NoStats is an empty policy"));
+    results.record(check(sizeof(BasicSimdTokenizer<GenericDialect, NoStats>) <
+                         sizeof(BasicSimdTokenizer<GenericDialect, CountStats>),
+                         "NoStats adds no tokenizer state"));
+
+    // Counts
+    const std::string sql = "SELECT name, 'x''y' FROM users -- note\nWHERE id = 42";
+    StatsRegistry::reset();
+    auto tokens = run<CountStats>(sql);
+    StatsSnapshot stats = StatsRegistry::thread_snapshot();
+
+    results.record(check(stats.calls == 1 && stats.input_bytes == sql.size(), "Calls and input bytes counted"));
+    results.record(check(stats.total_tokens() == tokens.size(), "Every returned token counted"));
+    results.record(check(count(stats, TokenType::Keyword) == 3 && count(stats, TokenType::Identifier) == 3,
+                         "Keyword and identifier counts"));
+    results.record(check(count(stats, TokenType::String) == 1 && bytes(stats, TokenType::String) == 6,
+                         "String count and bytes"));
+    results.record(check(count(stats, TokenType::Comment) == 1 && count(stats, TokenType::Number) == 1,
+                         "Comment and number counts"));
+    size_t covered = 0;
+    for (uint64_t b : stats.bytes) {
+        covered += b;
+    }
+    results.record(check(covered == sql.size(), "Token and whitespace bytes cover the input"));
+    results.record(check(stats.keyword_lookups == 6 && stats.keyword_hits == 3 &&
+                         stats.keyword_hit_rate() == 0.5, "Keyword lookups and hit rate"));
+    results.record(check(stats.phase_calls[static_cast<size_t>(StatsPhase::Tokenize)] == 0,
+                         "CountStats does not time phases"));
+
+    // NoStats publishes nothing
+    StatsRegistry::reset();
+    (void)run<NoStats>(sql);
+    results.record(check(StatsRegistry::thread_snapshot().calls == 0, "NoStats publishes nothing"));
+
+    // Phase timing
+    StatsRegistry::reset();
+    (void)run<ProfileStats>(sql);
+    stats = StatsRegistry::thread_snapshot();
+    auto phase = [&](StatsPhase p) { return stats.phase_calls[static_cast<size_t>(p)]; };
+    results.record(check(phase(StatsPhase::Tokenize) == 1 && stats.phase_ticks[0] > 0, "Tokenize phase timed"));
+    results.record(check(phase(StatsPhase::Identifier) == 6 && phase(StatsPhase::KeywordLookup) == 6,
+                         "Identifier and keyword lookup phases entered per word"));
+    results.record(check(phase(StatsPhase::String) == 1 && phase(StatsPhase::Comment) == 1 &&
+                         phase(StatsPhase::Number) == 1 && phase(StatsPhase::Operator) == 2,
+                         "Scanner phases entered per token"));
+    results.record(check(stats.phase_ticks[0] >= stats.phase_ticks[static_cast<size_t>(StatsPhase::Identifier)],
+                         "Phases nest inside Tokenize"));
+
+    // Exact-size mode counts first; only the tokenizing pass is recorded
+    {
+        BasicSimdTokenizer<GenericDialect, ProfileStats> tokenizer(
+            reinterpret_cast<const std::byte*>(sql.data()), sql.size());
+        StatsRegistry::reset();
+        (void)tokenizer.tokenize_exact();
+        StatsSnapshot exact = StatsRegistry::thread_snapshot();
+        results.record(check(exact.calls == stats.calls && exact.tokens == stats.tokens &&
+                             exact.keyword_lookups == stats.keyword_lookups && exact.phase_calls == stats.phase_calls,
+                             "tokenize_exact() profiles like tokenize()"));
+    }
+
+    // Per-thread aggregation, including threads that have exited
+    StatsRegistry::reset();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < 25; ++i) {
+                (void)run<CountStats>(sql);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    (void)run<CountStats>(sql);
+    stats = StatsRegistry::snapshot();
+    results.record(check(stats.calls == 101 && count(stats, TokenType::Keyword) == 303,
+                         "Snapshot sums live and exited threads"));
+    results.record(check(StatsRegistry::thread_snapshot().calls == 1, "Thread snapshot covers the caller only"));
+
+    // Merge
+    StatsSnapshot merged = StatsRegistry::thread_snapshot();
+    merged.merge(StatsRegistry::thread_snapshot());
+    results.record(check(merged.calls == 2 && merged.keyword_hits == 6, "Snapshots merge"));
+
+    // Prometheus export
+    StatsRegistry::reset();
+    (void)run<ProfileStats>(sql);
+    std::string text = StatsRegistry::snapshot().to_prometheus();
+    results.record(check(text.find("# TYPE db25_tokenizer_tokens_total counter\n") != std::string::npos,
+                         "Prometheus TYPE line"));
+    results.record(check(text.find("db25_tokenizer_tokens_total{type=\"keyword\"} 3\n") != std::string::npos,
+                         "Prometheus labelled sample"));
+    results.record(check(text.find("db25_tokenizer_phase_seconds_total{phase=\"keyword_lookup\"}") != std::string::npos,
+                         "Prometheus phase timing"));
+    results.record(check(StatsSnapshot{}.to_prometheus("x").find("x_phase") == std::string::npos,
+                         "Untimed snapshots omit phase metrics"));
+
+    return results.summary("All statistics tests passed.");
+}
@@ -0,0 +1,146 @@
+/*
+ * Tracing test for DB25 SQL Tokenizer
+ * Verifies the per-thread trace rings (wrap-around, concurrent dumps),
+ * the runtime switch, tokenizer trace scopes and the Chrome trace JSON
+ */
+
+#include <atomic>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "simd_tokenizer.hpp"
+#include "test_support.hpp"
+
+using namespace db25;
+
+size_t occurrences(const std::string& text, const std::string& needle) {
+    size_t count = 0;
+    for (size_t pos = text.find(needle); pos != std::string::npos; pos = text.find(needle, pos + 1)) {
+        ++count;
+    }
+    return count;
+}
+
+int main() {
+    std::cout << "DB25 Tokenizer - Tracing Test\n";
+    std::cout << "=============================\n\n";
+    std::cout << "Trace scopes compiled in: " << (kTracingCompiled ? "yes" : "no") << "\n\n";
+
+    TestResults results;
+
+    // Ring buffer
+    TraceRing ring(1, 5);
+    results.record(check(ring.capacity() == 8, "Capacity rounds up to a power of two"));
+    for (uint64_t i = 0; i < 20; ++i) {
+        ring.record("event", i, i + 1, i);
+    }
+    std::vector<TraceRing::Copy> events(ring.capacity());
+    size_t count = ring.copy(events.data());
+    results.record(check(ring.recorded() == 20 && count == 8, "Full ring keeps the newest events"));
+    results.record(check(events[0].arg == 12 && events[7].arg == 19, "Copy is oldest first"));
+    ring.clear();
+    results.record(check(ring.copy(events.data()) == 0, "Cleared ring is empty"));
+
+    // Dumping while the owner records never yields a torn event
+    TraceRing busy(2, 64);
+    std::atomic<bool> stop{false};
+    std::thread writer([&] {
+        for (uint64_t i = 0; !stop.load(std::memory_order_relaxed); ++i) {
+            busy.record("busy", i, i + 1, i);
+        }
+    });
+    bool intact = true;
+    std::vector<TraceRing::Copy> copied(busy.capacity());
+    for (int round = 0; round < 2000; ++round) {
+        size_t n = busy.copy(copied.data());
+        for (size_t i = 0; i < n; ++i) {
+            const auto& event = copied[i];
+            intact &= event.end == event.begin + 1 && event.arg == event.begin;
+            intact &= i == 0 || event.begin == copied[i - 1].begin + 1;
+        }
+        if (round % 64 == 0) {
+            std::this_thread::yield();
+        }
+    }
+    stop = true;
+    writer.join();
+    results.record(check(intact, "Concurrent copies are consistent and contiguous"));
+
+    // Runtime switch
+    Tracer::clear();
+    uint64_t before = Tracer::local().recorded();
+    {
+        TraceScope scope("disabled");
+    }
+    results.record(check(Tracer::local().recorded() == before, "Scopes record nothing while disabled"));
+
+    Tracer::set_enabled(true);
+    {
+        TraceScope scope("batch \"1\"", 4096);
+    }
+    Tracer::set_thread_name("main");
+    count = Tracer::local().copy(events.data());
+    results.record(check(count == 1 && events[0].arg == 4096 && events[0].end >= events[0].begin,
+                         "Scopes record while enabled"));
+
+    // Tokenizer scopes
+    const std::string sql = "SELECT name, 'x' FROM users -- note\nWHERE id = 42";
+    SimdTokenizer tokenizer(reinterpret_cast<const std::byte*>(sql.data()), sql.size());
+    (void)tokenizer.tokenize();
+    std::string json = Tracer::chrome_json();
+    if (kTracingCompiled) {
+        results.record(check(occurrences(json, "\"name\":\"Tokenize\"") == 1 &&
+                             json.find("\"args\":{\"bytes\":" + std::to_string(sql.size()) + "}") != std::string::npos,
+                             "tokenize() traced with its input size"));
+        results.record(check(occurrences(json, "\"name\":\"Identifier\"") == 6 &&
+                             occurrences(json, "\"name\":\"KeywordLookup\"") == 6 &&
+                             occurrences(json, "\"name\":\"String\"") == 1 &&
+                             occurrences(json, "\"name\":\"Comment\"") == 1,
+                             "Tokenizer phases traced"));
+    } else {
+        results.record(check(json.find("\"name\":\"Tokenize\"") == std::string::npos,
+                             "Tokenizer scopes compiled out"));
+    }
+
+    // Threads, including exited ones
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 3; ++t) {
+        threads.emplace_back([t] {
+            Tracer::set_thread_name("worker " + std::to_string(t));
+            TraceScope chunk("chunk", 1024);
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    json = Tracer::chrome_json();
+    results.record(check(occurrences(json, "\"name\":\"chunk\"") == 3 &&
+                         json.find("\"args\":{\"name\":\"worker 2\"}") != std::string::npos,
+                         "Exited threads appear with their names"));
+
+    // Chrome trace-event JSON
+    results.record(check(json.rfind("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", 0) == 0 &&
+                         json.ends_with("\n]}\n"), "Trace-event JSON envelope"));
+    results.record(check(json.find("\"name\":\"batch \\\"1\\\"\",\"cat\":\"db25\",\"ph\":\"X\",\"ts\":") !=
+                         std::string::npos, "Complete events with escaped names"));
+    results.record(check(json.find("\"args\":{\"name\":\"main\"}") != std::string::npos, "Thread name metadata"));
+    results.record(check(json.find(",\n]") == std::string::npos && json.find("[,") == std::string::npos,
+                         "No stray separators"));
+
+    Tracer::clear();
+    json = Tracer::chrome_json();
+    results.record(check(json.find("worker") == std::string::npos &&
+                         json.find("\"name\":\"main\"") != std::string::npos,
+                         "Clear forgets exited threads and keeps live ones"));
+    results.record(check(occurrences(json, "\"ph\":\"X\"") == 0, "Clear empties the rings"));
+
+    std::string path = "trace_test.json";
+    results.record(check(Tracer::write_chrome_json(path) && !Tracer::write_chrome_json("/nonexistent/dir/t.json"),
+                         "Writes to a file and reports failures"));
+    std::remove(path.c_str());
+    Tracer::set_enabled(false);
+
+    return results.summary("All tracing tests passed.");
+}
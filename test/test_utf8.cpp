@@ -0,0 +1,186 @@
+/*
+ * UTF-8 test for DB25 SQL Tokenizer
+ * Verifies non-ASCII identifiers, literals and vectorized UTF-8 validation
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <iomanip>
+#include <random>
+#include "simd_tokenizer.hpp"
+
+using namespace db25;
+
+struct ExpectedToken {
+    std::string text;
+    TokenType type;
+    uint8_t flags;
+};
+
+struct Utf8TestCase {
+    std::string sql;
+    std::vector<ExpectedToken> expected;
+    std::string description;
+};
+
+bool test_utf8(const Utf8TestCase& test) {
+    SimdTokenizer tokenizer(
+        reinterpret_cast<const std::byte*>(test.sql.data()),
+        test.sql.size()
+    );
+
+    auto tokens = tokenizer.tokenize();
+
+    if (tokens.size() != test.expected.size()) {
+        std::cout << "✗ FAIL: " << test.description << "\n";
+        std::cout << "  Expected " << test.expected.size() << " tokens, got "
+                  << tokens.size() << "\n  Got:      ";
+        for (const auto& t : tokens) std::cout << "[" << t.value << "] ";
+        std::cout << "\n";
+        return false;
+    }
+
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        const auto& expected = test.expected[i];
+        if (tokens[i].value != expected.text || tokens[i].type != expected.type ||
+            tokens[i].flags != expected.flags) {
+            std::cout << "✗ FAIL: " << test.description << "\n";
+            std::cout << "  Token " << i << " mismatch: expected [" << expected.text
+                      << "] type " << int(expected.type) << " flags " << int(expected.flags)
+                      << ", got [" << tokens[i].value << "] type " << int(tokens[i].type)
+                      << " flags " << int(tokens[i].flags) << "\n";
+            return false;
+        }
+    }
+
+    std::cout << "✓ PASS: " << test.description << "\n";
+    return true;
+}
+
+// Cross-checks the dispatched validator against the scalar reference on
+// random mixes of ASCII, multi-byte sequences and corrupted bytes
+bool test_validator_fuzz() {
+    const std::vector<std::string> pieces = {
+        "a", "SELECT ", "\xC3\xB6", "\xC3\x9F", "\xE5\x88\x97", "\xF0\x9F\x98\x80",
+        "\xC0\x80", "\xED\xA0\x80", "\xF4\x90\x80\x80", "\x80", "\xE5\x88", "\xFF",
+        "\xEF\xBF\xBF", "\xF4\x8F\xBF\xBF", "0123456789abcdef0123456789abcdef"
+    };
+
+    std::mt19937 rng(25);
+    SimdDispatcher dispatcher;
+    ScalarProcessor scalar;
+    int mismatches = 0;
+
+    for (int iteration = 0; iteration < 20000; ++iteration) {
+        std::string text;
+        size_t count = rng() % 40;
+        bool corrupt = (rng() % 2) == 0;
+        for (size_t i = 0; i < count; ++i) {
+            size_t limit = corrupt ? pieces.size() : 6;
+            text += pieces[rng() % limit];
+        }
+
+        auto data = reinterpret_cast<const std::byte*>(text.data());
+        bool expected = scalar.validate_utf8(data, text.size());
+        bool actual = dispatcher.dispatch([&](auto processor) {
+            return processor.validate_utf8(data, text.size());
+        });
+        if (expected != actual) {
+            ++mismatches;
+        }
+    }
+
+    if (mismatches != 0) {
+        std::cout << "✗ FAIL: Vectorized validator disagrees with scalar reference ("
+                  << mismatches << " inputs)\n";
+        return false;
+    }
+    std::cout << "✓ PASS: Vectorized validator matches scalar reference\n";
+    return true;
+}
+
+int main() {
+    std::cout << "DB25 Tokenizer - UTF-8 Test\n";
+    std::cout << "===========================\n\n";
+
+    const TokenType ID = TokenType::Identifier;
+    const TokenType KW = TokenType::Keyword;
+    const TokenType STR = TokenType::String;
+    const TokenType OP = TokenType::Operator;
+    const uint8_t QUOTED = TOKEN_FLAG_QUOTED;
+
+    std::vector<Utf8TestCase> test_cases = {
+        {"gr\xC3\xB6\xC3\x9F" "e", {{"gr\xC3\xB6\xC3\x9F" "e", ID, 0}}, "German identifier"},
+        {"\xE5\x88\x97\xE5\x90\x8D", {{"\xE5\x88\x97\xE5\x90\x8D", ID, 0}}, "Chinese identifier"},
+        {"\xC3\xA9t\xC3\xA9", {{"\xC3\xA9t\xC3\xA9", ID, 0}}, "Identifier starting with non-ASCII"},
+        {"SELECT gr\xC3\xB6\xC3\x9F" "e FROM t",
+         {{"SELECT", KW, 0}, {"gr\xC3\xB6\xC3\x9F" "e", ID, 0}, {"FROM", KW, 0}, {"t", ID, 0}},
+         "Non-ASCII column in query"},
+        {"a+\xC3\xBC=1",
+         {{"a", ID, 0}, {"+", OP, 0}, {"\xC3\xBC", ID, 0}, {"=", OP, 0}, {"1", TokenType::Number, 0}},
+         "Non-ASCII identifier between operators"},
+        {"SELECT\xC3\xA9", {{"SELECT\xC3\xA9", ID, 0}}, "Keyword prefix with accent is identifier"},
+        {"x\xF0\x9F\x98\x80", {{"x\xF0\x9F\x98\x80", ID, 0}}, "Four-byte sequence"},
+        {"'caf\xC3\xA9'", {{"'caf\xC3\xA9'", STR, QUOTED}}, "Valid UTF-8 literal"},
+        {"'\xE6\x97\xA5\xE6\x9C\xAC\xE8\xAA\x9E'", {{"'\xE6\x97\xA5\xE6\x9C\xAC\xE8\xAA\x9E'", STR, QUOTED}},
+         "CJK literal"},
+
+        // Malformed input is delimited as one token and flagged
+        {"a\xC0\x80" "b", {{"a\xC0\x80" "b", TokenType::Unknown, TOKEN_FLAG_INVALID_UTF8}},
+         "Overlong encoding"},
+        {"\xED\xA0\x80", {{"\xED\xA0\x80", TokenType::Unknown, TOKEN_FLAG_INVALID_UTF8}},
+         "Encoded surrogate"},
+        {"\xF4\x90\x80\x80", {{"\xF4\x90\x80\x80", TokenType::Unknown, TOKEN_FLAG_INVALID_UTF8}},
+         "Code point above U+10FFFF"},
+        {"x\xE5\x88", {{"x\xE5\x88", TokenType::Unknown, TOKEN_FLAG_INVALID_UTF8}},
+         "Truncated sequence"},
+        {"\x80\x80\x80", {{"\x80\x80\x80", TokenType::Unknown, TOKEN_FLAG_INVALID_UTF8}},
+         "Stray continuation bytes"},
+        {"'bad\xFF'", {{"'bad\xFF'", STR, QUOTED | TOKEN_FLAG_INVALID_UTF8}},
+         "Invalid byte in literal"},
+    };
+
+    // Long identifier exercising whole vector blocks plus a tail
+    std::string long_ident;
+    for (int i = 0; i < 50; ++i) long_ident += "\xC3\xA4x";
+    test_cases.push_back({long_ident, {{long_ident, ID, 0}}, "Long non-ASCII identifier"});
+    std::string long_bad = long_ident + "\xE5";
+    test_cases.push_back({long_bad, {{long_bad, TokenType::Unknown, TOKEN_FLAG_INVALID_UTF8}},
+                          "Long identifier with truncated tail"});
+
+    int passed = 0;
+    int failed = 0;
+
+    for (const auto& test : test_cases) {
+        if (test_utf8(test)) {
+            passed++;
+        } else {
+            failed++;
+        }
+    }
+
+    size_t total = test_cases.size() + 1;
+    if (test_validator_fuzz()) {
+        passed++;
+    } else {
+        failed++;
+    }
+
+    std::cout << "\n" << std::string(50, '=') << "\n";
+    std::cout << "Test Summary\n";
+    std::cout << std::string(50, '=') << "\n";
+    std::cout << "Total Tests: " << total << "\n";
+    std::cout << "Passed:      " << passed << "\n";
+    std::cout << "Failed:      " << failed << "\n";
+    std::cout << "Success Rate: " << std::fixed << std::setprecision(1)
+              << (passed * 100.0 / total) << "%\n";
+
+    if (failed > 0) {
+        std::cout << "\n⚠️  Some tests failed! Please review the failures above.\n";
+        return 1;
+    } else {
+        std::cout << "\n✅ All UTF-8 tests passed.\n";
+        return 0;
+    }
+}
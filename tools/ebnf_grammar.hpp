@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) 2024 Chiradip Mandal
+ * Author: Chiradip Mandal
+ * Organization: Space-RF.org
+ *
+ * This file is part of DB25 SQL Tokenizer.
+ *
+ * Licensed under the MIT License. See LICENSE file for details.
+ */
+
+// EBNF grammar reader shared by the tools: extract_keywords takes the
+// keywords from it, generate_corpus walks its rules
+
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+struct Node {
+    enum class Kind { Terminal, Rule, Sequence, Choice, Optional, Repeat, Special };
+
+    Kind kind;
+    std::string text;  // Terminal spelling or rule name
+    std::vector<std::unique_ptr<Node>> children;
+
+    Node(Kind k, std::string t = {}) : kind(k), text(std::move(t)) {}
+};
+
+class EBNFGrammar {
+private:
+    std::string source;
+    size_t pos = 0;
+    std::string error;
+
+    void skip_space() {
+        while (pos < source.size()) {
+            if (std::isspace(static_cast<unsigned char>(source[pos]))) {
+                ++pos;
+            } else if (source.compare(pos, 2, "(*") == 0) {
+                size_t end = source.find("*)", pos + 2);
+                pos = end == std::string::npos ? source.size() : end + 2;
+            } else {
+                break;
+            }
+        }
+    }
+
+    void fail(const std::string& message) {
+        if (error.empty()) {
+            size_t line = std::count(source.begin(), source.begin() + static_cast<long>(pos), '\n') + 1;
+            error = "line " + std::to_string(line) + ": " + message;
+        }
+    }
+
+    bool is_name_char(char c) const {
+        return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+    }
+
+    std::unique_ptr<Node> parse_choice() {
+        auto choice = std::make_unique<Node>(Node::Kind::Choice);
+        while (true) {
+            auto sequence = parse_sequence();
+            if (!sequence) return nullptr;
+            choice->children.push_back(std::move(sequence));
+            skip_space();
+            if (pos >= source.size() || source[pos] != '|') break;
+            ++pos;
+        }
+
+        if (choice->children.size() == 1) {
+            return std::move(choice->children.front());
+        }
+        return choice;
+    }
+
+    std::unique_ptr<Node> parse_sequence() {
+        auto sequence = std::make_unique<Node>(Node::Kind::Sequence);
+        while (true) {
+            skip_space();
+            if (pos >= source.size()) break;
+            char c = source[pos];
+            if (c == '|' || c == ';' || c == ')' || c == ']' || c == '}') break;
+            if (c == ',') {  // ISO concatenation symbol
+                ++pos;
+                continue;
+            }
+            auto factor = parse_factor();
+            if (!factor) return nullptr;
+            sequence->children.push_back(std::move(factor));
+        }
+        if (sequence->children.size() == 1) {
+            return std::move(sequence->children.front());
+        }
+        return sequence;
+    }
+
+    // ( ... ), [ ... ] or { ... }
+    std::unique_ptr<Node> parse_group(Node::Kind kind, char close) {
+        ++pos;
+        auto inner = parse_choice();
+        if (!inner) return nullptr;
+        skip_space();
+        if (pos >= source.size() || source[pos] != close) {
+            fail(std::string("expected '") + close + "'");
+            return nullptr;
+        }
+        ++pos;
+        if (kind == Node::Kind::Sequence) {
+            return inner;
+        }
+        auto group = std::make_unique<Node>(kind);
+        group->children.push_back(std::move(inner));
+        return group;
+    }
+
+    std::unique_ptr<Node> parse_factor() {
+        char c = source[pos];
+        if (c == '"' || c == '\'' || c == '?') {
+            size_t end = source.find(c, pos + 1);
+            if (end == std::string::npos) {
+                fail(c == '?' ? "unterminated special sequence" : "unterminated terminal");
+                return nullptr;
+            }
+            auto kind = c == '?' ? Node::Kind::Special : Node::Kind::Terminal;
+            auto node = std::make_unique<Node>(kind, source.substr(pos + 1, end - pos - 1));
+            pos = end + 1;
+            return node;
+        }
+        if (c == '(') return parse_group(Node::Kind::Sequence, ')');
+        if (c == '[') return parse_group(Node::Kind::Optional, ']');
+        if (c == '{') return parse_group(Node::Kind::Repeat, '}');
+        if (is_name_char(c)) {
+            size_t start = pos;
+            while (pos < source.size() && is_name_char(source[pos])) ++pos;
+            return std::make_unique<Node>(Node::Kind::Rule, source.substr(start, pos - start));
+        }
+        fail(std::string("unexpected character '") + c + "'");
+        return nullptr;
+    }
+
+public:
+    std::map<std::string, std::unique_ptr<Node>> rules;
+
+    bool load(const std::string& ebnf_file) {
+        std::ifstream file(ebnf_file);
+        if (!file) {
+            std::cerr << "Cannot open EBNF file: " << ebnf_file << std::endl;
+            return false;
+        }
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        source = buffer.str();
+
+        while (error.empty()) {
+            skip_space();
+            if (pos >= source.size()) break;
+
+            size_t start = pos;
+            while (pos < source.size() && is_name_char(source[pos])) ++pos;
+            std::string name = source.substr(start, pos - start);
+            skip_space();
+            if (name.empty() || pos >= source.size() || source[pos] != '=') {
+                fail("expected rule definition");
+                break;
+            }
+            ++pos;
+
+            auto body = parse_choice();
+            skip_space();
+            if (!body || pos >= source.size() || source[pos] != ';') {
+                fail("expected ';' after rule " + name);
+                break;
+            }
+            ++pos;
+            rules[name] = std::move(body);
+        }
+
+        if (!error.empty()) {
+            std::cerr << "Cannot parse " << ebnf_file << ": " << error << std::endl;
+            return false;
+        }
+        return true;
+    }
+};
+
+// Keyword spellings: terminals of two or more upper-case letters and
+// underscores ("SELECT", "NOT_NULL"), as opposed to punctuation and
+// lower-case placeholders
+inline bool is_keyword_terminal(const std::string& text) {
+    if (text.size() < 2 || text == "UNKNOWN" || !std::isupper(static_cast<unsigned char>(text[0]))) {
+        return false;
+    }
+    return std::all_of(text.begin(), text.end(), [](char c) {
+        return std::isupper(static_cast<unsigned char>(c)) || c == '_';
+    });
+}
+
+inline void collect_keywords(const Node& node, std::set<std::string>& keywords) {
+    if (node.kind == Node::Kind::Terminal && is_keyword_terminal(node.text)) {
+        keywords.insert(node.text);
+    }
+    for (const auto& child : node.children) {
+        collect_keywords(*child, keywords);
+    }
+}
+
+// Every keyword terminal of every rule
+inline std::set<std::string> grammar_keywords(const EBNFGrammar& grammar) {
+    std::set<std::string> keywords;
+    for (const auto& [name, body] : grammar.rules) {
+        collect_keywords(*body, keywords);
+    }
+    return keywords;
+}
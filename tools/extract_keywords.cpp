@@ -14,7 +14,6 @@
 #include <iostream>
 #include <fstream>
 #include <sstream>
-#include <regex>
 #include <set>
 #include <vector>
 #include <algorithm>
@@ -22,6 +21,7 @@
 #include <string>
 #include <cctype>
 #include <map>
+#include "ebnf_grammar.hpp"
 
 struct KeywordInfo {
     std::string keyword;
@@ -55,14 +55,11 @@ private:
     
 public:
     bool extract_from_ebnf(const std::string& ebnf_file) {
-        std::ifstream file(ebnf_file);
-        if (!file) {
-            std::cerr << "Cannot open EBNF file: " << ebnf_file << std::endl;
+        EBNFGrammar grammar;
+        if (!grammar.load(ebnf_file)) {
             return false;
         }
-        
-        std::string line;
-        std::regex terminal_regex("\"([A-Z][A-Z_]*)\"");
+        all_keywords = grammar_keywords(grammar);
         
         // Reserved keywords that cannot be used as identifiers
         reserved_keywords = {
@@ -103,37 +100,6 @@ public:
             "ILIKE", "UNKNOWN", "PIVOT", "UNPIVOT", "LATERAL"
         };
         
-        while (std::getline(file, line)) {
-            // Skip comments
-            if (line.empty() || (line.size() > 1 && line[0] == '(' && line[1] == '*')) {
-                continue;
-            }
-            
-            // Extract terminals
-            auto words_begin = std::sregex_iterator(line.begin(), line.end(), terminal_regex);
-            auto words_end = std::sregex_iterator();
-            
-            for (auto it = words_begin; it != words_end; ++it) {
-                std::string terminal = (*it)[1];
-                
-                // Check if it's a keyword (all uppercase with optional underscore)
-                bool is_keyword = true;
-                for (char c : terminal) {
-                    if (!std::isupper(c) && c != '_') {
-                        is_keyword = false;
-                        break;
-                    }
-                }
-                
-                if (is_keyword && terminal.length() > 1 && terminal != "UNKNOWN") {
-                    all_keywords.insert(terminal);
-                }
-            }
-        }
-        
-        // Remove any duplicates (like UNKNOWN which might appear in EBNF)
-        all_keywords.erase("UNKNOWN");
-        
         // Merge all keyword sets
         all_keywords.insert(reserved_keywords.begin(), reserved_keywords.end());
         all_keywords.insert(contextual_keywords.begin(), contextual_keywords.end());
@@ -318,6 +284,20 @@ public:
         out << "    }\n";
         out << "    return \"INVALID\";\n";
         out << "}\n\n";
+
+        out << "// Fingerprint of the keyword table (spellings and IDs). Token files store\n";
+        out << "// keyword IDs and record this value, so a file written against a different\n";
+        out << "// table is rejected instead of decoding to the wrong keywords.\n";
+        out << "inline constexpr uint64_t kKeywordTableVersion = [] {\n";
+        out << "    uint64_t hash = 0xcbf29ce484222325ULL;  // FNV-1a\n";
+        out << "    for (const auto& entry : KEYWORDS) {\n";
+        out << "        for (char c : entry.text) {\n";
+        out << "            hash = (hash ^ static_cast<uint8_t>(c)) * 0x100000001b3ULL;\n";
+        out << "        }\n";
+        out << "        hash = (hash ^ static_cast<uint16_t>(entry.id)) * 0x100000001b3ULL;\n";
+        out << "    }\n";
+        out << "    return hash;\n";
+        out << "}();\n\n";
         
         out << "}  // namespace db25\n";
         
@@ -0,0 +1,697 @@
+/*
+ * Copyright (c) 2024 Chiradip Mandal
+ * Author: Chiradip Mandal
+ * Organization: Space-RF.org
+ *
+ * This file is part of DB25 SQL Tokenizer.
+ *
+ * Licensed under the MIT License. See LICENSE file for details.
+ */
+
+// Generate synthetic SQL corpora by walking the EBNF grammar
+// Output is reproducible for a given seed (own PRNG, no std distributions)
+// and can be written as plain SQL or in the sql_test.sqls format consumed by
+// bench_tokenizer --corpus
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <map>
+#include <set>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <algorithm>
+#include <limits>
+#include <cctype>
+#include <cstdint>
+#include "ebnf_grammar.hpp"
+
+// splitmix64: tiny, fast and identical on every platform
+class Random {
+private:
+    uint64_t state;
+
+public:
+    explicit Random(uint64_t seed) : state(seed) {}
+
+    uint64_t next() {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    // Uniform in [0, 1)
+    double uniform() {
+        return static_cast<double>(next() >> 11) * 0x1.0p-53;
+    }
+
+    // Uniform in [0, n)
+    size_t below(size_t n) {
+        return n == 0 ? 0 : static_cast<size_t>(next() % n);
+    }
+
+    // Uniform in [lo, hi]
+    size_t between(size_t lo, size_t hi) {
+        return lo + below(hi - lo + 1);
+    }
+
+    bool chance(double p) {
+        return uniform() < p;
+    }
+
+    template<typename T, size_t N>
+    const T& pick(const T (&items)[N]) {
+        return items[below(N)];
+    }
+
+    // Index drawn in proportion to `weights` (all zero: npos)
+    size_t weighted(const std::vector<double>& weights) {
+        double total = 0;
+        for (double w : weights) total += w;
+        double point = uniform() * total;
+        size_t last = std::string::npos;
+        for (size_t i = 0; i < weights.size(); ++i) {
+            if (weights[i] <= 0) continue;
+            last = i;
+            point -= weights[i];
+            if (point < 0) return i;
+        }
+        return last;
+    }
+};
+
+// ============================================================================
+// Workload mixes
+// ============================================================================
+
+struct Mix {
+    std::string name;
+    // Weight of alternatives mentioning a symbol; "rule:symbol" keys only
+    // apply to alternatives of that rule
+    std::map<std::string, double> boost;
+    size_t max_depth = 100;         // Rule nesting before closing out
+    size_t token_budget = 300;      // Tokens per statement before closing out
+    double repeat = 0.35;           // Probability of one more { } iteration
+    double optional = 0.4;          // Probability of taking a [ ] part
+    size_t in_list_min = 0;         // Forced IN list length (0 = use repeat)
+    size_t in_list_max = 0;
+    double comment = 0.0;           // Probability of a comment between tokens
+    double unicode = 0.0;           // Probability of a non-ASCII word
+    double quoted_identifier = 0.05;
+    size_t identifier_max = 10;
+    size_t string_max = 16;
+};
+
+static std::map<std::string, Mix> builtin_mixes() {
+    std::map<std::string, Mix> mixes;
+
+    // Statement shapes roughly follow OLTP/analytics traffic: mostly queries
+    // over columns and literals, few of the grammar's rarer clauses
+    Mix base;
+    base.boost = {
+        {"statement:select_statement", 12}, {"statement:insert_statement", 4},
+        {"statement:update_statement", 3}, {"statement:delete_statement", 2},
+        {"column_reference", 8}, {"literal", 5}, {"function_call", 1.5},
+        {"where_clause", 2}, {"with_clause", 0.3}, {"window_clause", 0.2},
+        {"SEARCH", 0.2}, {"CYCLE", 0.2}, {"EXISTS", 0.3}
+    };
+
+    Mix mix = base;
+    mix.name = "default";
+    mixes[mix.name] = mix;
+
+    mix = base;
+    mix.name = "literal";
+    mix.boost["literal"] = 16;
+    mix.boost["string_literal"] = 3;
+    mix.string_max = 120;
+    mixes[mix.name] = mix;
+
+    mix = base;
+    mix.name = "identifier";
+    mix.boost["column_reference"] = 16;
+    mix.boost["literal"] = 1;
+    mix.quoted_identifier = 0.25;
+    mix.identifier_max = 40;
+    mixes[mix.name] = mix;
+
+    mix = base;
+    mix.name = "comment";
+    mix.comment = 0.15;
+    mixes[mix.name] = mix;
+
+    mix = base;
+    mix.name = "nested";
+    mix.boost["primary_expression:select_statement"] = 6;
+    mix.boost["primary_expression:expression"] = 6;
+    mix.boost["case_expression"] = 4;
+    mix.boost["function_call"] = 3;
+    mix.max_depth = 800;
+    mix.token_budget = 3000;
+    mixes[mix.name] = mix;
+
+    mix = base;
+    mix.name = "in-list";
+    mix.boost["IN"] = 40;
+    mix.boost["in_predicate:expression"] = 20;
+    mix.in_list_min = 100;
+    mix.in_list_max = 2000;
+    mix.token_budget = 5000;
+    mixes[mix.name] = mix;
+
+    mix = base;
+    mix.name = "unicode";
+    mix.unicode = 0.6;
+    mix.string_max = 40;
+    mixes[mix.name] = mix;
+
+    return mixes;
+}
+
+// ============================================================================
+// Generator
+// ============================================================================
+
+class CorpusGenerator {
+private:
+    const EBNFGrammar& grammar;
+    Random rng;
+    std::map<std::string, size_t> min_depth;  // Shortest derivation per rule
+
+    // Per-statement state
+    const Mix* mix = nullptr;
+    std::string out;
+    std::vector<const std::string*> rule_stack;
+    size_t tokens = 0;
+    bool glue = true;  // Suppress the space before the next token
+
+    static constexpr size_t INF = std::numeric_limits<size_t>::max() / 4;
+
+    static constexpr const char* WORDS[] = {
+        "user", "order", "account", "item", "price", "total", "status", "region",
+        "event", "session", "amount", "created", "updated", "owner", "score", "tag"
+    };
+    static constexpr const char* UNICODE_WORDS[] = {
+        "gr\xC3\xB6\xC3\x9F" "e", "caf\xC3\xA9", "na\xC3\xAFve", "\xC3\xA5r",
+        "\xCE\xB4\xCE\xB5\xCE\xB4\xCE\xBF\xCE\xBC\xCE\xAD\xCE\xBD\xCE\xB1",
+        "\xD0\xB4\xD0\xB0\xD0\xBD\xD0\xBD\xD1\x8B\xD0\xB5",
+        "\xE6\x95\xB0\xE6\x8D\xAE", "\xE5\x90\x8D\xE5\x89\x8D",
+        "\xED\x85\x8C\xEC\x9D\xB4\xEB\xB8\x94", "\xF0\x9F\x9A\x80"
+    };
+
+    // Lexical rules and names the grammar leaves undefined
+    bool is_lexical(const std::string& name) const {
+        static const std::set<std::string> lexical = {
+            "identifier", "unquoted_identifier", "quoted_identifier", "integer", "decimal",
+            "float", "string_literal", "letter", "digit", "character"
+        };
+        return lexical.count(name) > 0 || grammar.rules.count(name) == 0;
+    }
+
+    size_t depth_of(const Node& node) const {
+        switch (node.kind) {
+            case Node::Kind::Terminal:
+            case Node::Kind::Special:
+            case Node::Kind::Optional:
+            case Node::Kind::Repeat:
+                return 0;
+            case Node::Kind::Rule: {
+                if (is_lexical(node.text)) return 1;
+                auto it = min_depth.find(node.text);
+                return it == min_depth.end() || it->second >= INF ? INF : it->second + 1;
+            }
+            case Node::Kind::Sequence: {
+                size_t depth = 0;
+                for (const auto& child : node.children) depth = std::max(depth, depth_of(*child));
+                return depth;
+            }
+            case Node::Kind::Choice: {
+                size_t depth = INF;
+                for (const auto& child : node.children) depth = std::min(depth, depth_of(*child));
+                return depth;
+            }
+        }
+        return INF;
+    }
+
+    // Fixed point over the (recursive) rules so closing out always terminates
+    void compute_min_depth() {
+        for (const auto& [name, body] : grammar.rules) min_depth[name] = INF;
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            for (const auto& [name, body] : grammar.rules) {
+                size_t depth = depth_of(*body);
+                if (depth < min_depth[name]) {
+                    min_depth[name] = depth;
+                    changed = true;
+                }
+            }
+        }
+    }
+
+    bool closing() const {
+        return rule_stack.size() >= mix->max_depth || tokens >= mix->token_budget;
+    }
+
+    // Optional parts and repetitions thin out as a statement grows so the
+    // budget goes to breadth near the top rather than one deep branch
+    double taper(double probability) const {
+        double used = std::max(static_cast<double>(rule_stack.size()) / static_cast<double>(mix->max_depth),
+                               static_cast<double>(tokens) / static_cast<double>(mix->token_budget));
+        return probability * std::max(0.0, 1.0 - used);
+    }
+
+    const std::string& current_rule() const {
+        static const std::string none;
+        return rule_stack.empty() ? none : *rule_stack.back();
+    }
+
+    // Symbols an alternative mentions at its top level (through [ ] and ( ))
+    void collect_symbols(const Node& node, std::vector<const std::string*>& symbols) const {
+        switch (node.kind) {
+            case Node::Kind::Terminal:
+            case Node::Kind::Rule:
+                symbols.push_back(&node.text);
+                break;
+            case Node::Kind::Sequence:
+            case Node::Kind::Optional:
+                for (const auto& child : node.children) collect_symbols(*child, symbols);
+                break;
+            default:
+                break;
+        }
+    }
+
+    double weight(const Node& alternative) const {
+        std::vector<const std::string*> symbols;
+        collect_symbols(alternative, symbols);
+        double result = 1.0;
+        bool boosted = false;
+        for (const std::string* symbol : symbols) {
+            for (const std::string& key : {*symbol, current_rule() + ":" + *symbol}) {
+                auto it = mix->boost.find(key);
+                if (it != mix->boost.end()) {
+                    result = boosted ? std::max(result, it->second) : it->second;
+                    boosted = true;
+                }
+            }
+        }
+        return result;
+    }
+
+    void emit(std::string_view token) {
+        static const std::set<std::string_view> no_space_before = {")", "]", ",", ".", ";"};
+        static const std::set<std::string_view> no_space_after = {"(", "[", ".", "$"};
+
+        if (!glue && no_space_before.count(token) == 0) {
+            if (mix->comment > 0 && rng.chance(mix->comment)) {
+                emit_comment();
+            }
+            out += rng.chance(0.03) ? '\n' : ' ';
+        }
+        out += token;
+        glue = no_space_after.count(token) > 0;
+        ++tokens;
+    }
+
+    void emit_comment() {
+        std::string text;
+        for (size_t i = 0, n = rng.between(1, 8); i < n; ++i) {
+            if (i > 0) text += ' ';
+            text += word();
+        }
+        // Line comments follow a token so no corpus line starts with "--"
+        if (rng.chance(0.5)) {
+            out += " /* " + text + " */";
+        } else {
+            out += " -- " + text + "\n";
+        }
+    }
+
+    std::string word() {
+        if (mix->unicode > 0 && rng.chance(mix->unicode)) {
+            return rng.pick(UNICODE_WORDS);
+        }
+        return rng.pick(WORDS);
+    }
+
+    std::string identifier() {
+        std::string name = word();
+        while (name.size() < mix->identifier_max && rng.chance(0.4)) {
+            name += '_';
+            name += word();
+        }
+        if (rng.chance(0.3)) {
+            name += '_';
+            name += std::to_string(rng.below(100));
+        }
+        if (rng.chance(mix->quoted_identifier)) {
+            if (rng.chance(0.3)) {
+                name += ' ';
+                name += word();
+            }
+            name.insert(name.begin(), '"');
+            name += '"';
+        }
+        return name;
+    }
+
+    std::string integer() {
+        static constexpr size_t magnitudes[] = {10, 100, 1000, 100000, 10000000000ULL};
+        return std::to_string(rng.below(rng.pick(magnitudes)));
+    }
+
+    std::string string_literal() {
+        std::string text = "'";
+        size_t length = rng.between(0, mix->string_max);
+        while (text.size() < length + 1) {
+            if (rng.chance(0.03)) {
+                text += "''";
+            } else {
+                if (text.size() > 1) text += ' ';
+                text += word();
+            }
+        }
+        return text + "'";
+    }
+
+    // Text for lexical rules and the grammar's undefined names
+    std::string synthesize(const std::string& name) {
+        static const char* interval_fields[] = {"YEAR", "MONTH", "DAY", "HOUR", "MINUTE", "SECOND"};
+        static const char* time_zones[] = {"WITH TIME ZONE", "WITHOUT TIME ZONE"};
+
+        if (name == "integer") return integer();
+        if (name == "precision" || name == "length" || name == "scale") {
+            return std::to_string(rng.between(1, 38));
+        }
+        if (name == "decimal") return integer() + "." + std::to_string(rng.below(10000));
+        if (name == "float") {
+            return integer() + "." + std::to_string(rng.below(100)) + "e" +
+                   (rng.chance(0.5) ? "-" : "") + std::to_string(rng.between(1, 30));
+        }
+        if (name == "letter") return std::string(1, static_cast<char>('a' + rng.below(26)));
+        if (name == "digit") return std::to_string(rng.below(10));
+        if (name == "escape_character") return "'!'";
+        if (name == "interval_fields") return rng.pick(interval_fields);
+        if (name == "time_zone") return rng.pick(time_zones);
+        if (name == "table_options") return "WITHOUT ROWID";
+        if (name == "string_literal" || name == "character" || name == "pattern" ||
+            name.ends_with("_value") || name == "module_argument") {
+            return string_literal();
+        }
+        if (name == "quoted_identifier") return "\"" + word() + "\"";
+        return identifier();
+    }
+
+    void expand(const Node& node) {
+        switch (node.kind) {
+            case Node::Kind::Terminal:
+                emit(node.text);
+                break;
+
+            case Node::Kind::Special:
+                emit(string_literal());
+                break;
+
+            case Node::Kind::Rule:
+                if (is_lexical(node.text)) {
+                    std::string token = synthesize(node.text);
+                    // Multi-word keywords (WITH TIME ZONE) are separate tokens
+                    size_t start = 0;
+                    if (token.front() != '\'' && token.front() != '"') {
+                        for (size_t space; (space = token.find(' ', start)) != std::string::npos;) {
+                            emit(std::string_view(token).substr(start, space - start));
+                            start = space + 1;
+                        }
+                    }
+                    emit(std::string_view(token).substr(start));
+                } else {
+                    rule_stack.push_back(&node.text);
+                    expand(*grammar.rules.at(node.text));
+                    rule_stack.pop_back();
+                }
+                break;
+
+            case Node::Kind::Sequence:
+                for (const auto& child : node.children) expand(*child);
+                break;
+
+            case Node::Kind::Choice: {
+                // When closing out only the shallowest alternatives compete.
+                // One level of slack keeps leaves varied until the depth
+                // limit forces a strictly decreasing, terminating choice.
+                size_t limit = INF;
+                if (closing()) {
+                    size_t slack = rule_stack.size() < mix->max_depth ? 1 : 0;
+                    for (const auto& child : node.children) {
+                        limit = std::min(limit, depth_of(*child) + slack);
+                    }
+                }
+                std::vector<double> weights;
+                for (const auto& child : node.children) {
+                    weights.push_back(depth_of(*child) <= limit ? weight(*child) : 0.0);
+                }
+                expand(*node.children[rng.weighted(weights)]);
+                break;
+            }
+
+            case Node::Kind::Optional:
+                if (!closing() && rng.chance(weight(*node.children[0]) * taper(mix->optional))) {
+                    expand(*node.children[0]);
+                }
+                break;
+
+            case Node::Kind::Repeat:
+                // Long lists only at the outermost IN; nested ones stay short
+                if (current_rule() == "in_predicate" && mix->in_list_max > 0 &&
+                    std::count_if(rule_stack.begin(), rule_stack.end(),
+                                  [](const std::string* rule) { return *rule == "in_predicate"; }) == 1) {
+                    size_t count = rng.between(mix->in_list_min, mix->in_list_max);
+                    for (size_t i = 0; i < count && tokens < mix->token_budget * 2; ++i) {
+                        expand(*node.children[0]);
+                    }
+                    break;
+                }
+                while (!closing() && rng.chance(taper(mix->repeat))) {
+                    expand(*node.children[0]);
+                }
+                break;
+        }
+    }
+
+public:
+    CorpusGenerator(const EBNFGrammar& g, uint64_t seed) : grammar(g), rng(seed) {
+        compute_min_depth();
+    }
+
+    bool has_rule(const std::string& name) const {
+        auto it = min_depth.find(name);
+        return it != min_depth.end() && it->second < INF;
+    }
+
+    std::string statement(const std::string& start_rule, const Mix& m) {
+        mix = &m;
+        out.clear();
+        rule_stack.clear();
+        tokens = 0;
+        glue = true;
+
+        Node start(Node::Kind::Rule, start_rule);
+        expand(start);
+        return out + ";";
+    }
+
+    const Mix& choose(const std::vector<std::pair<const Mix*, double>>& mixes) {
+        std::vector<double> weights;
+        for (const auto& entry : mixes) weights.push_back(entry.second);
+        return *mixes[rng.weighted(weights)].first;
+    }
+};
+
+// ============================================================================
+// Command line
+// ============================================================================
+
+static bool parse_size(std::string text, uint64_t& size) {
+    uint64_t multiplier = 1;
+    if (!text.empty()) {
+        switch (text.back()) {
+            case 'K': case 'k': multiplier = 1ULL << 10; break;
+            case 'M': case 'm': multiplier = 1ULL << 20; break;
+            case 'G': case 'g': multiplier = 1ULL << 30; break;
+            default: break;
+        }
+    }
+    if (multiplier != 1) text.pop_back();
+    if (text.empty() || text.find_first_not_of("0123456789") != std::string::npos) return false;
+    size = std::stoull(text) * multiplier;
+    return true;
+}
+
+static void print_usage(const char* program, const std::map<std::string, Mix>& mixes) {
+    std::cerr << "Usage: " << program << " [options]\n"
+              << "  --grammar PATH    EBNF grammar (default: grammar/DB25_SQL_GRAMMAR.ebnf)\n"
+              << "  --output PATH     Output file (default: stdout)\n"
+              << "  --size N          Approximate output size, e.g. 64K, 16M, 2G (default: 1M)\n"
+              << "  --seed N          PRNG seed (default: 25)\n"
+              << "  --mix SPEC        Comma-separated mixes with optional weights,\n"
+              << "                    e.g. literal=3,unicode (default: default)\n"
+              << "  --start RULE      Grammar rule to generate (default: statement)\n"
+              << "  --format FORMAT   sql, or sqls for the sql_test.sqls format (default: sql)\n"
+              << "Mixes:";
+    for (const auto& [name, mix] : mixes) std::cerr << " " << name;
+    std::cerr << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    std::string grammar_file = "grammar/DB25_SQL_GRAMMAR.ebnf";
+    std::string output_file;
+    std::string mix_spec = "default";
+    std::string start_rule = "statement";
+    std::string format = "sql";
+    uint64_t size = 1ULL << 20;
+    uint64_t seed = 25;
+
+    auto mixes = builtin_mixes();
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-h" || arg == "--help") {
+            print_usage(argv[0], mixes);
+            return 0;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << std::endl;
+            return 1;
+        }
+        std::string value = argv[++i];
+        if (arg == "--grammar") {
+            grammar_file = value;
+        } else if (arg == "--output") {
+            output_file = value;
+        } else if (arg == "--size") {
+            if (!parse_size(value, size)) {
+                std::cerr << "Invalid size: " << value << std::endl;
+                return 1;
+            }
+        } else if (arg == "--seed") {
+            if (value.empty() || value.find_first_not_of("0123456789") != std::string::npos) {
+                std::cerr << "Invalid seed: " << value << std::endl;
+                return 1;
+            }
+            seed = std::stoull(value);
+        } else if (arg == "--mix") {
+            mix_spec = value;
+        } else if (arg == "--start") {
+            start_rule = value;
+        } else if (arg == "--format") {
+            format = value;
+        } else {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            print_usage(argv[0], mixes);
+            return 1;
+        }
+    }
+
+    if (format != "sql" && format != "sqls") {
+        std::cerr << "Unknown format: " << format << std::endl;
+        return 1;
+    }
+
+    std::vector<std::pair<const Mix*, double>> selected;
+    std::stringstream spec(mix_spec);
+    std::string item;
+    while (std::getline(spec, item, ',')) {
+        std::string name = item.substr(0, item.find('='));
+        double weight = 1.0;
+        if (name.size() < item.size()) {
+            try {
+                weight = std::stod(item.substr(name.size() + 1));
+            } catch (...) {
+                weight = -1;
+            }
+        }
+        auto it = mixes.find(name);
+        if (it == mixes.end() || weight <= 0) {
+            std::cerr << "Invalid mix: " << item << std::endl;
+            print_usage(argv[0], mixes);
+            return 1;
+        }
+        selected.emplace_back(&it->second, weight);
+    }
+    if (selected.empty()) {
+        std::cerr << "No mix selected" << std::endl;
+        return 1;
+    }
+
+    EBNFGrammar grammar;
+    if (!grammar.load(grammar_file)) {
+        return 1;
+    }
+
+    CorpusGenerator generator(grammar, seed);
+    if (!generator.has_rule(start_rule)) {
+        std::cerr << "Unknown or non-terminating start rule: " << start_rule << std::endl;
+        return 1;
+    }
+
+    std::ofstream file;
+    if (!output_file.empty()) {
+        file.open(output_file, std::ios::binary);
+        if (!file) {
+            std::cerr << "Cannot create output file: " << output_file << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& out = output_file.empty() ? std::cout : file;
+
+    if (format == "sqls") {
+        out << "-- Generated by generate_corpus --seed " << seed << " --mix " << mix_spec << "\n"
+            << "-- Format: Each query starts with --ID: identifier\n"
+            << "-- Queries are separated by --END\n\n";
+    }
+
+    // Statements are buffered and written in large chunks for GB-scale output
+    std::string buffer;
+    uint64_t written = 0;
+    uint64_t count = 0;
+    while (written + buffer.size() < size) {
+        const Mix& mix = generator.choose(selected);
+        std::string sql = generator.statement(start_rule, mix);
+        ++count;
+
+        if (format == "sqls") {
+            std::string level = mix.name;
+            std::transform(level.begin(), level.end(), level.begin(),
+                           [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+            buffer += "--ID: gen_" + std::to_string(count) + "\n--DESC: Generated " + mix.name +
+                      " statement\n--LEVEL: " + level + "\n" + sql + "\n--END\n\n";
+        } else {
+            buffer += sql + "\n";
+        }
+
+        if (buffer.size() >= (1u << 20)) {
+            out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            written += buffer.size();
+            buffer.clear();
+        }
+    }
+    out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    written += buffer.size();
+    out.flush();
+
+    if (!out) {
+        std::cerr << "Write failed" << std::endl;
+        return 1;
+    }
+    if (!output_file.empty()) {
+        std::cout << "Generated " << count << " statements (" << written << " bytes) in "
+                  << output_file << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2024 Chiradip Mandal
+ * Author: Chiradip Mandal
+ * Organization: Space-RF.org
+ *
+ * This file is part of DB25 SQL Tokenizer.
+ *
+ * Licensed under the MIT License. See LICENSE file for details.
+ */
+
+// Shared-memory tokenizer daemon: one per host, serving every process that
+// connects with TokenizerClient (include/tokenizer_service.hpp). Runs in the
+// foreground until SIGINT or SIGTERM, then prints its counters.
+//
+// --self-test starts the daemon on a thread, sends it a few statements from
+// this process and compares the answers with local tokenization.
+
+#include <csignal>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "tokenizer_service.hpp"
+
+using namespace db25;
+
+namespace {
+
+TokenizerDaemon* running_daemon = nullptr;
+
+extern "C" void handle_signal(int) {
+    if (running_daemon != nullptr) {
+        running_daemon->stop();
+    }
+}
+
+bool parse_size(std::string text, uint64_t& size) {
+    uint64_t multiplier = 1;
+    if (!text.empty()) {
+        switch (text.back()) {
+            case 'K': case 'k': multiplier = 1ULL << 10; break;
+            case 'M': case 'm': multiplier = 1ULL << 20; break;
+            case 'G': case 'g': multiplier = 1ULL << 30; break;
+            default: break;
+        }
+    }
+    if (multiplier != 1) text.pop_back();
+    if (text.empty() || text.find_first_not_of("0123456789") != std::string::npos) return false;
+    size = std::stoull(text) * multiplier;
+    return true;
+}
+
+void print_usage(const char* program) {
+    std::cerr << "Usage: " << program << " [options]\n"
+              << "  --name NAME            Shared memory object (default: /db25-tokenizer)\n"
+              << "  --dialect NAME         generic, postgres, mysql or sqlserver (default: generic)\n"
+              << "  --slots N              Requests in flight across all clients (default: 64)\n"
+              << "  --request-bytes SIZE   Longest SQL text per request (default: 1M)\n"
+              << "  --response-bytes SIZE  Compressed tokens per request (default: 1M)\n"
+              << "  --cache-bytes SIZE     Cache for repeated texts, 0 disables (default: 64M)\n"
+              << "  --self-test            Serve this process only, check the answers and exit\n";
+}
+
+void print_stats(const TokenizerServiceStats& stats) {
+    std::cout << "Requests:  " << stats.requests << "\n"
+              << "Cache hits: " << stats.cache_hits << "\n"
+              << "Errors:    " << stats.errors << "\n"
+              << "Reclaimed: " << stats.reclaimed << " slots\n";
+}
+
+bool same_tokens(const std::vector<Token>& a, const std::vector<Token>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i].type != b[i].type || a[i].value != b[i].value || a[i].keyword_id != b[i].keyword_id ||
+            a[i].line != b[i].line || a[i].column != b[i].column) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Statements round-tripped through the daemon, each twice so the second
+// answer comes from the cache
+int self_test(TokenizerDaemon& daemon, const TokenizerDaemonOptions& options) {
+    std::thread server([&] { daemon.run(); });
+    const char* statements[] = {
+        "SELECT id, name FROM users WHERE age >= 21 ORDER BY name;",
+        "INSERT INTO t (a, b) VALUES (1, 'it''s'), (2, NULL) -- trailing comment",
+        "/* block */ UPDATE accounts SET balance = balance * 1.05 WHERE id IN (1, 2, 3)",
+        "",
+    };
+
+    bool ok = false;
+    if (auto client = TokenizerClient::connect(daemon.name())) {
+        ok = true;
+        for (int round = 0; round < 2; ++round) {
+            for (const char* sql : statements) {
+                auto query = client->tokenize(sql);
+                if (!query) {
+                    std::cerr << "Error: " << tokenizer_service_error_name(query.error()) << "\n";
+                    ok = false;
+                    continue;
+                }
+                TokenBuffer expected = options.tokenize(sql);
+                std::vector<Token> local(expected.tokens().begin(), expected.tokens().end());
+                ok = ok && query->sql() == sql && same_tokens(query->tokens(), local) &&
+                     query->cached() == (round == 1 && options.cache_bytes > 0);
+            }
+        }
+    } else {
+        std::cerr << "Error: Cannot connect: " << tokenizer_service_error_name(client.error()) << "\n";
+    }
+
+    daemon.stop();
+    server.join();
+    print_stats(daemon.stats());
+    std::cout << (ok ? "Self-test passed" : "Self-test FAILED") << "\n";
+    return ok ? 0 : 1;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    std::string name(kDefaultTokenizerService);
+    std::string dialect = "generic";
+    TokenizerDaemonOptions options;
+    bool check = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-h" || arg == "--help") {
+            print_usage(argv[0]);
+            return 0;
+        }
+        if (arg == "--self-test") {
+            check = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Error: Missing value for " << arg << "\n";
+            return 1;
+        }
+        std::string value = argv[++i];
+        uint64_t size = 0;
+        if (arg == "--name") {
+            name = value;
+        } else if (arg == "--dialect") {
+            dialect = value;
+        } else if (arg == "--slots" || arg == "--request-bytes" || arg == "--response-bytes" ||
+                   arg == "--cache-bytes") {
+            if (!parse_size(value, size) || (size == 0 && arg != "--cache-bytes")) {
+                std::cerr << "Error: Invalid value for " << arg << ": " << value << "\n";
+                return 1;
+            }
+            if (arg == "--slots") options.slots = size;
+            if (arg == "--request-bytes") options.request_bytes = size;
+            if (arg == "--response-bytes") options.response_bytes = size;
+            if (arg == "--cache-bytes") options.cache_bytes = size;
+        } else {
+            std::cerr << "Error: Unknown option " << arg << "\n";
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (dialect == "generic") {
+        options.tokenize = &TokenBuffer::tokenize<SimdTokenizer>;
+    } else if (dialect == "postgres") {
+        options.tokenize = &TokenBuffer::tokenize<PostgresTokenizer>;
+    } else if (dialect == "mysql") {
+        options.tokenize = &TokenBuffer::tokenize<MySqlTokenizer>;
+    } else if (dialect == "sqlserver") {
+        options.tokenize = &TokenBuffer::tokenize<SqlServerTokenizer>;
+    } else {
+        std::cerr << "Error: Unknown dialect " << dialect << "\n";
+        return 1;
+    }
+
+    auto daemon = TokenizerDaemon::create(name, options);
+    if (!daemon) {
+        std::cerr << "Error: Cannot start daemon " << name << ": "
+                  << tokenizer_service_error_name(daemon.error()) << "\n";
+        return 1;
+    }
+    if (check) {
+        return self_test(*daemon, options);
+    }
+
+    running_daemon = &*daemon;
+    std::signal(SIGINT, handle_signal);
+    std::signal(SIGTERM, handle_signal);
+    std::cout << "Serving " << daemon->name() << " (" << dialect << ", " << options.slots << " slots)\n"
+              << std::flush;
+    daemon->run();
+    running_daemon = nullptr;
+    print_stats(daemon->stats());
+    return 0;
+}